@@ -21,6 +21,7 @@
 #define BEST_BASE_NICHE_H_
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "best/base/ord.h"
 #include "best/meta/init.h"
@@ -36,14 +37,28 @@
 //! (obtained only by constructing from a `best::niche`) must compare as equal
 //! to `best::niche`.
 //!
+//! A type may have more than one niche representation. Such a type declares
+//! how many with a `static constexpr size_t BestNiches` member. The `i`th
+//! niche is constructed from `best::niche{i}`, and only compares equal to
+//! `best::niche{i}`. Types without this member have exactly one niche, and
+//! may ignore `niche::index` entirely.
+//!
 //! Niche representations are used for compressing the layout of some types,
 //! such as `best::choice`.
+//!
+//! Pointer-like types, such as references, `best::ptr`, and `best::box`, have
+//! many niches: beyond null, no valid pointer points into the first page of
+//! memory, and odd addresses are misaligned for any type with alignment
+//! greater than one. `best::niche_addr()` maps niches onto such addresses.
 
 namespace best {
 /// # `best::niche`
 ///
-/// A tag for constructing niche representations.
-struct niche final {};
+/// A tag for constructing niche representations. `index` selects among the
+/// niches of a type with more than one; see `best::niche_count`.
+struct niche final {
+  size_t index = 0;
+};
 
 /// # `best::has_niche`
 ///
@@ -52,6 +67,39 @@ template <typename T>
 concept has_niche =
   best::is_ref<T> || (best::is_object<T> && best::constructible<T, niche> &&
                       best::equatable<T, best::niche>);
+
+/// # `best::AddrNiches`, `best::niche_addr()`
+///
+/// The number of niches available to a non-nullable pointer, and the address
+/// that encodes a particular one.
+///
+/// Niche zero is null. Every other niche is an odd address in the first page,
+/// which no valid pointer can hold. Odd addresses are used so that these never
+/// collide with `best::ptr::dangling()`, which is always a power of two.
+///
+/// These do not depend on the pointee's alignment, so they are available even
+/// when the pointee is incomplete, as is common with `best::box`.
+inline constexpr size_t AddrNiches = 2048;
+constexpr uintptr_t niche_addr(best::niche nh) {
+  return nh.index == 0 ? 0 : 2 * nh.index + 1;
+}
+
+/// # `best::niche_count<T>`
+///
+/// The number of distinct niche representations of `T`. This is zero if `T`
+/// has no niche, and `T::BestNiches` if `T` declares it.
+template <typename T>
+inline constexpr size_t niche_count = [] {
+  if constexpr (!best::has_niche<T>) {
+    return size_t{0};
+  } else if constexpr (best::is_ref<T>) {
+    return best::AddrNiches;
+  } else if constexpr (requires { size_t{T::BestNiches}; }) {
+    return size_t{T::BestNiches};
+  } else {
+    return size_t{1};
+  }
+}();
 }  // namespace best
 
 #endif  // BEST_BASE_NICHE_H_
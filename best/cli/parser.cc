@@ -22,6 +22,8 @@
 #include <unordered_set>
 
 #include "best/cli/cli.h"
+#include "best/container/flat_map.h"
+#include "best/container/row.h"
 #include "best/log/wtf.h"
 #include "best/text/str.h"
 #include "best/text/strbuf.h"
@@ -70,9 +72,9 @@ struct cli::impl {
   best::vec<g> groups;
   best::vec<p> args;
 
-  /// An element of sorted. Used to look up flags during parsing.
+  /// A value in one of the sorted name tables. Used to look up flags during
+  /// parsing.
   struct entry final {
-    best::strbuf key;  // This does not include leading --.
     size_t idx;
     bool is_group = false, is_letter = false, is_alias = false, is_copy = false;
     visibility vis;
@@ -83,7 +85,8 @@ struct cli::impl {
     } magic = Ordinary;
   };
 
-  best::vec<entry> sorted_flags, sorted_subs;
+  /// Lookup tables by name. Flag names do not include the leading --.
+  best::flat_map<best::strbuf, entry> sorted_flags, sorted_subs;
 
   impl* parent = nullptr;
   const subcommand* parent_sub;
@@ -94,17 +97,11 @@ struct cli::impl {
   std::unordered_map<const flag*, best::strbuf> required;
 
   best::option<const entry&> find_flag(best::pretext<wtf8> tok) const {
-    return sorted_flags.as_span()
-      .bisect(tok, &entry::key)
-      .ok()
-      .map([&](size_t idx) -> auto&& { return sorted_flags[idx]; });
+    return sorted_flags.get(tok);
   }
 
   best::option<const entry&> find_sub(best::pretext<wtf8> tok) const {
-    return sorted_subs.as_span()
-      .bisect(tok, &entry::key)
-      .ok()
-      .map([&](size_t idx) -> auto&& { return sorted_subs[idx]; });
+    return sorted_subs.get(tok);
   }
 };
 
@@ -179,6 +176,7 @@ void cli::add(about about, const positional& tag, const argv_query& query,
 void cli::init() {
   // First, compute the actual names of all the entries. Stick flags and groups
   // into the lookup tables.
+  best::vec<best::row<best::strbuf, impl::entry>> flag_names, sub_names;
 
   for (auto [idx, f] : impl_->flags.iter().enumerate()) {
     auto has_letter = f.tag->letter != '\0';
@@ -192,8 +190,7 @@ void cli::init() {
                   f.about.strukt->path(), f.about.field, name);
       }
 
-      impl_->sorted_flags.push(impl::entry{
-        .key = name,
+      flag_names.push(name, impl::entry{
         .idx = idx,
         .is_letter = name_idx == 0 && has_letter,
         .is_alias = name_idx > size_t(has_letter),
@@ -207,7 +204,7 @@ void cli::init() {
       if (vis == Delete) { continue; }
       normalize(name, s.about);
 
-      impl_->sorted_subs.push(impl::entry{.key = name, .idx = idx, .vis = vis});
+      sub_names.push(name, impl::entry{.idx = idx, .vis = vis});
     }
   }
 
@@ -252,8 +249,7 @@ void cli::init() {
             g->about.strukt->path(), g->about.field, name);
         }
 
-        impl_->sorted_flags.push(impl::entry{
-          .key = name,
+        flag_names.push(name, impl::entry{
           .idx = idx,
           .is_group = true,
           .is_letter = is_letter,
@@ -266,7 +262,8 @@ void cli::init() {
       }
 
       auto copy_vis = merge(vis, is_flatten ? Public : Hidden);
-      for (auto entry : g->child->impl_->sorted_flags) {
+      for (auto [child_key, child_entry] : g->child->impl_->sorted_flags) {
+        auto entry = child_entry;
         if (is_flatten && entry.magic != entry.Ordinary) { continue; }
 
         if (entry.magic == entry.Ordinary) {
@@ -279,26 +276,25 @@ void cli::init() {
         entry.vis = merge(entry.vis, copy_vis);
         entry.is_copy = !is_flatten;
 
+        best::strbuf key = child_key;
         if (!name.is_empty()) {
-          auto key = std::move(entry.key);
           if (is_letter) {
-            entry.key = best::format("{}{}", name, key);
-            impl_->sorted_flags.push(entry);
+            flag_names.push(best::format("{}{}", name, child_key), entry);
           }
-          entry.key = best::format("{}.{}", name, key);
+          key = best::format("{}.{}", name, child_key);
         }
 
-        impl_->sorted_flags.push(std::move(entry));
+        flag_names.push(std::move(key), std::move(entry));
       }
 
-      for (auto entry : g->child->impl_->sorted_subs) {
-        if (!name.is_empty()) {
-          entry.key = best::format("{}.{}", name, entry.key);
-        }
+      for (auto [child_key, child_entry] : g->child->impl_->sorted_subs) {
+        auto entry = child_entry;
+        best::strbuf key = child_key;
+        if (!name.is_empty()) { key = best::format("{}.{}", name, child_key); }
         entry.idx += sub_offset;
         entry.vis = merge(entry.vis, copy_vis);
         entry.is_copy = !is_flatten;
-        impl_->sorted_subs.push(std::move(entry));
+        sub_names.push(std::move(key), std::move(entry));
       }
     }
   }
@@ -313,51 +309,53 @@ void cli::init() {
   }
 
   // Add magic flags.
-  impl_->sorted_flags.push(impl::entry{
-    .key = {"help"},
+  flag_names.push(best::strbuf("help"), impl::entry{
     .idx = -1,
     .vis = Public,
     .magic = impl::entry::Help,
   });
-  impl_->sorted_flags.push(impl::entry{
-    .key = {"h"},
+  flag_names.push(best::strbuf("h"), impl::entry{
     .idx = -1,
     .is_letter = true,
     .vis = Public,
     .magic = impl::entry::Help,
   });
-  impl_->sorted_flags.push(impl::entry{
-    .key = {"help-hidden"},
+  flag_names.push(best::strbuf("help-hidden"), impl::entry{
     .idx = -1,
     .vis = Hidden,
     .magic = impl::entry::HelpHidden,
   });
 
-  // Now, sort the flags so we can bisect through them later.
-  impl_->sorted_flags->sort(&impl::entry::key);
-  impl_->sorted_subs->sort(&impl::entry::key);
+  // Now, sort the names so we can check for duplicates. The flat maps below
+  // notice that their input is already sorted and skip sorting it again.
+  auto by_key = [](const auto& r) -> const best::strbuf& { return r.first(); };
+  flag_names->sort(by_key);
+  sub_names->sort(by_key);
 
   // Check for duplicates.
   best::option<best::str> prev;
-  for (auto& e : impl_->sorted_flags) {
-    if (e.key == prev) {
+  for (const auto& [key, e] : flag_names) {
+    if (key == prev) {
       if (e.is_letter) {
-        best::wtf("detected duplicate flag: -{}", e.key);
+        best::wtf("detected duplicate flag: -{}", key);
       } else {
-        best::wtf("detected duplicate flag: --{}", e.key);
+        best::wtf("detected duplicate flag: --{}", key);
       }
     }
-    prev = e.key.as_text();
+    prev = key.as_text();
   }
 
   prev.reset();
-  for (auto& e : impl_->sorted_subs) {
-    if (e.key == prev) {
-      best::wtf("detected duplicate subcommand: {}", e.key);
-    }
-    prev = e.key.as_text();
+  for (const auto& [key, e] : sub_names) {
+    if (key == prev) { best::wtf("detected duplicate subcommand: {}", key); }
+    prev = key.as_text();
   }
 
+  impl_->sorted_flags =
+    best::flat_map<best::strbuf, impl::entry>(std::move(flag_names));
+  impl_->sorted_subs =
+    best::flat_map<best::strbuf, impl::entry>(std::move(sub_names));
+
   // All done!
 }
 
@@ -649,24 +647,24 @@ best::strbuf cli::usage(best::pretext<wtf8> exe, bool hidden) const {
   if (impl_->parent_group != nullptr) { out.push(" [SUBOPTION]"); }
 
   bool needs_dash = true;
-  for (const auto& e : cmd->sorted_flags) {
+  for (auto [key, e] : cmd->sorted_flags) {
     if (!e.is_letter || e.is_copy || !visible(e.vis, hidden)) { continue; }
     if (std::exchange(needs_dash, false)) { out.push(" -"); }
-    out.push(e.key);
+    out.push(key);
   }
 
   if (!cmd->sorted_flags.is_empty()) { out.push(" [OPTIONS]"); }
 
   // Append all of the subcommands.
   bool first = true;
-  for (const auto& s : cmd->sorted_subs) {
+  for (auto [key, s] : cmd->sorted_subs) {
     if (s.is_alias) { continue; }
     if (std::exchange(first, false)) {
       out.push(" [");
     } else {
       out.push("|");
     }
-    out.push(s.key);
+    out.push(key);
   }
   if (!first) { out.push("]"); }
 
@@ -710,14 +708,14 @@ best::strbuf cli::usage(best::pretext<wtf8> exe, bool hidden) const {
 
   // Next, print all of the subcommands.
   first = true;
-  for (const auto& e : impl_->sorted_subs) {
+  for (auto [key, e] : impl_->sorted_subs) {
     if (!visible(e.vis, hidden) || e.is_alias) { continue; }
 
     if (std::exchange(first, false)) { out.push("# Subcommands\n"); }
 
     indent(6);
-    out.push(e.key);
-    size_t extra = Width - width_of(e.key) - 6;
+    out.push(key);
+    size_t extra = Width - width_of(key) - 6;
     if (extra <= Width) {
       indent_dots(extra + 2);
     } else {
@@ -736,7 +734,7 @@ best::strbuf cli::usage(best::pretext<wtf8> exe, bool hidden) const {
 
   out.push("# Flags\n");
 
-  auto print_flag = [&](const cli::impl::entry& e) {
+  auto print_flag = [&](const best::strbuf& key, const cli::impl::entry& e) {
     const cli::about* about;
     best::str help, arg;
     bool has_letter;
@@ -771,8 +769,8 @@ best::strbuf cli::usage(best::pretext<wtf8> exe, bool hidden) const {
       indent(4);
     }
 
-    best::str prefix = e.key[{
-      .end = e.key.size() - e.key->split('.').last()->size(),
+    best::str prefix = key[{
+      .end = key.size() - key->split('.').last()->size(),
     }];
     // Chop off everything past the last `.` to make the prefix.
 
@@ -833,7 +831,7 @@ best::strbuf cli::usage(best::pretext<wtf8> exe, bool hidden) const {
 
   // First, add the ordinary flags.
   first = true;
-  for (const auto& e : impl_->sorted_flags) {
+  for (auto [key, e] : impl_->sorted_flags) {
     if (e.is_alias || e.magic != e.Ordinary || e.is_group || e.is_copy) {
       continue;
     }
@@ -846,13 +844,13 @@ best::strbuf cli::usage(best::pretext<wtf8> exe, bool hidden) const {
 
     // This makes us prefer to alphabetize by letter when possible.
     if (has_letter && !e.is_letter) { continue; }
-    print_flag(e);
+    print_flag(key, e);
   }
 
   // Now add the groups and their children, which we sort by name rather than by
   // letter.
   first = true;
-  for (const auto& e : impl_->sorted_flags) {
+  for (auto [key, e] : impl_->sorted_flags) {
     if (e.is_alias || e.magic != e.Ordinary || !(e.is_group || e.is_copy)) {
       continue;
     }
@@ -867,7 +865,7 @@ best::strbuf cli::usage(best::pretext<wtf8> exe, bool hidden) const {
     if ((has_letter || !e.is_group) && e.is_letter) { continue; }
 
     if (std::exchange(first, false)) { out.push("\n"); }
-    print_flag(e);
+    print_flag(key, e);
   }
 
   out.push("\n");
@@ -278,13 +278,13 @@ constexpr auto BestFromArgvQuery(auto& query, best::option<T>*) {
   query.wants_arg = best::argv_query::of<T>.wants_arg;
 }
 
-template <best::is_from_argv T, size_t n, best::allocator A>
-auto BestFromArgv(auto raw, best::vec<T, n, A>& arg)
+template <best::is_from_argv T, size_t n, best::allocator A, typename G>
+auto BestFromArgv(auto raw, best::vec<T, n, A, G>& arg)
   -> decltype(BestFromArgv(raw, arg.push())) {
   return BestFromArgv(raw, arg.push());
 }
-template <best::is_from_argv T, size_t n, best::allocator A>
-constexpr auto BestFromArgvQuery(auto& query, best::vec<T, n, A>*) {
+template <best::is_from_argv T, size_t n, best::allocator A, typename G>
+constexpr auto BestFromArgvQuery(auto& query, best::vec<T, n, A, G>*) {
   query.wants_arg = best::argv_query::of<T>.wants_arg;
   query.default_count = cli::Repeated;
 }
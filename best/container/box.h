@@ -283,8 +283,19 @@ class BEST_RELOCATABLE box final {
     return **this <=> u;
   }
 
-  constexpr explicit box(niche) : ptr_(nullptr) {}
-  constexpr bool operator==(niche) const { return ptr_ == nullptr; }
+  // A box is never null, so null is its first niche; the rest are the
+  // niches of `best::ptr`.
+  static constexpr size_t BestNiches = ptr::BestNiches + 1;
+  constexpr explicit box(niche nh) : ptr_(nullptr) {
+    if constexpr (BestNiches > 1) {
+      if (nh.index != 0) { ptr_ = ptr(niche{nh.index - 1}); }
+    }
+  }
+  constexpr bool operator==(niche nh) const {
+    if (nh.index == 0) { return ptr_ == nullptr; }
+    if constexpr (BestNiches > 1) { return ptr_ == niche{nh.index - 1}; }
+    return false;
+  }
 
  private:
   best::ptr<T> ptr_;
@@ -19,6 +19,8 @@
 
 #include "best/container/box.h"
 
+#include "best/container/choice.h"
+#include "best/container/option.h"
 #include "best/test/fodder.h"
 #include "best/test/test.h"
 
@@ -36,6 +38,39 @@ best::test Thin = [](auto& t) {
   t.expect_eq(**x1, *x0);
 };
 
+static_assert(sizeof(best::option<best::option<best::box<int>>>) ==
+              sizeof(void*));
+static_assert(sizeof(best::choice<best::box<int>, void, void, void>) ==
+              sizeof(void*));
+static_assert(sizeof(best::option<best::box<int[]>>) == 2 * sizeof(void*));
+
+best::test Niches = [](auto& t) {
+  using C = best::choice<void, best::box<int>, void, void>;
+  C x0(best::index<0>);
+  C x1(best::index<1>, 42);
+  C x2(best::index<2>);
+  C x3(best::index<3>);
+  t.expect_eq(x0.which(), 0);
+  t.expect_eq(x1.which(), 1);
+  t.expect_eq(x2.which(), 2);
+  t.expect_eq(x3.which(), 3);
+  t.expect_eq(**x1.at(best::index<1>), 42);
+
+  x3 = x1;
+  t.expect_eq(x3.which(), 1);
+  t.expect_eq(**x3.at(best::index<1>), 42);
+  x1 = x2;
+  t.expect_eq(x1.which(), 2);
+
+  best::option<best::option<best::box<int>>> x4;
+  t.expect_eq(x4, best::none);
+  x4 = best::option(best::box(5));
+  t.expect_eq(***x4, 5);
+  x4 = best::option<best::box<int>>();
+  t.expect_ne(x4, best::none);
+  t.expect_eq(*x4, best::none);
+};
+
 best::test Span = [](auto& t) {
   best::box x0({1, 2, 3, 4, 5});
   t.expect_eq(*x0, best::span{1, 2, 3, 4, 5});
@@ -0,0 +1,1096 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_BTREE_MAP_H_
+#define BEST_CONTAINER_BTREE_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <new>
+
+#include "best/base/ord.h"
+#include "best/container/object.h"
+#include "best/container/option.h"
+#include "best/container/row.h"
+#include "best/iter/iter.h"
+#include "best/log/internal/crash.h"
+#include "best/math/int.h"
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+#include "best/memory/ptr.h"
+#include "best/memory/span.h"
+#include "best/meta/init.h"
+
+//! Ordered maps.
+//!
+//! `best::btree_map<K, V>` is an ordered associative container, implemented as
+//! a B-tree whose nodes are sized to span a few cache lines. It supports
+//! in-order iteration and range queries, which the hash tables do not.
+
+namespace best {
+/// # `best::key_range<Q>`
+///
+/// A range of keys to query a `best::btree_map` with. This is the analogue of
+/// `best::bounds` for ordered maps:
+///
+/// ```
+/// map.range({.start = 2, .end = 4})            // Keys in [2, 4).
+/// map.range({.start = 2, .including_end = 4})  // Keys in [2, 4].
+/// map.range({.end = 4})                        // Keys less than 4.
+/// ```
+///
+/// If both `end` and `including_end` are specified, `end` wins.
+template <typename Q>
+struct key_range final {
+  best::option<Q> start;
+  best::option<Q> end, including_end;
+};
+
+/// # `best::btree_map<K, V>`
+///
+/// A map from keys of type `K` to values of type `V`, stored in key order.
+/// This is the `best` `std::map`, although its design is that of Rust's
+/// `BTreeMap`: each node stores many entries inline, which makes it far
+/// friendlier to the cache than a binary tree. Pointers to entries are
+/// invalidated by insertion and removal.
+///
+/// Within a node, integer keys are searched with a branchless linear scan,
+/// which compilers turn into SIMD compares; all other keys use binary search.
+///
+/// Lookup functions are generic over the type of the key being looked up, so
+/// that, for example, a map with `best::strbuf` keys can be queried with a
+/// `best::str`.
+template <best::relocatable K, best::relocatable V,
+          best::allocator A = best::malloc>
+  requires best::comparable<K>
+class btree_map final {
+ public:
+  /// Helper type aliases.
+  using key_type = K;
+  using value_type = V;
+  using entry = best::row<K, V>;
+
+  /// # `btree_map::alloc`
+  ///
+  /// This map's allocator type, which may be a reference.
+  using alloc = A;
+
+  /// # `btree_map::NodeCapacity`
+  ///
+  /// The maximum number of entries in a single node. This is picked so that a
+  /// node's keys span about four cache lines.
+  static constexpr size_t NodeCapacity =
+    2 * best::max(size_t{3}, best::min(size_t{32}, 128 / sizeof(K))) - 1;
+
+  /// # `btree_map::btree_map()`
+  ///
+  /// Constructs an empty map using the given allocator. An empty map does not
+  /// allocate.
+  btree_map() : btree_map(alloc{}) {}
+  explicit btree_map(alloc alloc) : alloc_(best::in_place, std::move(alloc)) {}
+
+  /// # `btree_map::btree_map{...}`
+  ///
+  /// Constructs a map via initializer list. If a key is repeated, the first
+  /// occurrence wins.
+  btree_map(std::initializer_list<entry> entries)
+    requires best::constructible<alloc> && best::copyable<K> &&
+             best::copyable<V>
+    : btree_map(alloc{}) {
+    for (const auto& entry : entries) {
+      get_or_insert(entry.first(), entry.second());
+    }
+  }
+
+  /// # `btree_map::from_sorted()`
+  ///
+  /// Bulk-loads a map from a span of entries, which must be sorted by key with
+  /// no duplicates; crashes otherwise.
+  ///
+  /// This is linear time, and packs every node as full as possible, unlike
+  /// repeated insertion, which leaves nodes half-full.
+  static btree_map from_sorted(best::span<const entry> entries)
+    requires best::constructible<alloc> && best::copyable<K> &&
+             best::copyable<V>
+  {
+    return from_sorted(alloc{}, entries);
+  }
+  static btree_map from_sorted(alloc alloc, best::span<const entry> entries)
+    requires best::copyable<K> && best::copyable<V>;
+
+  /// # `btree_map::btree_map(btree_map)`
+  ///
+  /// Maps are copyable if their keys and values are.
+  btree_map(const btree_map& that)
+    requires best::copyable<K> && best::copyable<V> &&
+             best::copyable<alloc>;
+  btree_map& operator=(const btree_map& that)
+    requires best::copyable<K> && best::copyable<V> &&
+             best::copyable<alloc>;
+  btree_map(btree_map&& that);
+  btree_map& operator=(btree_map&& that);
+
+  /// # `btree_map::~btree_map()`
+  ///
+  /// Destroys every entry, and then frees every node.
+  ~btree_map() { clear(); }
+
+  /// # `btree_map::size()`, `btree_map::is_empty()`
+  ///
+  /// Returns the number of entries in this map, or whether it has none.
+  size_t size() const { return size_; }
+  bool is_empty() const { return size() == 0; }
+
+  /// # `btree_map::allocator()`
+  ///
+  /// Returns a reference to this map's allocator.
+  best::as_ref<const alloc> allocator() const { return *alloc_; }
+  best::as_ref<alloc> allocator() { return *alloc_; }
+
+  /// # `btree_map::get()`
+  ///
+  /// Looks up the value for `key`, if there is one.
+  template <typename Q = K>
+  best::option<const V&> get(const Q& key) const
+    requires best::comparable<K, Q>
+  {
+    auto c = find(key);
+    if (!c.node) { return best::none; }
+    return *c.node->val(c.idx);
+  }
+  template <typename Q = K>
+  best::option<V&> get(const Q& key) requires best::comparable<K, Q>
+  {
+    auto c = find(key);
+    if (!c.node) { return best::none; }
+    return *c.node->val(c.idx);
+  }
+
+  /// # `btree_map::contains()`
+  ///
+  /// Returns whether this map has an entry for `key`.
+  template <typename Q = K>
+  bool contains(const Q& key) const requires best::comparable<K, Q>
+  {
+    return find(key).node != nullptr;
+  }
+
+  /// # `btree_map::first()`, `btree_map::last()`
+  ///
+  /// Returns the entries with the smallest and largest keys, if this map is
+  /// not empty.
+  best::option<best::row<const K&, const V&>> first() const {
+    return iter().next();
+  }
+  best::option<best::row<const K&, V&>> first() { return iter().next(); }
+  best::option<best::row<const K&, const V&>> last() const {
+    return iter().next_back();
+  }
+  best::option<best::row<const K&, V&>> last() { return iter().next_back(); }
+
+  /// # `btree_map::insert()`
+  ///
+  /// Inserts a new entry into this map. If there already was an entry for
+  /// `key`, its value is replaced, and the old value is returned.
+  best::option<V> insert(K key, V value);
+
+  /// # `btree_map::get_or_insert()`
+  ///
+  /// Returns the value for `key`. If there is no such value, one is
+  /// constructed from `args` and inserted.
+  V& get_or_insert(K key, auto&&... args)
+    requires best::constructible<V, decltype(args)&&...>;
+
+  /// # `btree_map::remove()`
+  ///
+  /// Removes the entry for `key`, returning its value, if there was one.
+  template <typename Q = K>
+  best::option<V> remove(const Q& key) requires best::comparable<K, Q>;
+
+  /// # `btree_map::clear()`
+  ///
+  /// Removes every entry from this map, and frees every node.
+  void clear();
+
+  /// # `btree_map::iterator`
+  ///
+  /// This map's iterator types. They yield rows of a key and a value
+  /// reference, in key order, and are double-ended.
+  template <typename E>
+  class iter_impl;
+  using iterator = best::iter<iter_impl<V>>;
+  using const_iterator = best::iter<iter_impl<const V>>;
+
+  /// # `btree_map::iter()`, `btree_map::begin()`, `btree_map::end()`
+  ///
+  /// Maps are iterable exactly how you'd expect.
+  const_iterator iter() const {
+    return const_iterator(
+      iter_impl<const V>(root_, leftmost(root_), cursor{}, size_));
+  }
+  iterator iter() {
+    return iterator(iter_impl<V>(root_, leftmost(root_), cursor{}, size_));
+  }
+  auto begin() const { return iter().into_range(); }
+  auto end() const { return best::iter_range_end{}; }
+  auto begin() { return iter().into_range(); }
+  auto end() { return best::iter_range_end{}; }
+
+  /// # `btree_map::range()`
+  ///
+  /// Returns an iterator over the entries whose keys lie in `range`. See
+  /// `best::key_range`.
+  ///
+  /// Finding the ends of the range is O(log n); iterating over it is O(1)
+  /// amortized per entry.
+  template <typename Q = K>
+  const_iterator range(const best::key_range<Q>& keys) const
+    requires best::comparable<K, Q>
+  {
+    auto [front, back] = find_range(keys);
+    return const_iterator(iter_impl<const V>(root_, front, back, best::none));
+  }
+  template <typename Q = K>
+  iterator range(const best::key_range<Q>& keys)
+    requires best::comparable<K, Q>
+  {
+    auto [front, back] = find_range(keys);
+    return iterator(iter_impl<V>(root_, front, back, best::none));
+  }
+
+  /// # `btree_map::operator==`
+  ///
+  /// Maps are equal if they have the same entries.
+  bool operator==(const btree_map& that) const requires best::equatable<V>;
+
+ private:
+  // Nodes hold between MinLen and Cap entries, except for the root, which may
+  // hold fewer.
+  static constexpr size_t Cap = NodeCapacity;
+  static constexpr size_t MinLen = Cap / 2;
+
+  struct internal;
+  struct leaf {
+    internal* parent = nullptr;
+    uint16_t parent_idx = 0;
+    uint16_t len = 0;
+    bool is_leaf = true;
+
+    // Keys are stored separately from values, so that searching a node only
+    // touches the keys.
+    alignas(K) char keys[sizeof(K) * Cap];
+    alignas(V) char vals[sizeof(V) * Cap];
+
+    best::ptr<K> key(size_t i) { return reinterpret_cast<K*>(keys) + i; }
+    best::ptr<V> val(size_t i) { return reinterpret_cast<V*>(vals) + i; }
+  };
+  struct internal : leaf {
+    leaf* children[Cap + 1];
+  };
+
+  static internal* as_internal(leaf* n) { return static_cast<internal*>(n); }
+
+  // A position in the tree: the `idx`th entry of `node`. A null node is the
+  // position past the last entry.
+  struct cursor final {
+    leaf* node = nullptr;
+    size_t idx = 0;
+
+    bool operator==(const cursor&) const = default;
+  };
+
+  // Searches `n` for `key`, returning the index of the first key that is not
+  // less than it, and whether that key is equal to it.
+  template <typename Q>
+  static best::row<size_t, bool> search(leaf* n, const Q& key);
+
+  // Returns the position of `key`, or null if it is not present.
+  template <typename Q>
+  cursor find(const Q& key) const;
+
+  // Returns the position of the first key not less than `key` (or, if
+  // `strict`, greater than `key`), or null if there is none.
+  template <typename Q>
+  cursor bound(const Q& key, bool strict) const;
+
+  template <typename Q>
+  best::row<cursor, cursor> find_range(const best::key_range<Q>& keys) const;
+
+  // Finds the position of `key` if present; otherwise, finds the position in a
+  // leaf where it would be inserted. Allocates a root if there is none.
+  best::row<cursor, bool> locate(const K& key);
+
+  // In-order successor and predecessor. `prev()` of null is the last entry.
+  static cursor leftmost(leaf* n);
+  static cursor next(cursor c);
+  static cursor prev(leaf* root, cursor c);
+
+  // Node lifecycle.
+  leaf* new_leaf();
+  internal* new_internal();
+  void free_node(leaf* n);
+  void destroy_subtree(leaf* n);
+  leaf* clone(leaf* n, internal* parent, size_t parent_idx);
+
+  // Points the children of `n` in [start, end) back at `n`.
+  static void fix(internal* n, size_t start, size_t end);
+
+  // Inserts an entry at `idx` into `n`, which must not be full. If `n` is an
+  // internal node, `edge` becomes the new entry's right child.
+  static void put(leaf* n, size_t idx, auto&& key, leaf* edge,
+                  auto&&... args);
+
+  // Moves the last Cap - MinLen - 1 entries of the full node `n` into a new
+  // right sibling, which is returned. The median entry is left in place at
+  // index MinLen, outside of both nodes, for the caller to move out.
+  leaf* split(leaf* n);
+
+  // Inserts a new entry at `idx` in the leaf `n`, splitting as needed, and
+  // returns where it ended up.
+  cursor insert_new(leaf* n, size_t idx, K key, auto&&... args);
+
+  // Inserts an entry and its right child into the parent of `left`, splitting
+  // as far up as necessary.
+  void push_up(leaf* left, K key, V value, leaf* right);
+
+  // Removes the entry at `c`, returning its value.
+  V remove_at(cursor c);
+
+  // Restores the minimum occupancy of `n` after a removal.
+  void rebalance(leaf* n);
+
+  // Moves `count` entries from the `idx`th child of `p` to the next one (or
+  // vice-versa), rotating them through the separating entry.
+  static void steal_right(internal* p, size_t idx, size_t count);
+  static void steal_left(internal* p, size_t idx, size_t count);
+
+  // Merges the `idx + 1`th child of `p` and the separating entry into the
+  // `idx`th child.
+  void merge(internal* p, size_t idx);
+
+  // Appends an entry greater than every other key, given the rightmost leaf.
+  void push_back(leaf*& tail, const K& key, const V& value);
+
+  template <typename T>
+  static T take(best::ptr<T> p) {
+    T value = std::move(*p);
+    p.destroy();
+    return value;
+  }
+
+  best::object<alloc> alloc_;
+  leaf* root_ = nullptr;
+  size_t size_ = 0;
+};
+
+/// # `best::btree_map::iter_impl`
+///
+/// The iterator implementation for `best::btree_map`.
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+template <typename E>
+class btree_map<K, V, A>::iter_impl final {
+ public:
+  using BestIterArrow = void;
+
+ private:
+  friend btree_map;
+  friend best::iter<iter_impl>;
+  friend best::iter<iter_impl&>;
+
+  explicit iter_impl(leaf* root, cursor front, cursor back,
+                     best::option<size_t> left)
+    : root_(root), front_(front), back_(back), left_(left) {}
+
+  best::option<best::row<const K&, E&>> next() {
+    if (front_ == back_) { return best::none; }
+    auto c = front_;
+    front_ = btree_map::next(c);
+    if (left_) { --*left_; }
+    return best::row<const K&, E&>(*c.node->key(c.idx), *c.node->val(c.idx));
+  }
+
+  best::option<best::row<const K&, E&>> next_back() {
+    if (front_ == back_) { return best::none; }
+    auto c = back_ = btree_map::prev(root_, back_);
+    if (left_) { --*left_; }
+    return best::row<const K&, E&>(*c.node->key(c.idx), *c.node->val(c.idx));
+  }
+
+  best::size_hint size_hint() const {
+    if (left_) { return {*left_, *left_}; }
+    if (front_ == back_) { return {0, 0}; }
+    return {1, best::none};
+  }
+
+  leaf* root_;
+  cursor front_, back_;
+  best::option<size_t> left_;
+};
+}  // namespace best
+
+/* ////////////////////////////////////////////////////////////////////////// *\
+ * ////////////////// !!! IMPLEMENTATION DETAILS BELOW !!! ////////////////// *
+\* ////////////////////////////////////////////////////////////////////////// */
+
+namespace best {
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+auto btree_map<K, V, A>::from_sorted(alloc alloc,
+                                     best::span<const entry> entries)
+  -> btree_map requires best::copyable<K> && best::copyable<V>
+{
+  btree_map map(std::move(alloc));
+  leaf* tail = nullptr;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    auto& [key, value] = entries[i];
+    if (i > 0 && (entries[i - 1].first() <=> key) >= 0) {
+      best::crash_internal::crash(
+        "btree_map::from_sorted(): entries at %zu and %zu are out of order",
+        i - 1, i);
+    }
+    map.push_back(tail, key, value);
+  }
+
+  // Every node except those along the right edge of the tree is full, but
+  // those may have as few as zero entries. Top it up from its left sibling,
+  // which has plenty to spare.
+  leaf* n = map.root_;
+  while (n != nullptr && !n->is_leaf) {
+    auto* in = as_internal(n);
+    leaf* last = in->children[in->len];
+    if (last->len < MinLen) {
+      steal_right(in, in->len - 1, MinLen - last->len);
+    }
+    n = last;
+  }
+  return map;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+void btree_map<K, V, A>::push_back(leaf*& tail, const K& key,
+                                   const V& value) {
+  ++size_;
+  if (tail == nullptr) { root_ = tail = new_leaf(); }
+  if (tail->len < Cap) {
+    put(tail, tail->len, key, nullptr, value);
+    return;
+  }
+
+  // Find the lowest ancestor with room, growing a new root if there is none.
+  internal* open = tail->parent;
+  size_t height = 1;
+  while (open != nullptr && open->len == Cap) {
+    open = open->parent;
+    ++height;
+  }
+  if (open == nullptr) {
+    open = new_internal();
+    open->children[0] = root_;
+    fix(open, 0, 1);
+    root_ = open;
+  }
+
+  // Hang a fresh, empty right edge off of `open`, down to a new leaf.
+  tail = new_leaf();
+  leaf* edge = tail;
+  for (size_t h = 1; h < height; ++h) {
+    auto* n = new_internal();
+    n->children[0] = edge;
+    fix(n, 0, 1);
+    edge = n;
+  }
+  put(open, open->len, key, edge, value);
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+btree_map<K, V, A>::btree_map(const btree_map& that)
+  requires best::copyable<K> && best::copyable<V> && best::copyable<alloc>
+  : btree_map(that.allocator()) {
+  *this = that;
+}
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+auto btree_map<K, V, A>::operator=(const btree_map& that) -> btree_map&
+  requires best::copyable<K> && best::copyable<V> && best::copyable<alloc>
+{
+  if (best::equal(this, &that)) { return *this; }
+
+  clear();
+  if (that.root_ != nullptr) { root_ = clone(that.root_, nullptr, 0); }
+  size_ = that.size_;
+  return *this;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+btree_map<K, V, A>::btree_map(btree_map&& that)
+  : btree_map(std::move(that.allocator())) {
+  root_ = std::exchange(that.root_, nullptr);
+  size_ = std::exchange(that.size_, 0);
+}
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+auto btree_map<K, V, A>::operator=(btree_map&& that) -> btree_map& {
+  if (best::equal(this, &that)) { return *this; }
+
+  clear();
+  alloc_ = std::move(that.alloc_);
+  root_ = std::exchange(that.root_, nullptr);
+  size_ = std::exchange(that.size_, 0);
+  return *this;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+void btree_map<K, V, A>::clear() {
+  if (root_ != nullptr) { destroy_subtree(root_); }
+  root_ = nullptr;
+  size_ = 0;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+bool btree_map<K, V, A>::operator==(const btree_map& that) const
+  requires best::equatable<V>
+{
+  if (size() != that.size()) { return false; }
+
+  auto theirs = that.iter();
+  for (auto [k, v] : *this) {
+    auto [k2, v2] = *theirs.next();
+    if (k != k2 || v != v2) { return false; }
+  }
+  return true;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+template <typename Q>
+best::row<size_t, bool> btree_map<K, V, A>::search(leaf* n, const Q& key) {
+  size_t len = n->len;
+  if constexpr (best::is_int<K> && best::same<K, Q>) {
+    // Count the keys less than `key`. There is deliberately no early exit, so
+    // that this compiles to straight-line SIMD compares rather than a
+    // mispredicted branch per key.
+    const K* keys = n->key(0).raw();
+    size_t idx = 0;
+    for (size_t i = 0; i < len; ++i) { idx += keys[i] < key; }
+    return {idx, idx < len && keys[idx] == key};
+  } else {
+    size_t lo = 0, hi = len;
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      auto ord = *n->key(mid) <=> key;
+      if (ord == 0) { return {mid, true}; }
+      if (ord < 0) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return {lo, false};
+  }
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+template <typename Q>
+auto btree_map<K, V, A>::find(const Q& key) const -> cursor {
+  leaf* n = root_;
+  while (n != nullptr) {
+    auto [idx, found] = search(n, key);
+    if (found) { return {n, idx}; }
+    if (n->is_leaf) { break; }
+    n = as_internal(n)->children[idx];
+  }
+  return {};
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+template <typename Q>
+auto btree_map<K, V, A>::bound(const Q& key, bool strict) const -> cursor {
+  cursor best;
+  leaf* n = root_;
+  while (n != nullptr) {
+    auto [idx, found] = search(n, key);
+    if (found) { return strict ? next({n, idx}) : cursor{n, idx}; }
+
+    // Everything in the subtree we are about to descend into is smaller than
+    // the key at `idx`, so it can only get better from here.
+    if (idx < n->len) { best = {n, idx}; }
+    if (n->is_leaf) { break; }
+    n = as_internal(n)->children[idx];
+  }
+  return best;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+template <typename Q>
+auto btree_map<K, V, A>::find_range(const best::key_range<Q>& keys) const
+  -> best::row<cursor, cursor> {
+  cursor front = keys.start ? bound(*keys.start, false) : leftmost(root_);
+  cursor back;
+  if (keys.end) {
+    back = bound(*keys.end, false);
+  } else if (keys.including_end) {
+    back = bound(*keys.including_end, true);
+  }
+
+  // Make inverted ranges empty, rather than letting them run off the end.
+  if (front.node == nullptr ||
+      (back.node != nullptr &&
+       (*front.node->key(front.idx) <=> *back.node->key(back.idx)) >= 0)) {
+    front = back;
+  }
+  return {front, back};
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+auto btree_map<K, V, A>::locate(const K& key) -> best::row<cursor, bool> {
+  if (root_ == nullptr) { root_ = new_leaf(); }
+
+  leaf* n = root_;
+  while (true) {
+    auto [idx, found] = search(n, key);
+    if (found || n->is_leaf) { return {cursor{n, idx}, found}; }
+    n = as_internal(n)->children[idx];
+  }
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+auto btree_map<K, V, A>::leftmost(leaf* n) -> cursor {
+  if (n == nullptr || n->len == 0) { return {}; }
+  while (!n->is_leaf) { n = as_internal(n)->children[0]; }
+  return {n, 0};
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+auto btree_map<K, V, A>::next(cursor c) -> cursor {
+  leaf* n = c.node;
+  size_t idx = c.idx + 1;
+  if (!n->is_leaf) {
+    n = as_internal(n)->children[idx];
+    while (!n->is_leaf) { n = as_internal(n)->children[0]; }
+    return {n, 0};
+  }
+
+  // The `i`th child of a node is followed by that node's `i`th entry.
+  while (idx == n->len) {
+    if (n->parent == nullptr) { return {}; }
+    idx = n->parent_idx;
+    n = n->parent;
+  }
+  return {n, idx};
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+auto btree_map<K, V, A>::prev(leaf* root, cursor c) -> cursor {
+  leaf* n = c.node;
+  size_t idx = c.idx;
+  if (n == nullptr || !n->is_leaf) {
+    n = n == nullptr ? root : as_internal(n)->children[idx];
+    while (!n->is_leaf) { n = as_internal(n)->children[n->len]; }
+    return {n, size_t{n->len} - 1};
+  }
+
+  // The `i`th child of a node is preceded by that node's `i - 1`th entry.
+  while (idx == 0) {
+    idx = n->parent_idx;
+    n = n->parent;
+  }
+  return {n, idx - 1};
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+auto btree_map<K, V, A>::new_leaf() -> leaf* {
+  auto p = alloc_->alloc(best::layout::of<leaf>());
+  return new (p.raw()) leaf;
+}
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+auto btree_map<K, V, A>::new_internal() -> internal* {
+  auto p = alloc_->alloc(best::layout::of<internal>());
+  auto* n = new (p.raw()) internal;
+  n->is_leaf = false;
+  return n;
+}
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+void btree_map<K, V, A>::free_node(leaf* n) {
+  if (n->is_leaf) {
+    alloc_->dealloc(n, best::layout::of<leaf>());
+  } else {
+    alloc_->dealloc(as_internal(n), best::layout::of<internal>());
+  }
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+void btree_map<K, V, A>::destroy_subtree(leaf* n) {
+  for (size_t i = 0; i < n->len; ++i) {
+    n->key(i).destroy();
+    n->val(i).destroy();
+  }
+  if (!n->is_leaf) {
+    auto* in = as_internal(n);
+    for (size_t i = 0; i <= n->len; ++i) { destroy_subtree(in->children[i]); }
+  }
+  free_node(n);
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+auto btree_map<K, V, A>::clone(leaf* n, internal* parent, size_t parent_idx)
+  -> leaf* {
+  leaf* copy = n->is_leaf ? new_leaf() : new_internal();
+  copy->parent = parent;
+  copy->parent_idx = parent_idx;
+  copy->key(0).copy(n->key(0), n->len);
+  copy->val(0).copy(n->val(0), n->len);
+  copy->len = n->len;
+
+  if (!n->is_leaf) {
+    auto* in = as_internal(n);
+    auto* out = as_internal(copy);
+    for (size_t i = 0; i <= n->len; ++i) {
+      out->children[i] = clone(in->children[i], out, i);
+    }
+  }
+  return copy;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+void btree_map<K, V, A>::fix(internal* n, size_t start, size_t end) {
+  for (size_t i = start; i < end; ++i) {
+    n->children[i]->parent = n;
+    n->children[i]->parent_idx = i;
+  }
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+void btree_map<K, V, A>::put(leaf* n, size_t idx, auto&& key, leaf* edge,
+                             auto&&... args) {
+  size_t len = n->len;
+  n->key(idx + 1).relo_overlapping(n->key(idx), len - idx);
+  n->val(idx + 1).relo_overlapping(n->val(idx), len - idx);
+  n->key(idx).construct(BEST_FWD(key));
+  n->val(idx).construct(BEST_FWD(args)...);
+
+  if (!n->is_leaf) {
+    auto* in = as_internal(n);
+    std::memmove(in->children + idx + 2, in->children + idx + 1,
+                 (len - idx) * sizeof(leaf*));
+    in->children[idx + 1] = edge;
+    fix(in, idx + 1, len + 2);
+  }
+  ++n->len;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+auto btree_map<K, V, A>::split(leaf* n) -> leaf* {
+  constexpr size_t Moved = Cap - MinLen - 1;
+  leaf* right = n->is_leaf ? new_leaf() : new_internal();
+  right->key(0).relo(n->key(MinLen + 1), Moved);
+  right->val(0).relo(n->val(MinLen + 1), Moved);
+
+  if (!n->is_leaf) {
+    auto* in = as_internal(n);
+    auto* out = as_internal(right);
+    std::memcpy(out->children, in->children + MinLen + 1,
+                (Moved + 1) * sizeof(leaf*));
+    fix(out, 0, Moved + 1);
+  }
+
+  right->len = Moved;
+  n->len = MinLen;
+  return right;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+auto btree_map<K, V, A>::insert_new(leaf* n, size_t idx, K key,
+                                    auto&&... args) -> cursor {
+  ++size_;
+  if (n->len < Cap) {
+    put(n, idx, std::move(key), nullptr, BEST_FWD(args)...);
+    return {n, idx};
+  }
+
+  leaf* right = split(n);
+  K mid_key = take(n->key(MinLen));
+  V mid_val = take(n->val(MinLen));
+
+  cursor where{n, idx};
+  if (idx > MinLen) { where = {right, idx - MinLen - 1}; }
+  put(where.node, where.idx, std::move(key), nullptr, BEST_FWD(args)...);
+
+  push_up(n, std::move(mid_key), std::move(mid_val), right);
+  return where;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+void btree_map<K, V, A>::push_up(leaf* left, K key, V value, leaf* right) {
+  while (true) {
+    internal* p = left->parent;
+    if (p == nullptr) {
+      p = new_internal();
+      p->children[0] = left;
+      fix(p, 0, 1);
+      put(p, 0, std::move(key), right, std::move(value));
+      root_ = p;
+      return;
+    }
+
+    size_t idx = left->parent_idx;
+    if (p->len < Cap) {
+      put(p, idx, std::move(key), right, std::move(value));
+      return;
+    }
+
+    auto* p_right = as_internal(split(p));
+    K mid_key = take(p->key(MinLen));
+    V mid_val = take(p->val(MinLen));
+    if (idx <= MinLen) {
+      put(p, idx, std::move(key), right, std::move(value));
+    } else {
+      put(p_right, idx - MinLen - 1, std::move(key), right, std::move(value));
+    }
+
+    left = p;
+    right = p_right;
+    key = std::move(mid_key);
+    value = std::move(mid_val);
+  }
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+best::option<V> btree_map<K, V, A>::insert(K key, V value) {
+  auto [c, found] = locate(key);
+  if (found) {
+    V& slot = *c.node->val(c.idx);
+    V old = std::move(slot);
+    slot = std::move(value);
+    return old;
+  }
+
+  insert_new(c.node, c.idx, std::move(key), std::move(value));
+  return best::none;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+V& btree_map<K, V, A>::get_or_insert(K key, auto&&... args)
+  requires best::constructible<V, decltype(args)&&...>
+{
+  auto [c, found] = locate(key);
+  if (found) { return *c.node->val(c.idx); }
+
+  auto where = insert_new(c.node, c.idx, std::move(key), BEST_FWD(args)...);
+  return *where.node->val(where.idx);
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+template <typename Q>
+best::option<V> btree_map<K, V, A>::remove(const Q& key)
+  requires best::comparable<K, Q>
+{
+  auto c = find(key);
+  if (c.node == nullptr) { return best::none; }
+  return remove_at(c);
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+V btree_map<K, V, A>::remove_at(cursor c) {
+  --size_;
+  leaf* n = c.node;
+  size_t idx = c.idx;
+  n->key(idx).destroy();
+  V value = take(n->val(idx));
+
+  if (!n->is_leaf) {
+    // Replace the entry with its predecessor, which is always in a leaf, and
+    // then remove that instead.
+    leaf* pred = as_internal(n)->children[idx];
+    while (!pred->is_leaf) { pred = as_internal(pred)->children[pred->len]; }
+
+    size_t last = pred->len - 1;
+    n->key(idx).relo(pred->key(last));
+    n->val(idx).relo(pred->val(last));
+    --pred->len;
+    rebalance(pred);
+    return value;
+  }
+
+  size_t tail = n->len - idx - 1;
+  n->key(idx).relo_overlapping(n->key(idx + 1), tail);
+  n->val(idx).relo_overlapping(n->val(idx + 1), tail);
+  --n->len;
+  rebalance(n);
+  return value;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+void btree_map<K, V, A>::rebalance(leaf* n) {
+  while (n->len < MinLen) {
+    internal* p = n->parent;
+    if (p == nullptr) {
+      // The root may have as few entries as it likes, but not zero.
+      if (n->len > 0) { return; }
+      if (n->is_leaf) {
+        root_ = nullptr;
+      } else {
+        root_ = as_internal(n)->children[0];
+        root_->parent = nullptr;
+        root_->parent_idx = 0;
+      }
+      free_node(n);
+      return;
+    }
+
+    size_t idx = n->parent_idx;
+    if (idx > 0 && p->children[idx - 1]->len > MinLen) {
+      steal_right(p, idx - 1, 1);
+      return;
+    }
+    if (idx < p->len && p->children[idx + 1]->len > MinLen) {
+      steal_left(p, idx, 1);
+      return;
+    }
+
+    merge(p, idx > 0 ? idx - 1 : idx);
+    n = p;
+  }
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+void btree_map<K, V, A>::steal_right(internal* p, size_t idx, size_t count) {
+  leaf* l = p->children[idx];
+  leaf* r = p->children[idx + 1];
+  size_t ll = l->len, rl = r->len;
+
+  // Make room at the front of `r`, then rotate the last `count` entries of
+  // `l` through the separator.
+  r->key(count).relo_overlapping(r->key(0), rl);
+  r->val(count).relo_overlapping(r->val(0), rl);
+  r->key(count - 1).relo(p->key(idx));
+  r->val(count - 1).relo(p->val(idx));
+  r->key(0).relo(l->key(ll - count + 1), count - 1);
+  r->val(0).relo(l->val(ll - count + 1), count - 1);
+  p->key(idx).relo(l->key(ll - count));
+  p->val(idx).relo(l->val(ll - count));
+
+  if (!l->is_leaf) {
+    auto* li = as_internal(l);
+    auto* ri = as_internal(r);
+    std::memmove(ri->children + count, ri->children,
+                 (rl + 1) * sizeof(leaf*));
+    std::memcpy(ri->children, li->children + ll - count + 1,
+                count * sizeof(leaf*));
+    fix(ri, 0, rl + count + 1);
+  }
+
+  l->len -= count;
+  r->len += count;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+void btree_map<K, V, A>::steal_left(internal* p, size_t idx, size_t count) {
+  leaf* l = p->children[idx];
+  leaf* r = p->children[idx + 1];
+  size_t ll = l->len, rl = r->len;
+
+  // Rotate the first `count` entries of `r` through the separator onto the
+  // end of `l`, then close the gap in `r`.
+  l->key(ll).relo(p->key(idx));
+  l->val(ll).relo(p->val(idx));
+  l->key(ll + 1).relo(r->key(0), count - 1);
+  l->val(ll + 1).relo(r->val(0), count - 1);
+  p->key(idx).relo(r->key(count - 1));
+  p->val(idx).relo(r->val(count - 1));
+  r->key(0).relo_overlapping(r->key(count), rl - count);
+  r->val(0).relo_overlapping(r->val(count), rl - count);
+
+  if (!l->is_leaf) {
+    auto* li = as_internal(l);
+    auto* ri = as_internal(r);
+    std::memcpy(li->children + ll + 1, ri->children, count * sizeof(leaf*));
+    std::memmove(ri->children, ri->children + count,
+                 (rl - count + 1) * sizeof(leaf*));
+    fix(li, ll + 1, ll + count + 1);
+    fix(ri, 0, rl - count + 1);
+  }
+
+  l->len += count;
+  r->len -= count;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+void btree_map<K, V, A>::merge(internal* p, size_t idx) {
+  leaf* l = p->children[idx];
+  leaf* r = p->children[idx + 1];
+  size_t ll = l->len, rl = r->len, pl = p->len;
+
+  l->key(ll).relo(p->key(idx));
+  l->val(ll).relo(p->val(idx));
+  l->key(ll + 1).relo(r->key(0), rl);
+  l->val(ll + 1).relo(r->val(0), rl);
+  if (!l->is_leaf) {
+    auto* li = as_internal(l);
+    std::memcpy(li->children + ll + 1, as_internal(r)->children,
+                (rl + 1) * sizeof(leaf*));
+    fix(li, ll + 1, ll + rl + 2);
+  }
+  l->len = ll + rl + 1;
+
+  // Close the gap in `p` left by the separator and `r`.
+  p->key(idx).relo_overlapping(p->key(idx + 1), pl - idx - 1);
+  p->val(idx).relo_overlapping(p->val(idx + 1), pl - idx - 1);
+  std::memmove(p->children + idx + 1, p->children + idx + 2,
+               (pl - idx - 1) * sizeof(leaf*));
+  fix(p, idx + 1, pl);
+  --p->len;
+
+  free_node(r);
+}
+}  // namespace best
+
+#endif  // BEST_CONTAINER_BTREE_MAP_H_
@@ -0,0 +1,231 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/container/btree_map.h"
+
+#include "best/container/vec.h"
+#include "best/test/fodder.h"
+#include "best/test/test.h"
+#include "best/text/str.h"
+#include "best/text/strbuf.h"
+
+namespace best::btree_map_test {
+using ::best_fodder::LeakTest;
+
+// Visits 0..n in a scrambled order; n must be a power of two.
+best::vec<int> scrambled(int n) {
+  best::vec<int> out;
+  for (int i = 0; i < n; ++i) { out.push((i * 37 + 11) & (n - 1)); }
+  return out;
+}
+
+best::test Empty = [](auto& t) {
+  best::btree_map<int, int> empty;
+  t.expect(empty.is_empty());
+  t.expect_eq(empty.size(), 0);
+  t.expect_eq(empty.get(42), best::none);
+  t.expect(!empty.contains(42));
+  t.expect_eq(empty.remove(42), best::none);
+  t.expect_eq(empty.first(), best::none);
+  t.expect_eq(empty.iter().count(), 0);
+  t.expect_eq(empty.range({.start = 1, .end = 5}).count(), 0);
+};
+
+best::test InsertGet = [](auto& t) {
+  best::btree_map<int, int> map;
+  for (int i : scrambled(4096)) { t.expect_eq(map.insert(i, -i), best::none); }
+  t.expect_eq(map.size(), 4096);
+
+  for (int i = 0; i < 4096; ++i) { t.expect_eq(map.get(i), -i); }
+  t.expect_eq(map.get(4096), best::none);
+  t.expect_eq(map.get(-1), best::none);
+
+  t.expect_eq(map.insert(5, 0), -5);
+  t.expect_eq(map.get(5), 0);
+  t.expect_eq(map.size(), 4096);
+
+  map.get_or_insert(6, 100) += 1;
+  t.expect_eq(map.get(6), -5);
+  map.get_or_insert(-6, 100) += 1;
+  t.expect_eq(map.get(-6), 101);
+};
+
+best::test Ordered = [](auto& t) {
+  best::btree_map<int, int> map;
+  for (int i : scrambled(1024)) { map.insert(i, i * 2); }
+
+  int expected = 0;
+  for (auto [k, v] : map) {
+    t.expect_eq(k, expected++);
+    t.expect_eq(v, k * 2);
+  }
+  t.expect_eq(expected, 1024);
+
+  expected = 1024;
+  for (auto [k, v] : map.iter().rev()) { t.expect_eq(k, --expected); }
+  t.expect_eq(expected, 0);
+
+  t.expect_eq(map.first()->first(), 0);
+  t.expect_eq(map.last()->first(), 1023);
+
+  for (auto [k, v] : map) { v = -k; }
+  t.expect_eq(map.get(100), -100);
+};
+
+best::test Remove = [](auto& t) {
+  best::btree_map<int, int> map;
+  for (int i : scrambled(4096)) { map.insert(i, i); }
+
+  // Remove the odd keys in a scrambled order, which exercises stealing and
+  // merging at every level.
+  for (int i : scrambled(4096)) {
+    if (i % 2 == 1) { t.expect_eq(map.remove(i), i); }
+  }
+  t.expect_eq(map.size(), 2048);
+
+  int expected = 0;
+  for (auto [k, v] : map) {
+    t.expect_eq(k, expected);
+    expected += 2;
+  }
+
+  for (int i = 0; i < 4096; ++i) {
+    if (i % 2 == 0) {
+      t.expect_eq(map.remove(i), i);
+    } else {
+      t.expect_eq(map.remove(i), best::none);
+    }
+  }
+  t.expect(map.is_empty());
+  t.expect_eq(map.iter().count(), 0);
+
+  map.insert(1, 1);
+  t.expect_eq(map.get(1), 1);
+};
+
+best::test Range = [](auto& t) {
+  best::btree_map<int, int> map;
+  for (int i : scrambled(1024)) { map.insert(i * 2, i); }
+
+  auto keys = [](auto it) {
+    best::vec<int> out;
+    for (auto [k, v] : it) { out.push(k); }
+    return out;
+  };
+
+  t.expect_eq(keys(map.range({.start = 10, .end = 20})),
+              best::vec{10, 12, 14, 16, 18});
+  t.expect_eq(keys(map.range({.start = 9, .including_end = 20})),
+              best::vec{10, 12, 14, 16, 18, 20});
+  t.expect_eq(keys(map.range({.start = 2040})),
+              best::vec{2040, 2042, 2044, 2046});
+  t.expect_eq(keys(map.range({.end = 5})), best::vec{0, 2, 4});
+  t.expect_eq(map.range({.start = 20, .end = 10}).count(), 0);
+  t.expect_eq(map.range({.start = 11, .end = 12}).count(), 0);
+  t.expect_eq(map.range({.start = 5000}).count(), 0);
+  t.expect_eq(map.range({}).count(), 1024);
+
+  best::vec<int> back;
+  for (auto [k, v] : map.range({.start = 10, .end = 20}).rev()) {
+    back.push(k);
+  }
+  t.expect_eq(back, best::vec{18, 16, 14, 12, 10});
+};
+
+best::test FromSorted = [](auto& t) {
+  for (int n : {0, 1, 10, 100, 1000, 10000}) {
+    best::vec<best::row<int, int>> entries;
+    for (int i = 0; i < n; ++i) { entries.push(i, -i); }
+
+    auto map = best::btree_map<int, int>::from_sorted(entries);
+    t.expect_eq(map.size(), n);
+
+    int expected = 0;
+    for (auto [k, v] : map) { t.expect_eq(k, expected++); }
+    t.expect_eq(expected, n);
+
+    // The tree must still be well-formed enough to mutate.
+    for (int i = 0; i < n; i += 3) { t.expect_eq(map.remove(i), -i); }
+    for (int i = n; i < n + 100; ++i) { map.insert(i, -i); }
+    for (int i = 0; i < n + 100; ++i) {
+      if (i < n && i % 3 == 0) {
+        t.expect(!map.contains(i));
+      } else {
+        t.expect_eq(map.get(i), -i);
+      }
+    }
+  }
+};
+
+best::test Strings = [](auto& t) {
+  best::btree_map<best::strbuf, int> map;
+  map.insert(best::strbuf("foo"), 1);
+  map.insert(best::strbuf("bar"), 2);
+  map.insert(best::strbuf("a much longer key than the others"), 3);
+
+  t.expect_eq(map.get(best::str("foo")), 1);
+  t.expect_eq(map.get(best::str("bar")), 2);
+  t.expect_eq(map.get(best::str("a much longer key than the others")), 3);
+  t.expect_eq(map.get(best::str("baz")), best::none);
+  t.expect_eq(map.first()->first(), "a much longer key than the others");
+
+  t.expect_eq(
+    map.range<best::str>({.start = "b", .end = "g"}).map([](auto e) {
+      return e.second();
+    }).to_vec(),
+    best::vec{2, 1});
+};
+
+best::test CopyMove = [](auto& t) {
+  best::btree_map<int, int> map;
+  for (int i : scrambled(256)) { map.insert(i, i); }
+
+  auto map2 = map;
+  t.expect_eq(map2.size(), 256);
+  t.expect(map == map2);
+
+  map2.insert(1000, 0);
+  t.expect(map != map2);
+
+  auto map3 = std::move(map);
+  t.expect_eq(map3.get(128), 128);
+  t.expect(map.is_empty());
+
+  map = map3;
+  t.expect_eq(map.get(128), 128);
+};
+
+best::test Leaky = [](auto& t) {
+  LeakTest l_(t);
+
+  using Bubble = LeakTest::Bubble;
+
+  best::btree_map<int, Bubble> x0;
+  for (int i : scrambled(512)) { x0.get_or_insert(i); }
+  for (int i = 0; i < 256; ++i) { x0.remove(i); }
+  x0.insert(0, Bubble());
+
+  auto x1 = x0;
+  auto x2 = std::move(x0);
+  x2 = x1;
+  x2 = std::move(x1);
+  x2.clear();
+  x2.get_or_insert(1);
+};
+}  // namespace best::btree_map_test
@@ -329,6 +329,28 @@ class choice final {
     };
   }
 
+  friend void BestHash(auto& hasher, const choice& ch)
+    requires requires(best::object<Alts>... alts) { (hasher.hash(alts), ...); }
+  {
+    ch.index_match([&](auto idx) { hasher.write(idx.value); },
+                   [&](auto idx, const auto& value) {
+                     hasher.write(idx.value);
+                     hasher.hash(value);
+                   });
+  }
+
+  // Choices pass on the spare niches of their representation (unused tag
+  // values, or unused niches of their one data-carrying alternative), so that
+  // nesting them does not make them bigger.
+  static constexpr size_t BestNiches =
+    choice_internal::impl<Alts...>::BestNiches;
+  constexpr explicit choice(niche nh) requires (BestNiches > 0)
+    : BEST_CHOICE_IMPL_(nh) {}
+  constexpr bool operator==(niche nh) const requires (BestNiches > 0)
+  {
+    return impl() == nh;
+  }
+
   // Comparisons.
   template <typename... Us>
   BEST_INLINE_ALWAYS constexpr bool operator==(const choice<Us...>& that) const
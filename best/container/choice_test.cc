@@ -27,6 +27,73 @@ using ::best_fodder::LeakTest;
 
 static_assert(sizeof(best::choice<int&, best::empty>) == sizeof(int*));
 
+// A type with three niches.
+struct Trit {
+  static constexpr size_t BestNiches = 3;
+
+  constexpr Trit(int value) : value(value) {}
+  constexpr explicit Trit(best::niche nh) : value(-1 - int(nh.index)) {}
+  constexpr bool operator==(best::niche nh) const {
+    return value == -1 - int(nh.index);
+  }
+  constexpr bool operator==(const Trit&) const = default;
+
+  int value;
+};
+
+static_assert(best::niche_count<Trit> == 3);
+static_assert(sizeof(best::choice<Trit, void, best::empty>) == sizeof(int));
+static_assert(sizeof(best::choice<void, void, Trit, void>) == sizeof(int));
+static_assert(sizeof(best::choice<Trit, void, void, void, void>) > sizeof(int));
+static_assert(sizeof(best::choice<Trit, int>) == 2 * sizeof(int));
+
+// Spare niches are passed on to enclosing choices.
+static_assert(best::choice<Trit, void>::BestNiches == 2);
+static_assert(best::choice<int, float>::BestNiches == 254);
+static_assert(best::choice<int&, void>::BestNiches == best::AddrNiches - 1);
+static_assert(sizeof(best::choice<best::choice<Trit, void>, void, void>) ==
+              sizeof(int));
+static_assert(sizeof(best::choice<best::choice<int, float>, void>) ==
+              sizeof(best::choice<int, float>));
+
+best::test MultiNiche = [](auto& t) {
+  using C = best::choice<void, Trit, best::empty>;
+  C x0(best::index<0>);
+  C x1(best::index<1>, 42);
+  C x2(best::index<2>);
+
+  t.expect_eq(x0.which(), 0);
+  t.expect_eq(x1.which(), 1);
+  t.expect_eq(x2.which(), 2);
+  t.expect_eq(x1[best::index<1>].value, 42);
+
+  x1 = x2;
+  t.expect_eq(x1.which(), 2);
+  x2 = C(best::index<1>, 7);
+  t.expect_eq(x2.which(), 1);
+  t.expect_eq(x2[best::index<1>].value, 7);
+
+  using N = best::choice<best::choice<int, float>, void>;
+  N y0(best::index<1>);
+  N y1(best::index<0>, best::index<1>, 1.5);
+  t.expect_eq(y0.which(), 1);
+  t.expect_eq(y1.which(), 0);
+  t.expect_eq(y1[best::index<0>][best::index<1>], 1.5);
+
+  int x = 5;
+  using R = best::choice<best::choice<int&, void>, void>;
+  static_assert(sizeof(R) == sizeof(int*));
+  R z0(best::index<1>);
+  R z1(best::index<0>, best::index<1>);
+  R z2(best::index<0>, best::index<0>, x);
+  t.expect_eq(z0.which(), 1);
+  t.expect_eq(z1.which(), 0);
+  t.expect_eq(z1[best::index<0>].which(), 1);
+  t.expect_eq(z2.which(), 0);
+  t.expect_eq(z2[best::index<0>].which(), 0);
+  t.expect_eq(&z2[best::index<0>][best::index<0>], &x);
+};
+
 best::test Nums = [](auto& t) {
   best::choice<int, float, bool> x0(best::index<0>, 42);
   best::choice<int, float, bool> x1(best::index<1>, 1.5);
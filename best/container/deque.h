@@ -0,0 +1,478 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_DEQUE_H_
+#define BEST_CONTAINER_DEQUE_H_
+
+#include <cstddef>
+#include <initializer_list>
+
+#include "best/container/object.h"
+#include "best/container/option.h"
+#include "best/container/row.h"
+#include "best/iter/iter.h"
+#include "best/log/location.h"
+#include "best/math/bit.h"
+#include "best/math/int.h"
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+#include "best/memory/span.h"
+#include "best/meta/init.h"
+
+//! Double-ended queues.
+//!
+//! `best::deque<T>` is a growable ring buffer, which supports pushing and
+//! popping at both ends in amortized constant time. It is the right tool for
+//! work queues, where `best::vec::remove(0)` would be O(n).
+
+namespace best {
+/// # `best::deque<T>`
+///
+/// A double-ended queue, implemented as a heap-allocated ring buffer. This is
+/// the `best` `std::deque`, although its layout is that of Rust's `VecDeque`:
+/// all elements live in a single buffer, which may wrap around its end.
+///
+/// Because of the wrap-around, a deque is not contiguous. Instead, it can be
+/// viewed as two spans with `as_spans()`: the elements of the deque are the
+/// elements of the first span followed by those of the second. This is useful
+/// for processing the contents of a deque in bulk.
+///
+/// Unlike `best::vec`, a deque has no inline storage. An empty deque does not
+/// allocate.
+template <best::relocatable T, best::allocator A = best::malloc>
+class deque final {
+ public:
+  /// Helper type aliases.
+  using type = T;
+  using value_type = best::un_qual<T>;
+
+  using cref = best::as_ref<const type>;
+  using ref = best::as_ref<type>;
+  using crref = best::as_rref<const type>;
+  using rref = best::as_rref<type>;
+  using cptr = best::as_raw_ptr<const type>;
+  using ptr = best::as_raw_ptr<type>;
+
+  /// # `deque::alloc`
+  ///
+  /// This deque's allocator type, which may be a reference.
+  using alloc = A;
+
+  /// # `deque::MinCapacity`
+  ///
+  /// The smallest capacity a deque allocates once it allocates at all.
+  static constexpr size_t MinCapacity = 8;
+
+  /// # `deque::deque()`
+  ///
+  /// Constructs an empty deque using the given allocator.
+  deque() : deque(alloc{}) {}
+  explicit deque(alloc alloc) : alloc_(best::in_place, std::move(alloc)) {}
+
+  /// # `deque::deque{...}`
+  ///
+  /// Constructs a deque via initializer list.
+  deque(std::initializer_list<value_type> range)
+    requires best::constructible<alloc> && best::is_object<T>
+    : deque(alloc{}, range) {}
+
+  /// # `deque::deque(alloc, {...})`
+  ///
+  /// Constructs a deque via initializer list, using the given allocator.
+  deque(alloc alloc, std::initializer_list<T> range)
+    requires best::is_object<T>
+    : deque(std::move(alloc)) {
+    reserve(range.size());
+    for (const auto& elem : range) { push_back(elem); }
+  }
+
+  /// # `deque::deque(deque)`
+  ///
+  /// Deques are copyable if their elements are. Moving a deque steals its
+  /// buffer, and leaves the moved-from deque empty.
+  deque(const deque& that) requires best::copyable<T> && best::copyable<alloc>;
+  deque& operator=(const deque& that)
+    requires best::copyable<T> && best::copyable<alloc>;
+  deque(deque&& that);
+  deque& operator=(deque&& that);
+
+  /// # `deque::~deque()`
+  ///
+  /// Destroys every element, and then frees the buffer.
+  ~deque() { destroy(); }
+
+  /// # `deque::size()`
+  ///
+  /// Returns the number of elements in this deque.
+  size_t size() const { return size_; }
+
+  /// # `deque::is_empty()`
+  ///
+  /// Checks whether this deque is empty.
+  bool is_empty() const { return size() == 0; }
+
+  /// # `deque::capacity()`
+  ///
+  /// Returns the number of elements this deque can hold before it needs to
+  /// grow. This is always zero or a power of two.
+  size_t capacity() const { return cap_; }
+
+  /// # `deque::allocator()`
+  ///
+  /// Returns a reference to this deque's allocator.
+  best::as_ref<const alloc> allocator() const { return *alloc_; }
+  best::as_ref<alloc> allocator() { return *alloc_; }
+
+  /// # `deque::as_spans()`
+  ///
+  /// Returns the contents of this deque as two spans, in order. The second
+  /// span is empty unless the contents wrap around the end of the buffer.
+  best::row<best::span<const T>, best::span<const T>> as_spans() const;
+  best::row<best::span<T>, best::span<T>> as_spans();
+
+  /// # `deque::first()`, `deque::last()`
+  ///
+  /// Returns the first or last element of this deque, if it is nonempty.
+  best::option<const T&> first() const { return at(0); }
+  best::option<T&> first() { return at(0); }
+  best::option<const T&> last() const { return at(size() - 1); }
+  best::option<T&> last() { return at(size() - 1); }
+
+  /// # `deque[idx]`
+  ///
+  /// Extracts a single element. Crashes if the requested index is
+  /// out-of-bounds.
+  const T& operator[](best::track_location<size_t> idx) const;
+  T& operator[](best::track_location<size_t> idx);
+
+  /// # `deque::at()`
+  ///
+  /// Extracts a single element. Returns `best::none` if the requested index is
+  /// out-of-bounds.
+  best::option<const T&> at(size_t idx) const;
+  best::option<T&> at(size_t idx);
+
+  /// # `deque::iterator`
+  ///
+  /// This deque's iterator types. They are double-ended, and yield elements
+  /// from front to back.
+  template <typename E>
+  class iter_impl;
+  using iterator = best::iter<iter_impl<T>>;
+  using const_iterator = best::iter<iter_impl<const T>>;
+
+  /// # `deque::iter()`, `deque::begin()`, `deque::end()`
+  ///
+  /// Deques are iterable exactly how you'd expect.
+  const_iterator iter() const {
+    return const_iterator(iter_impl<const T>(buf_, cap_ - 1, head_, size_));
+  }
+  iterator iter() {
+    return iterator(iter_impl<T>(buf_, cap_ - 1, head_, size_));
+  }
+  auto begin() const { return iter().into_range(); }
+  auto end() const { return best::iter_range_end{}; }
+  auto begin() { return iter().into_range(); }
+  auto end() { return best::iter_range_end{}; }
+
+  /// # `deque::reserve()`
+  ///
+  /// Ensures that pushing an additional `count` elements will not cause this
+  /// deque to grow.
+  void reserve(size_t count) {
+    if (count > cap_ - size_) { grow(size_ + count); }
+  }
+
+  /// # `deque::clear()`
+  ///
+  /// Destroys every element of this deque. This does not free the buffer.
+  void clear();
+
+  /// # `deque::push_back()`, `deque::push_front()`
+  ///
+  /// Constructs a new value at the back or front of this deque, in-place.
+  ref push_back(auto&&... args)
+    requires best::constructible<T, decltype(args)&&...>
+  {
+    if (size_ == cap_) { grow(size_ + 1); }
+    auto p = buf_ + slot(size_);
+    p.construct(BEST_FWD(args)...);
+    ++size_;
+    return *p;
+  }
+  ref push_front(auto&&... args)
+    requires best::constructible<T, decltype(args)&&...>
+  {
+    if (size_ == cap_) { grow(size_ + 1); }
+    auto p = buf_ + slot(cap_ - 1);
+    p.construct(BEST_FWD(args)...);
+    head_ = slot(cap_ - 1);
+    ++size_;
+    return *p;
+  }
+
+  /// # `deque::pop_back()`, `deque::pop_front()`
+  ///
+  /// Removes the value at the back or front of this deque, if there is one.
+  best::option<T> pop_back();
+  best::option<T> pop_front();
+
+  bool operator==(const deque& that) const requires best::equatable<T>;
+
+ private:
+  // Returns the index into buf_ of the `idx`th element. Note that slot(cap_ -
+  // 1) is the slot right before the front of the deque.
+  size_t slot(size_t idx) const { return (head_ + idx) & (cap_ - 1); }
+
+  // Reallocates the buffer so that it can hold at least `needed` elements.
+  void grow(size_t needed);
+
+  // Takes ownership of `that`'s buffer, leaving it empty.
+  void steal(deque& that);
+
+  void destroy();
+
+  best::object<alloc> alloc_;
+  best::ptr<T> buf_ = nullptr;
+  size_t cap_ = 0;
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
+
+/// # `best::deque::iter_impl`
+///
+/// The iterator implementation for `best::deque`.
+template <best::relocatable T, best::allocator A>
+template <typename E>
+class deque<T, A>::iter_impl final {
+ public:
+  using BestIterArrow = void;
+
+ private:
+  friend deque;
+  friend best::iter<iter_impl>;
+  friend best::iter<iter_impl&>;
+
+  iter_impl(best::ptr<E> buf, size_t mask, size_t head, size_t size)
+    : buf_(buf), mask_(mask), start_(head), end_(head + size) {}
+
+  best::option<E&> next() {
+    if (start_ == end_) { return best::none; }
+    return best::option<E&>(*(buf_ + (start_++ & mask_)));
+  }
+
+  best::option<E&> next_back() {
+    if (start_ == end_) { return best::none; }
+    return best::option<E&>(*(buf_ + (--end_ & mask_)));
+  }
+
+  best::size_hint size_hint() const {
+    return {end_ - start_, end_ - start_};
+  }
+
+  size_t count() && { return end_ - start_; }
+
+  best::ptr<E> buf_;
+  size_t mask_, start_, end_;
+};
+}  // namespace best
+
+/* ////////////////////////////////////////////////////////////////////////// *\
+ * ////////////////// !!! IMPLEMENTATION DETAILS BELOW !!! ////////////////// *
+\* ////////////////////////////////////////////////////////////////////////// */
+
+namespace best {
+template <best::relocatable T, best::allocator A>
+deque<T, A>::deque(const deque& that)
+  requires best::copyable<T> && best::copyable<alloc>
+  : deque(that.allocator()) {
+  *this = that;
+}
+template <best::relocatable T, best::allocator A>
+auto deque<T, A>::operator=(const deque& that)
+  -> deque& requires best::copyable<T> && best::copyable<alloc>
+{
+  if (best::equal(this, &that)) { return *this; }
+
+  clear();
+  reserve(that.size());
+
+  // clear() resets head_ to zero, and this deque is now large enough that the
+  // copies do not wrap around.
+  auto [a, b] = that.as_spans();
+  buf_.copy(a.data(), a.size());
+  (buf_ + a.size()).copy(b.data(), b.size());
+  size_ = that.size();
+  return *this;
+}
+
+template <best::relocatable T, best::allocator A>
+deque<T, A>::deque(deque&& that) : deque(std::move(that.allocator())) {
+  steal(that);
+}
+template <best::relocatable T, best::allocator A>
+auto deque<T, A>::operator=(deque&& that) -> deque& {
+  if (best::equal(this, &that)) { return *this; }
+
+  destroy();
+  alloc_ = std::move(that.alloc_);
+  steal(that);
+  return *this;
+}
+
+template <best::relocatable T, best::allocator A>
+void deque<T, A>::steal(deque& that) {
+  buf_ = that.buf_;
+  cap_ = that.cap_;
+  head_ = that.head_;
+  size_ = that.size_;
+
+  that.buf_ = nullptr;
+  that.cap_ = that.head_ = that.size_ = 0;
+}
+
+template <best::relocatable T, best::allocator A>
+void deque<T, A>::destroy() {
+  clear();
+  if (cap_ > 0) { alloc_->dealloc(buf_, best::layout::array<T>(cap_)); }
+
+  buf_ = nullptr;
+  cap_ = 0;
+}
+
+template <best::relocatable T, best::allocator A>
+auto deque<T, A>::as_spans() const
+  -> best::row<best::span<const T>, best::span<const T>> {
+  size_t first = best::min(size_, cap_ - head_);
+  return {best::span<const T>(buf_ + head_, first),
+          best::span<const T>(buf_, size_ - first)};
+}
+template <best::relocatable T, best::allocator A>
+auto deque<T, A>::as_spans() -> best::row<best::span<T>, best::span<T>> {
+  size_t first = best::min(size_, cap_ - head_);
+  return {best::span<T>(buf_ + head_, first),
+          best::span<T>(buf_, size_ - first)};
+}
+
+template <best::relocatable T, best::allocator A>
+const T& deque<T, A>::operator[](best::track_location<size_t> idx) const {
+  best::bounds{.start = idx, .count = 1}.compute_count(size(), idx);
+  return *(buf_ + slot(idx));
+}
+template <best::relocatable T, best::allocator A>
+T& deque<T, A>::operator[](best::track_location<size_t> idx) {
+  best::bounds{.start = idx, .count = 1}.compute_count(size(), idx);
+  return *(buf_ + slot(idx));
+}
+
+template <best::relocatable T, best::allocator A>
+best::option<const T&> deque<T, A>::at(size_t idx) const {
+  if (idx >= size()) { return best::none; }
+  return *(buf_ + slot(idx));
+}
+template <best::relocatable T, best::allocator A>
+best::option<T&> deque<T, A>::at(size_t idx) {
+  if (idx >= size()) { return best::none; }
+  return *(buf_ + slot(idx));
+}
+
+template <best::relocatable T, best::allocator A>
+void deque<T, A>::clear() {
+  if (!best::destructible<T, trivially>) {
+    auto [a, b] = as_spans();
+    a.destroy();
+    b.destroy();
+  }
+  head_ = 0;
+  size_ = 0;
+}
+
+template <best::relocatable T, best::allocator A>
+best::option<T> deque<T, A>::pop_back() {
+  if (is_empty()) { return best::none; }
+
+  auto p = buf_ + slot(size_ - 1);
+  T value = std::move(*p);
+  p.destroy();
+  --size_;
+  return value;
+}
+template <best::relocatable T, best::allocator A>
+best::option<T> deque<T, A>::pop_front() {
+  if (is_empty()) { return best::none; }
+
+  auto p = buf_ + head_;
+  T value = std::move(*p);
+  p.destroy();
+  head_ = slot(1);
+  --size_;
+  return value;
+}
+
+template <best::relocatable T, best::allocator A>
+bool deque<T, A>::operator==(const deque& that) const
+  requires best::equatable<T>
+{
+  if (size() != that.size()) { return false; }
+  for (size_t i = 0; i < size(); ++i) {
+    if (!(*(buf_ + slot(i)) == *(that.buf_ + that.slot(i)))) { return false; }
+  }
+  return true;
+}
+
+template <best::relocatable T, best::allocator A>
+void deque<T, A>::grow(size_t needed) {
+  // The capacity must be a power of two, so that slot() can use a mask instead
+  // of a division.
+  if (!best::is_pow2(needed)) { needed = best::next_pow2(needed); }
+  size_t new_cap = best::max(needed, cap_ * 2, MinCapacity);
+
+  auto old_layout = best::layout::array<T>(cap_);
+  auto new_layout = best::layout::array<T>(new_cap);
+
+  // The contents are made up of two segments: [head_, head_ + first), and
+  // [0, second), which is the part that wrapped around.
+  size_t first = best::min(size_, cap_ - head_);
+  size_t second = size_ - first;
+
+  // If the buffer can be grown in place, the only thing that needs to move is
+  // the wrapped-around segment, which now fits after the first one.
+  if (cap_ > 0 && best::grow_in_place(*alloc_, buf_, old_layout, new_layout)) {
+    if (second > 0) { (buf_ + cap_).relo(buf_, second); }
+    cap_ = new_cap;
+    return;
+  }
+
+  // Otherwise, relocate both segments to the start of a new buffer. Any slack
+  // the allocator gives us can only be used in power-of-two increments.
+  auto fresh = best::alloc_at_least(*alloc_, new_layout);
+  auto new_buf = fresh.ptr.cast(best::types<T>);
+  while (new_cap * 2 <= fresh.size / best::size_of<T>) { new_cap *= 2; }
+
+  new_buf.relo(buf_ + head_, first);
+  (new_buf + first).relo(buf_, second);
+  if (cap_ > 0) { alloc_->dealloc(buf_, old_layout); }
+
+  buf_ = new_buf;
+  cap_ = new_cap;
+  head_ = 0;
+}
+}  // namespace best
+
+#endif  // BEST_CONTAINER_DEQUE_H_
@@ -0,0 +1,144 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/container/deque.h"
+
+#include "best/test/fodder.h"
+#include "best/test/test.h"
+
+namespace best::deque_test {
+using ::best_fodder::LeakTest;
+
+best::test Empty = [](auto& t) {
+  best::deque<int> empty;
+  t.expect(empty.is_empty());
+  t.expect_eq(empty.size(), 0);
+  t.expect_eq(empty.capacity(), 0);
+  t.expect_eq(empty.first(), best::none);
+  t.expect_eq(empty.pop_front(), best::none);
+  t.expect_eq(empty.pop_back(), best::none);
+
+  auto [a, b] = empty.as_spans();
+  t.expect(a.is_empty());
+  t.expect(b.is_empty());
+};
+
+best::test PushPop = [](auto& t) {
+  best::deque<int> ints;
+  ints.push_back(2);
+  ints.push_back(3);
+  ints.push_front(1);
+  ints.push_front(0);
+
+  t.expect_eq(ints.size(), 4);
+  t.expect_eq(ints.first(), 0);
+  t.expect_eq(ints.last(), 3);
+  for (int i = 0; i < 4; ++i) { t.expect_eq(ints[i], i); }
+
+  t.expect_eq(ints.pop_front(), 0);
+  t.expect_eq(ints.pop_back(), 3);
+  t.expect_eq(ints.pop_front(), 1);
+  t.expect_eq(ints.pop_front(), 2);
+  t.expect_eq(ints.pop_front(), best::none);
+  t.expect(ints.is_empty());
+};
+
+best::test Queue = [](auto& t) {
+  // Use the deque as a FIFO, so that the contents keep wrapping around.
+  best::deque<int> q;
+  int next_in = 0, next_out = 0;
+  for (int round = 0; round < 100; ++round) {
+    for (int i = 0; i < 7; ++i) { q.push_back(next_in++); }
+    for (int i = 0; i < 5; ++i) { t.expect_eq(q.pop_front(), next_out++); }
+  }
+
+  t.expect_eq(q.size(), 200);
+  t.expect(best::is_pow2(q.capacity()));
+  for (int i = 0; i < 200; ++i) { t.expect_eq(q[i], next_out + i); }
+};
+
+best::test Spans = [](auto& t) {
+  best::deque<int> ints;
+  ints.reserve(8);
+  size_t cap = ints.capacity();
+  for (size_t i = 0; i < cap; ++i) { ints.push_back(int(i)); }
+  ints.pop_front();
+  ints.pop_front();
+  ints.push_back(100);
+
+  // The last element wrapped around to the start of the buffer.
+  auto [a, b] = ints.as_spans();
+  t.expect_eq(a.size(), cap - 2);
+  t.expect_eq(b, {100});
+  t.expect_eq(a.first(), 2);
+
+  // Growing must preserve the order of both segments.
+  ints.push_back(101);
+  ints.push_front(1);
+  t.expect_eq(ints.size(), cap + 1);
+  t.expect_eq(ints.first(), 1);
+  t.expect_eq(ints[cap - 1], 100);
+  t.expect_eq(ints.last(), 101);
+
+  int sum = 0;
+  for (int x : ints) { sum += x; }
+  auto [c, d] = ints.as_spans();
+  int span_sum = 0;
+  for (int x : c) { span_sum += x; }
+  for (int x : d) { span_sum += x; }
+  t.expect_eq(sum, span_sum);
+};
+
+best::test CopyMove = [](auto& t) {
+  best::deque<int> ints = {1, 2, 3};
+  ints.push_front(0);
+
+  auto ints2 = ints;
+  t.expect_eq(ints2, ints);
+  t.expect_eq(ints2.size(), 4);
+
+  auto ints3 = std::move(ints);
+  t.expect_eq(ints3, ints2);
+  t.expect(ints.is_empty());
+
+  ints = ints3;
+  t.expect_eq(ints, ints2);
+};
+
+best::test Leaky = [](auto& t) {
+  LeakTest l_(t);
+
+  using Bubble = LeakTest::Bubble;
+
+  best::deque<Bubble> x0;
+  for (int i = 0; i < 20; ++i) {
+    x0.push_back();
+    x0.push_front();
+  }
+  x0.pop_front();
+  x0.pop_back();
+
+  auto x1 = x0;
+  auto x2 = std::move(x0);
+  x2 = x1;
+  x2 = std::move(x1);
+  x2.clear();
+  x2.push_back();
+};
+}  // namespace best::deque_test
@@ -0,0 +1,329 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_FLAT_MAP_H_
+#define BEST_CONTAINER_FLAT_MAP_H_
+
+#include <cstddef>
+#include <initializer_list>
+
+#include "best/base/ord.h"
+#include "best/container/internal/flat.h"
+#include "best/container/option.h"
+#include "best/container/result.h"
+#include "best/container/row.h"
+#include "best/container/vec.h"
+#include "best/iter/iter.h"
+#include "best/memory/allocator.h"
+#include "best/memory/span.h"
+#include "best/meta/init.h"
+
+//! Sorted maps.
+//!
+//! `best::flat_map<K, V>` is an ordered associative container stored as a
+//! sorted vector of entries. It is the right choice for maps that are built
+//! once (or in large batches) and then queried many times, such as symbol
+//! tables and name lookup tables.
+
+namespace best {
+/// # `best::flat_map<K, V>`
+///
+/// A map from keys of type `K` to values of type `V`, stored as a `best::vec`
+/// of entries sorted by key. Lookup is a binary search over contiguous memory,
+/// which is much friendlier to the cache than a node-based tree, and iteration
+/// is in key order.
+///
+/// Inserting a single entry is O(n), since it shifts every entry after it. To
+/// build a map, prefer constructing it from a vector of entries, or use
+/// `insert_all()`, both of which sort and deduplicate the new entries in one
+/// pass and then merge them in linear time.
+///
+/// Lookup functions are generic over the type of the key being looked up, so
+/// that, for example, a map with `best::strbuf` keys can be queried with a
+/// `best::str`.
+template <best::relocatable K, best::relocatable V,
+          best::allocator A = best::malloc>
+  requires best::comparable<K>
+class flat_map final {
+ public:
+  /// Helper type aliases.
+  using key_type = K;
+  using value_type = V;
+  using entry = best::row<K, V>;
+
+  /// # `flat_map::alloc`
+  ///
+  /// This map's allocator type, which may be a reference.
+  using alloc = A;
+
+  /// # `flat_map::flat_map()`
+  ///
+  /// Constructs an empty map using the given allocator. An empty map does not
+  /// allocate.
+  flat_map() : flat_map(alloc{}) {}
+  explicit flat_map(alloc alloc) : entries_(std::move(alloc)) {}
+
+  /// # `flat_map::flat_map(vec)`
+  ///
+  /// Constructs a map out of a vector of entries, in any order, reusing its
+  /// buffer. If a key is repeated, the first occurrence wins.
+  explicit flat_map(best::vec<entry, 0, alloc> entries)
+    : entries_(std::move(entries)) {
+    flat_internal::sort_unique(entries_, key_of, /*keep_last=*/false);
+  }
+
+  /// # `flat_map::flat_map{...}`
+  ///
+  /// Constructs a map via initializer list. If a key is repeated, the first
+  /// occurrence wins.
+  flat_map(std::initializer_list<entry> entries)
+    requires best::constructible<alloc> && best::copyable<K> &&
+             best::copyable<V>
+    : flat_map(best::vec<entry, 0, alloc>(entries)) {}
+
+  /// # `flat_map::flat_map(flat_map)`
+  ///
+  /// Maps are copyable if their keys and values are.
+  flat_map(const flat_map&) = default;
+  flat_map& operator=(const flat_map&) = default;
+  flat_map(flat_map&&) = default;
+  flat_map& operator=(flat_map&&) = default;
+
+  /// # `flat_map::size()`, `flat_map::is_empty()`
+  ///
+  /// Returns the number of entries in this map, or whether it has none.
+  size_t size() const { return entries_.size(); }
+  bool is_empty() const { return size() == 0; }
+
+  /// # `flat_map::capacity()`
+  ///
+  /// Returns the number of entries this map can hold before it must grow.
+  size_t capacity() const { return entries_.capacity(); }
+
+  /// # `flat_map::allocator()`
+  ///
+  /// Returns a reference to this map's allocator.
+  best::as_ref<const alloc> allocator() const { return entries_.allocator(); }
+  best::as_ref<alloc> allocator() { return entries_.allocator(); }
+
+  /// # `flat_map::entries()`
+  ///
+  /// Returns the entries of this map, sorted by key.
+  best::span<const entry> entries() const { return entries_; }
+
+  /// # `flat_map::get()`
+  ///
+  /// Looks up the value for `key`, if there is one.
+  template <typename Q = K>
+  best::option<const V&> get(const Q& key) const
+    requires best::comparable<K, Q>
+  {
+    auto idx = find(key).ok();
+    if (!idx) { return best::none; }
+    return entries_[*idx].second();
+  }
+  template <typename Q = K>
+  best::option<V&> get(const Q& key) requires best::comparable<K, Q>
+  {
+    auto idx = find(key).ok();
+    if (!idx) { return best::none; }
+    return entries_[*idx].second();
+  }
+
+  /// # `flat_map::contains()`
+  ///
+  /// Returns whether this map has an entry for `key`.
+  template <typename Q = K>
+  bool contains(const Q& key) const requires best::comparable<K, Q>
+  {
+    return find(key).is_ok();
+  }
+
+  /// # `flat_map::insert()`
+  ///
+  /// Inserts a new entry into this map. If there already was an entry for
+  /// `key`, its value is replaced, and the old value is returned.
+  best::option<V> insert(K key, V value);
+
+  /// # `flat_map::insert_all()`
+  ///
+  /// Inserts a batch of entries into this map, as if by calling `insert()` on
+  /// each of them in order: if a key is repeated, the last occurrence wins,
+  /// including over an entry already in the map.
+  ///
+  /// This sorts the batch once and merges it into the map in linear time,
+  /// rather than paying for a shift per entry.
+  void insert_all(best::vec<entry, 0, alloc> entries) {
+    flat_internal::sort_unique(entries, key_of, /*keep_last=*/true);
+    flat_internal::merge(entries_, std::move(entries), key_of);
+  }
+
+  /// # `flat_map::get_or_insert()`
+  ///
+  /// Returns the value for `key`. If there is no such value, one is
+  /// constructed from `args` and inserted.
+  V& get_or_insert(K key, auto&&... args)
+    requires best::constructible<V, decltype(args)&&...>;
+
+  /// # `flat_map::remove()`
+  ///
+  /// Removes the entry for `key`, returning its value, if there was one.
+  template <typename Q = K>
+  best::option<V> remove(const Q& key) requires best::comparable<K, Q>;
+
+  /// # `flat_map::reserve()`
+  ///
+  /// Ensures that `count` more entries can be inserted without the map
+  /// growing.
+  void reserve(size_t count) { entries_.reserve(count); }
+
+  /// # `flat_map::clear()`
+  ///
+  /// Removes every entry from this map. This does not free any memory.
+  void clear() { entries_.clear(); }
+
+  /// # `flat_map::iterator`
+  ///
+  /// This map's iterator types. They yield rows of a key and a value
+  /// reference, in key order.
+  template <typename E>
+  class iter_impl;
+  using iterator = best::iter<iter_impl<V>>;
+  using const_iterator = best::iter<iter_impl<const V>>;
+
+  /// # `flat_map::iter()`, `flat_map::begin()`, `flat_map::end()`
+  ///
+  /// Maps are iterable exactly how you'd expect.
+  const_iterator iter() const {
+    return const_iterator(iter_impl<const V>(entries_.data(), size()));
+  }
+  iterator iter() { return iterator(iter_impl<V>(entries_.data(), size())); }
+  auto begin() const { return iter().into_range(); }
+  auto end() const { return best::iter_range_end{}; }
+  auto begin() { return iter().into_range(); }
+  auto end() { return best::iter_range_end{}; }
+
+  /// # `flat_map::operator==`
+  ///
+  /// Maps are equal if they have the same entries.
+  bool operator==(const flat_map& that) const
+    requires best::equatable<V>
+  {
+    return entries() == that.entries();
+  }
+
+ private:
+  static const K& key_of(const entry& e) { return e.first(); }
+
+  template <typename Q>
+  best::result<size_t, size_t> find(const Q& key) const {
+    return entries_->bisect(key, key_of);
+  }
+
+  best::vec<entry, 0, alloc> entries_;
+};
+
+/// # `best::flat_map::iter_impl`
+///
+/// The iterator implementation for `best::flat_map`.
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+template <typename E>
+class flat_map<K, V, A>::iter_impl final {
+ public:
+  using BestIterArrow = void;
+
+ private:
+  friend flat_map;
+  friend best::iter<iter_impl>;
+  friend best::iter<iter_impl&>;
+
+  using ptr = best::ptr<best::select<best::is_const<E>, const entry, entry>>;
+
+  explicit iter_impl(ptr start, size_t len)
+    : start_(start), end_(start + len) {}
+
+  best::option<best::row<const K&, E&>> next() {
+    if (start_ == end_) { return best::none; }
+    auto& e = *start_++;
+    return best::row<const K&, E&>(e.first(), e.second());
+  }
+
+  best::option<best::row<const K&, E&>> next_back() {
+    if (start_ == end_) { return best::none; }
+    auto& e = *--end_;
+    return best::row<const K&, E&>(e.first(), e.second());
+  }
+
+  best::size_hint size_hint() const {
+    size_t left = end_ - start_;
+    return {left, left};
+  }
+
+  size_t count() && { return end_ - start_; }
+
+  ptr start_, end_;
+};
+}  // namespace best
+
+/* ////////////////////////////////////////////////////////////////////////// *\
+ * ////////////////// !!! IMPLEMENTATION DETAILS BELOW !!! ////////////////// *
+\* ////////////////////////////////////////////////////////////////////////// */
+
+namespace best {
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+best::option<V> flat_map<K, V, A>::insert(K key, V value) {
+  auto found = find(key);
+  if (auto idx = found.ok()) {
+    V& slot = entries_[*idx].second();
+    V old = std::move(slot);
+    slot = std::move(value);
+    return old;
+  }
+
+  entries_.insert(*found.err(), std::move(key), std::move(value));
+  return best::none;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+V& flat_map<K, V, A>::get_or_insert(K key, auto&&... args)
+  requires best::constructible<V, decltype(args)&&...>
+{
+  auto found = find(key);
+  if (auto idx = found.ok()) { return entries_[*idx].second(); }
+  return entries_
+    .insert(*found.err(), std::move(key), V(BEST_FWD(args)...))
+    .second();
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::comparable<K>
+template <typename Q>
+best::option<V> flat_map<K, V, A>::remove(const Q& key)
+  requires best::comparable<K, Q>
+{
+  auto idx = find(key).ok();
+  if (!idx) { return best::none; }
+  return std::move(entries_.remove(*idx).second());
+}
+}  // namespace best
+
+#endif  // BEST_CONTAINER_FLAT_MAP_H_
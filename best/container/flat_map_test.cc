@@ -0,0 +1,193 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/container/flat_map.h"
+
+#include "best/test/fodder.h"
+#include "best/test/test.h"
+#include "best/text/str.h"
+#include "best/text/strbuf.h"
+
+namespace best::flat_map_test {
+using ::best_fodder::LeakTest;
+
+best::test Empty = [](auto& t) {
+  best::flat_map<int, int> empty;
+  t.expect(empty.is_empty());
+  t.expect_eq(empty.size(), 0);
+  t.expect_eq(empty.capacity(), 0);
+  t.expect_eq(empty.get(42), best::none);
+  t.expect(!empty.contains(42));
+  t.expect_eq(empty.remove(42), best::none);
+};
+
+best::test InsertGet = [](auto& t) {
+  best::flat_map<int, int> map;
+  for (int i = 0; i < 100; ++i) {
+    // Alternate between the ends, so that inserts land in the middle.
+    int k = i % 2 == 0 ? i : -i;
+    t.expect_eq(map.insert(k, k * k), best::none);
+  }
+  t.expect_eq(map.size(), 100);
+
+  for (int i = 0; i < 100; ++i) {
+    int k = i % 2 == 0 ? i : -i;
+    t.expect_eq(map.get(k), k * k);
+  }
+  t.expect_eq(map.get(1), best::none);
+  t.expect_eq(map.get(-2), best::none);
+
+  t.expect_eq(map.insert(4, 0), 16);
+  t.expect_eq(map.get(4), 0);
+  t.expect_eq(map.size(), 100);
+
+  *map.get(6) = 7;
+  t.expect_eq(map.get(6), 7);
+
+  map.get_or_insert(6, 100) += 1;
+  t.expect_eq(map.get(6), 8);
+  map.get_or_insert(1, 100) += 1;
+  t.expect_eq(map.get(1), 101);
+
+  t.expect_eq(map.remove(1), 101);
+  t.expect_eq(map.remove(1), best::none);
+  t.expect_eq(map.size(), 100);
+};
+
+best::test Sorted = [](auto& t) {
+  best::flat_map<int, int> map = {{5, 0}, {1, 1}, {3, 2}, {1, 3}, {5, 4}};
+  t.expect_eq(map.size(), 3);
+
+  // First occurrence wins.
+  t.expect_eq(map.get(1), 1);
+  t.expect_eq(map.get(3), 2);
+  t.expect_eq(map.get(5), 0);
+
+  best::vec<int> keys;
+  for (auto [k, v] : map) { keys.push(k); }
+  t.expect_eq(keys, best::vec{1, 3, 5});
+
+  keys.clear();
+  for (auto [k, v] : map.iter().rev()) { keys.push(k); }
+  t.expect_eq(keys, best::vec{5, 3, 1});
+  t.expect_eq(map.iter().count(), 3);
+
+  for (auto [k, v] : map) { v *= 10; }
+  t.expect_eq(map.get(3), 20);
+};
+
+best::test FromVec = [](auto& t) {
+  best::vec<best::row<int, int>> entries;
+  for (int i = 0; i < 1000; ++i) { entries.push((i * 7) % 500, i); }
+
+  best::flat_map<int, int> map(std::move(entries));
+  t.expect_eq(map.size(), 500);
+  for (int i = 0; i < 500; ++i) {
+    // i * 7 % 500 first produces each key for i < 500.
+    t.expect_eq(map.get((i * 7) % 500), i);
+  }
+
+  auto span = map.entries();
+  for (size_t i = 1; i < span.size(); ++i) {
+    t.expect_lt(span[i - 1].first(), span[i].first());
+  }
+};
+
+best::test InsertAll = [](auto& t) {
+  best::flat_map<int, int> map = {{1, 1}, {3, 3}, {5, 5}};
+
+  // Interleaved with the existing keys; the last occurrence of each key in
+  // the batch wins, and replaces what was already there.
+  best::vec<best::row<int, int>> batch;
+  batch.push(4, 4);
+  batch.push(3, 30);
+  batch.push(0, 0);
+  batch.push(3, 300);
+  map.insert_all(std::move(batch));
+
+  t.expect_eq(map.size(), 5);
+  t.expect_eq(map.get(0), 0);
+  t.expect_eq(map.get(1), 1);
+  t.expect_eq(map.get(3), 300);
+  t.expect_eq(map.get(4), 4);
+  t.expect_eq(map.get(5), 5);
+
+  // Entirely after the existing keys.
+  batch.clear();
+  batch.push(7, 7);
+  batch.push(6, 6);
+  map.insert_all(std::move(batch));
+
+  best::vec<int> keys;
+  for (auto [k, v] : map) { keys.push(k); }
+  t.expect_eq(keys, best::vec{0, 1, 3, 4, 5, 6, 7});
+};
+
+best::test Strings = [](auto& t) {
+  best::flat_map<best::strbuf, int> map;
+  map.insert(best::strbuf("foo"), 1);
+  map.insert(best::strbuf("bar"), 2);
+  map.insert(best::strbuf("a much longer key than the others"), 3);
+
+  t.expect_eq(map.get(best::str("foo")), 1);
+  t.expect_eq(map.get(best::str("bar")), 2);
+  t.expect_eq(map.get(best::str("a much longer key than the others")), 3);
+  t.expect_eq(map.get(best::str("baz")), best::none);
+  t.expect_eq(map.remove(best::str("foo")), 1);
+  t.expect(!map.contains(best::str("foo")));
+};
+
+best::test CopyMove = [](auto& t) {
+  best::flat_map<int, int> map = {{1, 2}, {3, 4}};
+
+  auto map2 = map;
+  t.expect_eq(map2.size(), 2);
+  t.expect_eq(map2.get(3), 4);
+  t.expect(map == map2);
+
+  auto map3 = std::move(map);
+  t.expect_eq(map3.get(1), 2);
+  t.expect(map.is_empty());
+
+  map = map3;
+  t.expect_eq(map.get(1), 2);
+};
+
+best::test Leaky = [](auto& t) {
+  LeakTest l_(t);
+
+  using Bubble = LeakTest::Bubble;
+
+  best::flat_map<int, Bubble> x0;
+  for (int i = 0; i < 100; ++i) { x0.get_or_insert(i); }
+  for (int i = 0; i < 50; ++i) { x0.remove(i); }
+  x0.insert(0, Bubble());
+
+  best::vec<best::row<int, Bubble>> batch;
+  for (int i = 0; i < 100; i += 3) { batch.push(i, Bubble()); }
+  x0.insert_all(std::move(batch));
+
+  auto x1 = x0;
+  auto x2 = std::move(x0);
+  x2 = x1;
+  x2 = std::move(x1);
+  x2.clear();
+  x2.get_or_insert(1);
+};
+}  // namespace best::flat_map_test
@@ -0,0 +1,197 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_FLAT_SET_H_
+#define BEST_CONTAINER_FLAT_SET_H_
+
+#include <cstddef>
+#include <initializer_list>
+
+#include "best/base/ord.h"
+#include "best/container/internal/flat.h"
+#include "best/container/option.h"
+#include "best/container/result.h"
+#include "best/container/vec.h"
+#include "best/memory/allocator.h"
+#include "best/memory/span.h"
+#include "best/meta/init.h"
+
+//! Sorted sets.
+//!
+//! `best::flat_set<K>` is an ordered set stored as a sorted vector, with the
+//! same design as `best::flat_map`.
+
+namespace best {
+/// # `best::flat_set<K>`
+///
+/// A set of unique keys of type `K`, stored as a sorted `best::vec`. See
+/// `best::flat_map` for details on its design.
+template <best::relocatable K, best::allocator A = best::malloc>
+  requires best::comparable<K>
+class flat_set final {
+ public:
+  /// Helper type aliases.
+  using key_type = K;
+
+  /// # `flat_set::alloc`
+  ///
+  /// This set's allocator type, which may be a reference.
+  using alloc = A;
+
+  /// # `flat_set::flat_set()`
+  ///
+  /// Constructs an empty set using the given allocator. An empty set does not
+  /// allocate.
+  flat_set() : flat_set(alloc{}) {}
+  explicit flat_set(alloc alloc) : keys_(std::move(alloc)) {}
+
+  /// # `flat_set::flat_set(vec)`
+  ///
+  /// Constructs a set out of a vector of keys, in any order, reusing its
+  /// buffer. Repeated keys are ignored.
+  explicit flat_set(best::vec<K, 0, alloc> keys) : keys_(std::move(keys)) {
+    flat_internal::sort_unique(keys_, key_of, /*keep_last=*/false);
+  }
+
+  /// # `flat_set::flat_set{...}`
+  ///
+  /// Constructs a set via initializer list. Repeated keys are ignored.
+  flat_set(std::initializer_list<K> keys)
+    requires best::constructible<alloc> && best::copyable<K>
+    : flat_set(best::vec<K, 0, alloc>(keys)) {}
+
+  /// # `flat_set::flat_set(flat_set)`
+  ///
+  /// Sets are copyable if their keys are.
+  flat_set(const flat_set&) = default;
+  flat_set& operator=(const flat_set&) = default;
+  flat_set(flat_set&&) = default;
+  flat_set& operator=(flat_set&&) = default;
+
+  /// # `flat_set::size()`, `flat_set::is_empty()`
+  ///
+  /// Returns the number of keys in this set, or whether it has none.
+  size_t size() const { return keys_.size(); }
+  bool is_empty() const { return size() == 0; }
+
+  /// # `flat_set::capacity()`
+  ///
+  /// Returns the number of keys this set can hold before it must grow.
+  size_t capacity() const { return keys_.capacity(); }
+
+  /// # `flat_set::allocator()`
+  ///
+  /// Returns a reference to this set's allocator.
+  best::as_ref<const alloc> allocator() const { return keys_.allocator(); }
+  best::as_ref<alloc> allocator() { return keys_.allocator(); }
+
+  /// # `flat_set::as_span()`
+  ///
+  /// Returns the keys of this set, in sorted order.
+  best::span<const K> as_span() const { return keys_; }
+
+  /// # `flat_set::get()`
+  ///
+  /// Looks up the copy of `key` in this set, if there is one.
+  template <typename Q = K>
+  best::option<const K&> get(const Q& key) const
+    requires best::comparable<K, Q>
+  {
+    auto idx = find(key).ok();
+    if (!idx) { return best::none; }
+    return keys_[*idx];
+  }
+
+  /// # `flat_set::contains()`
+  ///
+  /// Returns whether this set contains `key`.
+  template <typename Q = K>
+  bool contains(const Q& key) const requires best::comparable<K, Q>
+  {
+    return find(key).is_ok();
+  }
+
+  /// # `flat_set::insert()`
+  ///
+  /// Inserts a key into this set. Returns whether the key was not already
+  /// present; if it was, the set is unchanged.
+  bool insert(K key) {
+    auto found = find(key);
+    if (found.is_ok()) { return false; }
+    keys_.insert(*found.err(), std::move(key));
+    return true;
+  }
+
+  /// # `flat_set::insert_all()`
+  ///
+  /// Inserts a batch of keys into this set. This sorts the batch once and
+  /// merges it into the set in linear time.
+  void insert_all(best::vec<K, 0, alloc> keys) {
+    flat_internal::sort_unique(keys, key_of, /*keep_last=*/false);
+    flat_internal::merge(keys_, std::move(keys), key_of);
+  }
+
+  /// # `flat_set::remove()`
+  ///
+  /// Removes `key` from this set, returning it, if it was present.
+  template <typename Q = K>
+  best::option<K> remove(const Q& key) requires best::comparable<K, Q>
+  {
+    auto idx = find(key).ok();
+    if (!idx) { return best::none; }
+    return keys_.remove(*idx);
+  }
+
+  /// # `flat_set::reserve()`
+  ///
+  /// Ensures that `count` more keys can be inserted without the set growing.
+  void reserve(size_t count) { keys_.reserve(count); }
+
+  /// # `flat_set::clear()`
+  ///
+  /// Removes every key from this set. This does not free any memory.
+  void clear() { keys_.clear(); }
+
+  /// # `flat_set::iter()`, `flat_set::begin()`, `flat_set::end()`
+  ///
+  /// Sets are iterable exactly how you'd expect, in sorted order.
+  auto iter() const { return as_span().iter(); }
+  auto begin() const { return as_span().begin(); }
+  auto end() const { return as_span().end(); }
+
+  /// # `flat_set::operator==`
+  ///
+  /// Sets are equal if they have the same keys.
+  bool operator==(const flat_set& that) const {
+    return as_span() == that.as_span();
+  }
+
+ private:
+  static const K& key_of(const K& k) { return k; }
+
+  template <typename Q>
+  best::result<size_t, size_t> find(const Q& key) const {
+    return keys_->bisect(key, key_of);
+  }
+
+  best::vec<K, 0, alloc> keys_;
+};
+}  // namespace best
+
+#endif  // BEST_CONTAINER_FLAT_SET_H_
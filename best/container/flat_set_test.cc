@@ -0,0 +1,69 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/container/flat_set.h"
+
+#include "best/test/test.h"
+#include "best/text/str.h"
+#include "best/text/strbuf.h"
+
+namespace best::flat_set_test {
+best::test Empty = [](auto& t) {
+  best::flat_set<int> empty;
+  t.expect(empty.is_empty());
+  t.expect_eq(empty.size(), 0);
+  t.expect_eq(empty.get(42), best::none);
+  t.expect(!empty.contains(42));
+  t.expect_eq(empty.remove(42), best::none);
+};
+
+best::test InsertRemove = [](auto& t) {
+  best::flat_set<int> set;
+  for (int i = 99; i >= 0; --i) { t.expect(set.insert(i)); }
+  t.expect(!set.insert(42));
+  t.expect_eq(set.size(), 100);
+
+  for (int i = 0; i < 100; ++i) { t.expect(set.contains(i)); }
+  t.expect(!set.contains(100));
+
+  t.expect_eq(set.remove(42), 42);
+  t.expect_eq(set.remove(42), best::none);
+  t.expect_eq(set.size(), 99);
+};
+
+best::test Sorted = [](auto& t) {
+  best::flat_set<int> set = {5, 1, 3, 1, 5};
+  t.expect_eq(set.size(), 3);
+  t.expect_eq(set.as_span(), best::span{1, 3, 5});
+
+  best::vec<int> batch = {6, 2, 3, 0, 2};
+  set.insert_all(std::move(batch));
+  t.expect_eq(set.as_span(), best::span{0, 1, 2, 3, 5, 6});
+  t.expect(set == best::flat_set<int>{6, 5, 3, 2, 1, 0});
+};
+
+best::test Strings = [](auto& t) {
+  best::flat_set<best::strbuf> set = {best::strbuf("foo"),
+                                      best::strbuf("bar")};
+  t.expect(set.contains(best::str("foo")));
+  t.expect(set.contains(best::str("bar")));
+  t.expect(!set.contains(best::str("baz")));
+  t.expect_eq(set.get(best::str("foo")), "foo");
+};
+}  // namespace best::flat_set_test
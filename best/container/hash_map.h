@@ -0,0 +1,318 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_HASH_MAP_H_
+#define BEST_CONTAINER_HASH_MAP_H_
+
+#include <cstddef>
+#include <initializer_list>
+
+#include "best/base/ord.h"
+#include "best/container/internal/swiss.h"
+#include "best/container/option.h"
+#include "best/container/row.h"
+#include "best/hash/hash.h"
+#include "best/iter/iter.h"
+#include "best/memory/allocator.h"
+#include "best/meta/init.h"
+
+//! Hash maps.
+//!
+//! `best::hash_map<K, V>` is an unordered associative container, implemented
+//! as a swiss table: an open-addressing table whose probes examine a whole
+//! group of slots at once, using SIMD instructions where available.
+
+namespace best {
+/// # `best::hash_map<K, V>`
+///
+/// A hash table mapping keys of type `K` to values of type `V`. This is the
+/// `best` `std::unordered_map`, although its design is that of Abseil's
+/// `absl::flat_hash_map`: entries are stored inline in a single array, so
+/// pointers to entries are invalidated whenever the map grows.
+///
+/// Keys are hashed with `best::hash()`. Lookup functions are generic over the
+/// type of the key being looked up, so that, for example, a map with
+/// `best::strbuf` keys can be queried with a `best::str`.
+///
+/// Entries are relocated (which, for most types, means `memcpy`'d) when the
+/// map grows, rather than rehashed in place.
+template <best::relocatable K, best::relocatable V,
+          best::allocator A = best::malloc>
+  requires best::hashable<K> && best::equatable<K>
+class hash_map final {
+ public:
+  /// Helper type aliases.
+  using key_type = K;
+  using value_type = V;
+
+  /// # `hash_map::alloc`
+  ///
+  /// This map's allocator type, which may be a reference.
+  using alloc = A;
+
+  /// # `hash_map::hash_map()`
+  ///
+  /// Constructs an empty map using the given allocator. An empty map does not
+  /// allocate.
+  hash_map() : hash_map(alloc{}) {}
+  explicit hash_map(alloc alloc) : table_(std::move(alloc)) {}
+
+  /// # `hash_map::hash_map{...}`
+  ///
+  /// Constructs a map via initializer list. If a key is repeated, the first
+  /// occurrence wins.
+  hash_map(std::initializer_list<best::row<K, V>> entries)
+    requires best::constructible<alloc> && best::copyable<K> &&
+             best::copyable<V>
+    : hash_map(alloc{}) {
+    reserve(entries.size());
+    for (const auto& entry : entries) {
+      get_or_insert(entry.first(), entry.second());
+    }
+  }
+
+  /// # `hash_map::hash_map(hash_map)`
+  ///
+  /// Maps are copyable if their keys and values are.
+  hash_map(const hash_map&) = default;
+  hash_map& operator=(const hash_map&) = default;
+  hash_map(hash_map&&) = default;
+  hash_map& operator=(hash_map&&) = default;
+
+  /// # `hash_map::size()`, `hash_map::is_empty()`
+  ///
+  /// Returns the number of entries in this map, or whether it has none.
+  size_t size() const { return table_.size(); }
+  bool is_empty() const { return size() == 0; }
+
+  /// # `hash_map::capacity()`
+  ///
+  /// Returns the number of slots this map has allocated. Because maps are
+  /// never allowed to fill up completely, this is greater than the number of
+  /// entries that fit before the map must grow.
+  size_t capacity() const { return table_.capacity(); }
+
+  /// # `hash_map::allocator()`
+  ///
+  /// Returns a reference to this map's allocator.
+  best::as_ref<const alloc> allocator() const { return table_.allocator(); }
+  best::as_ref<alloc> allocator() { return table_.allocator(); }
+
+  /// # `hash_map::get()`
+  ///
+  /// Looks up the value for `key`, if there is one.
+  ///
+  /// `key` may be of any type that is `best::hash_compatible` with `K`, such as
+  /// a `best::str` or a string literal when `K` is `best::strbuf`.
+  template <typename Q = K>
+  best::option<const V&> get(const Q& key) const
+    requires best::hash_compatible<Q, K>;
+  template <typename Q = K>
+  best::option<V&> get(const Q& key)
+    requires best::hash_compatible<Q, K>;
+
+  /// # `hash_map::contains()`
+  ///
+  /// Returns whether this map has an entry for `key`.
+  template <typename Q = K>
+  bool contains(const Q& key) const
+    requires best::hash_compatible<Q, K>
+  {
+    return get(key).has_value();
+  }
+
+  /// # `hash_map::insert()`
+  ///
+  /// Inserts a new entry into this map. If there already was an entry for
+  /// `key`, its value is replaced, and the old value is returned.
+  best::option<V> insert(K key, V value);
+
+  /// # `hash_map::get_or_insert()`
+  ///
+  /// Returns the value for `key`. If there is no such value, one is
+  /// constructed from `args` and inserted.
+  V& get_or_insert(K key, auto&&... args)
+    requires best::constructible<V, decltype(args)&&...>;
+
+  /// # `hash_map::remove()`
+  ///
+  /// Removes the entry for `key`, returning its value, if there was one.
+  template <typename Q = K>
+  best::option<V> remove(const Q& key)
+    requires best::hash_compatible<Q, K>;
+
+  /// # `hash_map::reserve()`
+  ///
+  /// Ensures that `count` more entries can be inserted without the map
+  /// growing.
+  void reserve(size_t count) { table_.reserve(count, rehash); }
+
+  /// # `hash_map::clear()`
+  ///
+  /// Removes every entry from this map. This does not free any memory.
+  void clear() { table_.clear(); }
+
+  /// # `hash_map::iterator`
+  ///
+  /// This map's iterator types. They yield rows of a key and a value
+  /// reference, in an unspecified order.
+  template <typename E>
+  class iter_impl;
+  using iterator = best::iter<iter_impl<V>>;
+  using const_iterator = best::iter<iter_impl<const V>>;
+
+  /// # `hash_map::iter()`, `hash_map::begin()`, `hash_map::end()`
+  ///
+  /// Maps are iterable exactly how you'd expect.
+  const_iterator iter() const {
+    return const_iterator(iter_impl<const V>(&table_));
+  }
+  iterator iter() { return iterator(iter_impl<V>(&table_)); }
+  auto begin() const { return iter().into_range(); }
+  auto end() const { return best::iter_range_end{}; }
+  auto begin() { return iter().into_range(); }
+  auto end() { return best::iter_range_end{}; }
+
+ private:
+  using slot = best::row<K, V>;
+  using table = swiss_internal::table<slot, A>;
+
+  static uint64_t rehash(const slot& s) {
+    return best::hash(s.first());
+  }
+
+  table table_;
+};
+
+/// # `best::hash_map::iter_impl`
+///
+/// The iterator implementation for `best::hash_map`.
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::hashable<K> && best::equatable<K>
+template <typename E>
+class hash_map<K, V, A>::iter_impl final {
+ public:
+  using BestIterArrow = void;
+
+ private:
+  friend hash_map;
+  friend best::iter<iter_impl>;
+  friend best::iter<iter_impl&>;
+
+  explicit iter_impl(const table* table)
+    : table_(table), left_(table->size()) {}
+
+  best::option<best::row<const K&, E&>> next() {
+    for (; left_ > 0; ++idx_) {
+      if (!table_->is_full(idx_)) { continue; }
+
+      --left_;
+      auto& s = *table_->slot(idx_++);
+      return best::row<const K&, E&>(s.first(), s.second());
+    }
+    return best::none;
+  }
+
+  best::size_hint size_hint() const { return {left_, left_}; }
+
+  size_t count() && { return left_; }
+
+  const table* table_;
+  size_t idx_ = 0;
+  size_t left_;
+};
+}  // namespace best
+
+/* ////////////////////////////////////////////////////////////////////////// *\
+ * ////////////////// !!! IMPLEMENTATION DETAILS BELOW !!! ////////////////// *
+\* ////////////////////////////////////////////////////////////////////////// */
+
+namespace best {
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::hashable<K> && best::equatable<K>
+template <typename Q>
+best::option<const V&> hash_map<K, V, A>::get(const Q& key) const
+  requires best::hash_compatible<Q, K>
+{
+  auto idx = table_.find(best::hash(key),
+                         [&](const slot& s) { return s.first() == key; });
+  if (!idx) { return best::none; }
+  return table_.slot(*idx)->second();
+}
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::hashable<K> && best::equatable<K>
+template <typename Q>
+best::option<V&> hash_map<K, V, A>::get(const Q& key)
+  requires best::hash_compatible<Q, K>
+{
+  auto idx = table_.find(best::hash(key),
+                         [&](const slot& s) { return s.first() == key; });
+  if (!idx) { return best::none; }
+  return table_.slot(*idx)->second();
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::hashable<K> && best::equatable<K>
+best::option<V> hash_map<K, V, A>::insert(K key, V value) {
+  auto [idx, inserted] =
+    table_.insert(best::hash(key),
+                  [&](const slot& s) { return s.first() == key; }, rehash);
+  auto ptr = table_.slot(idx);
+  if (inserted) {
+    ptr.construct(std::move(key), std::move(value));
+    return best::none;
+  }
+
+  V old = std::move(ptr->second());
+  ptr->second() = std::move(value);
+  return old;
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::hashable<K> && best::equatable<K>
+V& hash_map<K, V, A>::get_or_insert(K key, auto&&... args)
+  requires best::constructible<V, decltype(args)&&...>
+{
+  auto [idx, inserted] =
+    table_.insert(best::hash(key),
+                  [&](const slot& s) { return s.first() == key; }, rehash);
+  auto ptr = table_.slot(idx);
+  if (inserted) {
+    ptr.construct(std::move(key), V(BEST_FWD(args)...));
+  }
+  return ptr->second();
+}
+
+template <best::relocatable K, best::relocatable V, best::allocator A>
+  requires best::hashable<K> && best::equatable<K>
+template <typename Q>
+best::option<V> hash_map<K, V, A>::remove(const Q& key)
+  requires best::hash_compatible<Q, K>
+{
+  auto idx = table_.find(best::hash(key),
+                         [&](const slot& s) { return s.first() == key; });
+  if (!idx) { return best::none; }
+
+  V value = std::move(table_.slot(*idx)->second());
+  table_.erase(*idx);
+  return value;
+}
+}  // namespace best
+
+#endif  // BEST_CONTAINER_HASH_MAP_H_
@@ -0,0 +1,157 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/container/hash_map.h"
+
+#include "best/test/fodder.h"
+#include "best/test/test.h"
+#include "best/text/str.h"
+#include "best/text/strbuf.h"
+
+namespace best::hash_map_test {
+using ::best_fodder::LeakTest;
+
+best::test Empty = [](auto& t) {
+  best::hash_map<int, int> empty;
+  t.expect(empty.is_empty());
+  t.expect_eq(empty.size(), 0);
+  t.expect_eq(empty.capacity(), 0);
+  t.expect_eq(empty.get(42), best::none);
+  t.expect(!empty.contains(42));
+  t.expect_eq(empty.remove(42), best::none);
+};
+
+best::test InsertGet = [](auto& t) {
+  best::hash_map<int, int> map;
+  for (int i = 0; i < 1000; ++i) {
+    t.expect_eq(map.insert(i, i * i), best::none);
+  }
+  t.expect_eq(map.size(), 1000);
+
+  for (int i = 0; i < 1000; ++i) { t.expect_eq(map.get(i), i * i); }
+  t.expect_eq(map.get(1000), best::none);
+  t.expect_eq(map.get(-1), best::none);
+
+  t.expect_eq(map.insert(5, 0), 25);
+  t.expect_eq(map.get(5), 0);
+  t.expect_eq(map.size(), 1000);
+
+  *map.get(6) = 7;
+  t.expect_eq(map.get(6), 7);
+
+  map.get_or_insert(6, 100) += 1;
+  t.expect_eq(map.get(6), 8);
+  map.get_or_insert(-6, 100) += 1;
+  t.expect_eq(map.get(-6), 101);
+};
+
+best::test Remove = [](auto& t) {
+  best::hash_map<int, int> map;
+  for (int i = 0; i < 100; ++i) { map.insert(i, -i); }
+
+  // Churn through many more keys than the map can hold, so that the table has
+  // to reclaim its tombstones rather than growing without bound.
+  size_t cap = map.capacity();
+  for (int i = 100; i < 10000; ++i) {
+    map.insert(i, -i);
+    t.expect_eq(map.remove(i - 100), -(i - 100));
+  }
+  t.expect_eq(map.size(), 100);
+  t.expect_le(map.capacity(), cap * 2);
+
+  for (int i = 0; i < 9900; ++i) { t.expect(!map.contains(i)); }
+  for (int i = 9900; i < 10000; ++i) { t.expect_eq(map.get(i), -i); }
+};
+
+best::test Iter = [](auto& t) {
+  best::hash_map<int, int> map = {{1, 2}, {3, 4}, {5, 6}, {1, 0}};
+  t.expect_eq(map.size(), 3);
+  t.expect_eq(map.get(1), 2);
+
+  int keys = 0, values = 0;
+  for (auto [k, v] : map) {
+    keys += k;
+    values += v;
+  }
+  t.expect_eq(keys, 9);
+  t.expect_eq(values, 12);
+  t.expect_eq(map.iter().count(), 3);
+
+  for (auto [k, v] : map) { v *= 10; }
+  t.expect_eq(map.get(3), 40);
+};
+
+best::test Strings = [](auto& t) {
+  best::hash_map<best::strbuf, int> map;
+  map.insert(best::strbuf("foo"), 1);
+  map.insert(best::strbuf("bar"), 2);
+  map.insert(best::strbuf("a much longer key than the others"), 3);
+
+  t.expect_eq(map.get(best::str("foo")), 1);
+  t.expect_eq(map.get(best::str("bar")), 2);
+  t.expect_eq(map.get(best::str("a much longer key than the others")), 3);
+  t.expect_eq(map.get(best::str("baz")), best::none);
+
+  // Literals and C strings hash like the keys they spell.
+  const char* bar = "bar";
+  t.expect_eq(map.get("foo"), 1);
+  t.expect_eq(map.get(bar), 2);
+  t.expect(!map.contains("baz"));
+  t.expect_eq(map.remove("foo"), 1);
+  t.expect(!map.contains(best::str("foo")));
+
+  static_assert(best::hash_compatible<best::str, best::strbuf>);
+  static_assert(best::hash_compatible<char[4], best::strbuf>);
+  static_assert(best::hash_compatible<const char*, best::strbuf>);
+  static_assert(!best::hash_compatible<const char16_t*, best::strbuf>);
+};
+
+best::test CopyMove = [](auto& t) {
+  best::hash_map<int, int> map = {{1, 2}, {3, 4}};
+
+  auto map2 = map;
+  t.expect_eq(map2.size(), 2);
+  t.expect_eq(map2.get(3), 4);
+
+  auto map3 = std::move(map);
+  t.expect_eq(map3.get(1), 2);
+  t.expect(map.is_empty());
+
+  map = map3;
+  t.expect_eq(map.get(1), 2);
+};
+
+best::test Leaky = [](auto& t) {
+  LeakTest l_(t);
+
+  using Bubble = LeakTest::Bubble;
+
+  best::hash_map<int, Bubble> x0;
+  for (int i = 0; i < 100; ++i) { x0.get_or_insert(i); }
+  for (int i = 0; i < 50; ++i) { x0.remove(i); }
+  x0.insert(0, Bubble());
+
+  auto x1 = x0;
+  auto x2 = std::move(x0);
+  x2 = x1;
+  x2 = std::move(x1);
+  x2.clear();
+  x2.get_or_insert(1);
+};
+}  // namespace best::hash_map_test
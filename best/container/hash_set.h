@@ -0,0 +1,221 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_HASH_SET_H_
+#define BEST_CONTAINER_HASH_SET_H_
+
+#include <cstddef>
+#include <initializer_list>
+
+#include "best/base/ord.h"
+#include "best/container/internal/swiss.h"
+#include "best/container/option.h"
+#include "best/hash/hash.h"
+#include "best/iter/iter.h"
+#include "best/memory/allocator.h"
+#include "best/meta/init.h"
+
+//! Hash sets.
+//!
+//! `best::hash_set<K>` is an unordered set, implemented with the same swiss
+//! table as `best::hash_map`.
+
+namespace best {
+/// # `best::hash_set<K>`
+///
+/// A hash table of unique keys of type `K`. This is the `best`
+/// `std::unordered_set`; see `best::hash_map` for details on its design.
+template <best::relocatable K, best::allocator A = best::malloc>
+  requires best::hashable<K> && best::equatable<K>
+class hash_set final {
+ public:
+  /// Helper type aliases.
+  using key_type = K;
+
+  /// # `hash_set::alloc`
+  ///
+  /// This set's allocator type, which may be a reference.
+  using alloc = A;
+
+  /// # `hash_set::hash_set()`
+  ///
+  /// Constructs an empty set using the given allocator. An empty set does not
+  /// allocate.
+  hash_set() : hash_set(alloc{}) {}
+  explicit hash_set(alloc alloc) : table_(std::move(alloc)) {}
+
+  /// # `hash_set::hash_set{...}`
+  ///
+  /// Constructs a set via initializer list. Repeated keys are ignored.
+  hash_set(std::initializer_list<K> keys)
+    requires best::constructible<alloc> && best::copyable<K>
+    : hash_set(alloc{}) {
+    reserve(keys.size());
+    for (const auto& key : keys) { insert(key); }
+  }
+
+  /// # `hash_set::hash_set(hash_set)`
+  ///
+  /// Sets are copyable if their keys are.
+  hash_set(const hash_set&) = default;
+  hash_set& operator=(const hash_set&) = default;
+  hash_set(hash_set&&) = default;
+  hash_set& operator=(hash_set&&) = default;
+
+  /// # `hash_set::size()`, `hash_set::is_empty()`
+  ///
+  /// Returns the number of keys in this set, or whether it has none.
+  size_t size() const { return table_.size(); }
+  bool is_empty() const { return size() == 0; }
+
+  /// # `hash_set::capacity()`
+  ///
+  /// Returns the number of slots this set has allocated.
+  size_t capacity() const { return table_.capacity(); }
+
+  /// # `hash_set::allocator()`
+  ///
+  /// Returns a reference to this set's allocator.
+  best::as_ref<const alloc> allocator() const { return table_.allocator(); }
+  best::as_ref<alloc> allocator() { return table_.allocator(); }
+
+  /// # `hash_set::get()`
+  ///
+  /// Looks up the key equal to `key`, if there is one.
+  ///
+  /// `key` may be of any type that is `best::hash_compatible` with `K`, such as
+  /// a `best::str` or a string literal when `K` is `best::strbuf`.
+  template <typename Q = K>
+  best::option<const K&> get(const Q& key) const
+    requires best::hash_compatible<Q, K>
+  {
+    auto idx = table_.find(best::hash(key),
+                           [&](const K& k) { return k == key; });
+    if (!idx) { return best::none; }
+    return *table_.slot(*idx);
+  }
+
+  /// # `hash_set::contains()`
+  ///
+  /// Returns whether this set contains `key`.
+  template <typename Q = K>
+  bool contains(const Q& key) const
+    requires best::hash_compatible<Q, K>
+  {
+    return get(key).has_value();
+  }
+
+  /// # `hash_set::insert()`
+  ///
+  /// Inserts `key` into this set. Returns false if it was already present, in
+  /// which case the set is unchanged.
+  bool insert(K key) {
+    auto [idx, inserted] =
+      table_.insert(best::hash(key),
+                    [&](const K& k) { return k == key; }, rehash);
+    if (inserted) { table_.slot(idx).construct(std::move(key)); }
+    return inserted;
+  }
+
+  /// # `hash_set::remove()`
+  ///
+  /// Removes the key equal to `key` from this set, returning it, if there was
+  /// one.
+  template <typename Q = K>
+  best::option<K> remove(const Q& key)
+    requires best::hash_compatible<Q, K>
+  {
+    auto idx = table_.find(best::hash(key),
+                           [&](const K& k) { return k == key; });
+    if (!idx) { return best::none; }
+
+    K removed = std::move(*table_.slot(*idx));
+    table_.erase(*idx);
+    return removed;
+  }
+
+  /// # `hash_set::reserve()`
+  ///
+  /// Ensures that `count` more keys can be inserted without the set growing.
+  void reserve(size_t count) { table_.reserve(count, rehash); }
+
+  /// # `hash_set::clear()`
+  ///
+  /// Removes every key from this set. This does not free any memory.
+  void clear() { table_.clear(); }
+
+  /// # `hash_set::iterator`
+  ///
+  /// This set's iterator type. It yields the keys in an unspecified order.
+  class iter_impl;
+  using iterator = best::iter<iter_impl>;
+
+  /// # `hash_set::iter()`, `hash_set::begin()`, `hash_set::end()`
+  ///
+  /// Sets are iterable exactly how you'd expect.
+  iterator iter() const { return iterator(iter_impl(&table_)); }
+  auto begin() const { return iter().into_range(); }
+  auto end() const { return best::iter_range_end{}; }
+
+ private:
+  using table = swiss_internal::table<K, A>;
+
+  static uint64_t rehash(const K& k) { return best::hash(k); }
+
+  table table_;
+};
+
+/// # `best::hash_set::iter_impl`
+///
+/// The iterator implementation for `best::hash_set`.
+template <best::relocatable K, best::allocator A>
+  requires best::hashable<K> && best::equatable<K>
+class hash_set<K, A>::iter_impl final {
+ public:
+  using BestIterArrow = void;
+
+ private:
+  friend hash_set;
+  friend best::iter<iter_impl>;
+  friend best::iter<iter_impl&>;
+
+  explicit iter_impl(const table* table)
+    : table_(table), left_(table->size()) {}
+
+  best::option<const K&> next() {
+    for (; left_ > 0; ++idx_) {
+      if (!table_->is_full(idx_)) { continue; }
+
+      --left_;
+      return *table_->slot(idx_++);
+    }
+    return best::none;
+  }
+
+  best::size_hint size_hint() const { return {left_, left_}; }
+
+  size_t count() && { return left_; }
+
+  const table* table_;
+  size_t idx_ = 0;
+  size_t left_;
+};
+}  // namespace best
+
+#endif  // BEST_CONTAINER_HASH_SET_H_
@@ -0,0 +1,85 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/container/hash_set.h"
+
+#include "best/test/test.h"
+#include "best/text/format.h"
+#include "best/text/str.h"
+#include "best/text/strbuf.h"
+
+namespace best::hash_set_test {
+best::test Empty = [](auto& t) {
+  best::hash_set<int> empty;
+  t.expect(empty.is_empty());
+  t.expect_eq(empty.capacity(), 0);
+  t.expect(!empty.contains(0));
+  t.expect_eq(empty.remove(0), best::none);
+};
+
+best::test InsertRemove = [](auto& t) {
+  best::hash_set<int> set;
+  for (int i = 0; i < 1000; i += 2) { t.expect(set.insert(i)); }
+  for (int i = 0; i < 1000; i += 2) { t.expect(!set.insert(i)); }
+  t.expect_eq(set.size(), 500);
+
+  for (int i = 0; i < 1000; ++i) { t.expect_eq(set.contains(i), i % 2 == 0); }
+
+  t.expect_eq(set.remove(10), 10);
+  t.expect_eq(set.remove(10), best::none);
+  t.expect(!set.contains(10));
+  t.expect_eq(set.size(), 499);
+
+  set.clear();
+  t.expect(set.is_empty());
+  t.expect(!set.contains(0));
+};
+
+best::test Iter = [](auto& t) {
+  best::hash_set<int> set = {1, 2, 3, 2, 1};
+  t.expect_eq(set.size(), 3);
+
+  int sum = 0;
+  for (int x : set) { sum += x; }
+  t.expect_eq(sum, 6);
+};
+
+best::test Strings = [](auto& t) {
+  best::hash_set<best::str> set = {"foo", "bar", "foo"};
+  t.expect_eq(set.size(), 2);
+  t.expect(set.contains(best::str("foo")));
+  t.expect(!set.contains(best::str("baz")));
+  t.expect(set.contains("bar"));
+  t.expect(!set.contains("baz"));
+};
+
+best::test Owned = [](auto& t) {
+  best::hash_set<best::strbuf> set;
+  for (int i = 0; i < 100; ++i) {
+    set.insert(best::format("a string long enough to spill: {}", i));
+  }
+  for (int i = 0; i < 100; i += 3) {
+    set.remove(best::format("a string long enough to spill: {}", i));
+  }
+  t.expect_eq(set.size(), 66);
+
+  auto copy = set;
+  t.expect_eq(copy.size(), 66);
+};
+}  // namespace best::hash_set_test
@@ -0,0 +1,309 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_INLINE_DYN_H_
+#define BEST_CONTAINER_INLINE_DYN_H_
+
+#include <cstddef>
+#include <cstring>
+
+#include "best/base/hint.h"
+#include "best/base/niche.h"
+#include "best/base/ord.h"
+#include "best/base/tags.h"
+#include "best/container/object.h"
+#include "best/container/option.h"
+#include "best/func/dyn.h"
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+#include "best/memory/ptr.h"
+#include "best/meta/init.h"
+
+//! Small-buffer-optimized polymorphic values.
+//!
+//! `best::inline_dyn<I, N>` is an owning `best::dyn<I>`, like
+//! `best::dynbox<I>`, except that implementers which fit in `N` bytes are
+//! stored inline, right next to the itable pointer. Only values that are too
+//! big (or that cannot be relocated with `memcpy`) are spilled to the heap.
+//!
+//! ```
+//! best::inline_dyn<Handler> h = MyHandler{...};  // No allocation.
+//! h->handle(event);
+//! ```
+
+namespace best {
+/// # `best::inline_dyn<I, N>`
+///
+/// An owning, type-erased value implementing `I`, stored inline when it is at
+/// most `N` bytes.
+///
+/// A value is stored inline if it fits in the buffer (including alignment,
+/// which may be at most that of a pointer) and it is trivially relocatable.
+/// Otherwise, it is allocated using `A`, and the buffer holds the pointer to
+/// it. Because of this, `inline_dyn` is itself always trivially relocatable:
+/// moving one is a `memcpy()`, regardless of what it holds.
+///
+/// Unlike `best::dyn`, `inline_dyn` only supports a single interface.
+template <best::interface I, size_t N = 2 * sizeof(void*),
+          typename A = best::malloc>
+  requires (N >= sizeof(void*))
+class BEST_RELOCATABLE inline_dyn final {
+ public:
+  /// # `inline_dyn::type`
+  ///
+  /// The `best::dyn` type this is an owning version of.
+  using type = best::dyn<I>;
+
+  /// # `inline_dyn::ptr`
+  ///
+  /// The pointer type for this `inline_dyn`.
+  using ptr = best::ptr<type>;
+
+  /// # `inline_dyn::pointee`, `inline_dyn::meta`
+  ///
+  /// The pointer component types for this `inline_dyn`.
+  using pointee = ptr::pointee;
+  using metadata = ptr::metadata;
+
+  /// # `inline_dyn::alloc`
+  ///
+  /// The allocator used for values that do not fit inline.
+  using alloc = A;
+
+  /// # `inline_dyn::Capacity`
+  ///
+  /// The size of the inline buffer.
+  static constexpr size_t Capacity = N;
+
+  /// # `inline_dyn::fits_inline<T>`
+  ///
+  /// Whether a value of type `T` will be stored inline.
+  template <typename T>
+  static constexpr bool fits_inline =
+    sizeof(T) <= N && alignof(T) <= alignof(void*) &&
+    best::relocatable<T, best::trivially>;
+
+  /// # `inline_dyn::inline_dyn(value)`
+  ///
+  /// Type-erases `value`, by moving or copying it into a new `inline_dyn`.
+  template <typename T>
+  constexpr inline_dyn(T&& value)
+    requires best::constructible<alloc> &&
+             best::implements<best::as_auto<T>, I> &&
+             (!best::same<best::as_auto<T>, inline_dyn>)
+    : inline_dyn(alloc{}, BEST_FWD(value)) {}
+  template <typename T>
+  constexpr inline_dyn(alloc alloc, T&& value)
+    requires best::implements<best::as_auto<T>, I> &&
+             (!best::same<best::as_auto<T>, inline_dyn>);
+
+  /// # `inline_dyn::inline_dyn(inline_dyn)`
+  ///
+  /// Trivially relocatable. `inline_dyn`s cannot be copied with a copy
+  /// constructor, because the type they hold may not be copyable. Use
+  /// `try_copy()` instead.
+  constexpr inline_dyn(const inline_dyn&) = delete;
+  constexpr inline_dyn& operator=(const inline_dyn&) = delete;
+  constexpr inline_dyn(inline_dyn&& that) requires best::moveable<alloc>;
+  constexpr inline_dyn& operator=(inline_dyn&& that)
+    requires best::moveable<alloc>;
+
+  /// # `inline_dyn::~inline_dyn()`
+  ///
+  /// Destroys the held value, and frees it if it was spilled to the heap.
+  constexpr ~inline_dyn();
+
+  /// # `inline_dyn::is_inline()`
+  ///
+  /// Returns whether the held value is stored inline.
+  constexpr bool is_inline() const { return !spilled_; }
+
+  /// # `inline_dyn::as_ptr()`
+  ///
+  /// Returns a `best::dynptr` to the held value.
+  constexpr ptr as_ptr() const { return ptr{data(), vt_}; }
+
+  /// # `inline_dyn::allocator()`
+  ///
+  /// Returns a reference to this `inline_dyn`'s allocator.
+  constexpr const alloc& allocator() const { return *alloc_; }
+  constexpr alloc& allocator() { return *alloc_; }
+
+  /// # `inline_dyn::layout()`
+  ///
+  /// Returns the layout of the held value.
+  constexpr best::layout layout() const { return vt_->layout(); }
+
+  /// # `inline_dyn::try_copy()`
+  ///
+  /// Returns a copy of this `inline_dyn`, if the held value is copyable at
+  /// runtime. A moved-from `inline_dyn` holds nothing to copy, so this
+  /// returns `best::none` for it.
+  constexpr best::option<inline_dyn> try_copy() const
+    requires best::copyable<alloc>;
+
+  /// # `inline_dyn::operator->`, `inline_dyn[best::types<I>]`
+  ///
+  /// Accesses the interface's functions. Like `best::box`, this preserves the
+  /// constness of the `inline_dyn`.
+  constexpr auto operator->() const { return as_ptr().as_const().operator->(); }
+  constexpr auto operator->() { return as_ptr().operator->(); }
+  template <typename J>
+  constexpr auto operator[](best::tlist<J> j) const
+    requires requires { as_ptr().as_const()[j]; }
+  {
+    return as_ptr().as_const()[j];
+  }
+  template <typename J>
+  constexpr auto operator[](best::tlist<J> j)
+    requires requires { as_ptr()[j]; }
+  {
+    return as_ptr()[j];
+  }
+
+  template <typename U>
+  constexpr operator best::ptr<U>() const requires requires {
+    { as_ptr().as_const() } -> best::converts_to<best::ptr<U>>;
+  }
+  {
+    return as_ptr().as_const();
+  }
+  template <typename U>
+  constexpr operator best::ptr<U>() requires requires {
+    { as_ptr() } -> best::converts_to<best::ptr<U>>;
+  }
+  {
+    return as_ptr();
+  }
+
+  constexpr explicit inline_dyn(niche) {}
+  constexpr bool operator==(niche) const { return vt_ == nullptr; }
+
+ private:
+  // Sets up storage for a value described by `vt`, allocating it if
+  // `spilled`, and returns a pointer to it.
+  constexpr void* emplace(metadata vt, bool spilled);
+
+  // Destroys the held value, if any, and frees its storage.
+  constexpr void release();
+
+  constexpr void* data() const {
+    if (spilled_) { return heap_; }
+    return const_cast<char*>(buf_);
+  }
+
+  constexpr explicit inline_dyn(best::in_place_t, const alloc& alloc)
+    : alloc_(best::in_place, alloc) {}
+
+  union {
+    alignas(void*) char buf_[N];
+    void* heap_;
+  };
+  metadata vt_ = nullptr;
+  bool spilled_ = false;
+  [[no_unique_address]] best::object<alloc> alloc_;
+};
+}  // namespace best
+
+/* ////////////////////////////////////////////////////////////////////////// *\
+ * ////////////////// !!! IMPLEMENTATION DETAILS BELOW !!! ////////////////// *
+\* ////////////////////////////////////////////////////////////////////////// */
+
+namespace best {
+template <best::interface I, size_t N, typename A>
+  requires (N >= sizeof(void*))
+template <typename T>
+constexpr inline_dyn<I, N, A>::inline_dyn(alloc alloc, T&& value)
+  requires best::implements<best::as_auto<T>, I> &&
+           (!best::same<best::as_auto<T>, inline_dyn>)
+  : alloc_(best::in_place, BEST_FWD(alloc)) {
+  using U = best::as_auto<T>;
+  auto* dst = emplace(&best::itable<best::un_const<I>>::of(best::types<U>),
+                      !fits_inline<U>);
+  new (dst) U(BEST_FWD(value));
+}
+
+template <best::interface I, size_t N, typename A>
+  requires (N >= sizeof(void*))
+constexpr inline_dyn<I, N, A>::inline_dyn(inline_dyn&& that)
+  requires best::moveable<alloc>
+  : vt_(std::exchange(that.vt_, nullptr)),
+    spilled_(std::exchange(that.spilled_, false)),
+    alloc_(BEST_MOVE(that.alloc_)) {
+  // Both inline values and the heap pointer are trivially relocatable, so
+  // there is no need to consult the itable here.
+  std::memcpy(buf_, that.buf_, N);
+}
+
+template <best::interface I, size_t N, typename A>
+  requires (N >= sizeof(void*))
+constexpr inline_dyn<I, N, A>& inline_dyn<I, N, A>::operator=(
+  inline_dyn&& that) requires best::moveable<alloc>
+{
+  if (best::equal(this, &that)) { return *this; }
+  release();
+  vt_ = std::exchange(that.vt_, nullptr);
+  spilled_ = std::exchange(that.spilled_, false);
+  alloc_ = BEST_MOVE(that.alloc_);
+  std::memcpy(buf_, that.buf_, N);
+  return *this;
+}
+
+template <best::interface I, size_t N, typename A>
+  requires (N >= sizeof(void*))
+constexpr inline_dyn<I, N, A>::~inline_dyn() {
+  release();
+}
+
+template <best::interface I, size_t N, typename A>
+  requires (N >= sizeof(void*))
+constexpr void inline_dyn<I, N, A>::release() {
+  if (vt_ == nullptr) { return; }
+
+  vt_->destroy(data());
+  if (spilled_) { allocator().dealloc(heap_, vt_->layout()); }
+  vt_ = nullptr;
+  spilled_ = false;
+}
+
+template <best::interface I, size_t N, typename A>
+  requires (N >= sizeof(void*))
+constexpr best::option<inline_dyn<I, N, A>> inline_dyn<I, N, A>::try_copy()
+  const requires best::copyable<A>
+{
+  if (vt_ == nullptr || !vt_->can_copy()) { return best::none; }
+
+  inline_dyn copy(best::in_place, allocator());
+  vt_->copy(copy.emplace(vt_, spilled_), data());
+  return copy;
+}
+
+template <best::interface I, size_t N, typename A>
+  requires (N >= sizeof(void*))
+constexpr void* inline_dyn<I, N, A>::emplace(metadata vt, bool spilled) {
+  vt_ = vt;
+  spilled_ = spilled;
+  if (!spilled) { return buf_; }
+
+  heap_ = allocator().alloc(vt->layout()).raw();
+  return heap_;
+}
+}  // namespace best
+
+#endif  // BEST_CONTAINER_INLINE_DYN_H_
@@ -0,0 +1,160 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/container/inline_dyn.h"
+
+#include "best/test/fodder.h"
+#include "best/test/test.h"
+
+namespace best::inline_dyn_test {
+using ::best_fodder::LeakTest;
+
+class Counter : public best::interface_base<Counter> {
+ public:
+  BEST_INTERFACE(Counter,                //
+                 (int, get, (), const),  //
+                 (void, bump, ()));
+};
+
+struct Small {
+  int value;
+
+  int get() const { return value; }
+  void bump() { ++value; }
+};
+
+struct Big {
+  int values[16] = {};
+
+  int get() const { return values[15]; }
+  void bump() { ++values[15]; }
+};
+
+// Not trivially relocatable, so it must be spilled even though it is small.
+struct Pinned {
+  Pinned(int value) : value(value) {}
+  Pinned(const Pinned& that) : value(that.value) {}
+  Pinned& operator=(const Pinned& that) {
+    value = that.value;
+    return *this;
+  }
+  ~Pinned() {}
+
+  int value;
+
+  int get() const { return value; }
+  void bump() { ++value; }
+};
+
+struct BEST_RELOCATABLE Leaky {
+  LeakTest::Bubble bubble;
+  int values[3] = {};
+
+  int get() const { return values[0]; }
+  void bump() { ++values[0]; }
+};
+
+static_assert(best::inline_dyn<Counter>::fits_inline<Small>);
+static_assert(!best::inline_dyn<Counter>::fits_inline<Big>);
+static_assert(!best::inline_dyn<Counter>::fits_inline<Pinned>);
+static_assert(best::inline_dyn<Counter, sizeof(Big)>::fits_inline<Big>);
+static_assert(best::relocatable<best::inline_dyn<Counter>, best::trivially>);
+
+best::test Inline = [](auto& t) {
+  best::inline_dyn<Counter> x = Small{41};
+  t.expect(x.is_inline());
+  x->bump();
+  t.expect_eq(x->get(), 42);
+  t.expect_eq(Counter::of(x)->get(), 42);
+
+  best::dynptr<Counter> p = x;
+  p->bump();
+  t.expect_eq(x->get(), 43);
+};
+
+best::test Spilled = [](auto& t) {
+  best::inline_dyn<Counter> x = Big{};
+  t.expect(!x.is_inline());
+  x->bump();
+  t.expect_eq(x->get(), 1);
+
+  best::inline_dyn<Counter> y = Pinned(5);
+  t.expect(!y.is_inline());
+  y->bump();
+  t.expect_eq(y->get(), 6);
+
+  best::inline_dyn<Counter, sizeof(Big)> z = Big{};
+  t.expect(z.is_inline());
+};
+
+best::test Move = [](auto& t) {
+  best::inline_dyn<Counter> x = Small{1};
+  best::inline_dyn<Counter> y = Big{};
+
+  auto x2 = BEST_MOVE(x);
+  auto y2 = BEST_MOVE(y);
+  t.expect_eq(x2->get(), 1);
+  t.expect_eq(y2->get(), 0);
+
+  x2 = BEST_MOVE(y2);
+  t.expect(!x2.is_inline());
+  t.expect_eq(x2->get(), 0);
+
+  best::option<best::inline_dyn<Counter>> o;
+  t.expect_eq(o, best::none);
+  o = BEST_MOVE(x2);
+  t.expect_eq((*o)->get(), 0);
+};
+
+best::test Copy = [](auto& t) {
+  best::inline_dyn<Counter> x = Small{1};
+  auto x2 = x.try_copy();
+  t.expect(x2.has_value());
+  (*x2)->bump();
+  t.expect_eq(x->get(), 1);
+  t.expect_eq((*x2)->get(), 2);
+
+  best::inline_dyn<Counter> y = Pinned(3);
+  auto y2 = y.try_copy();
+  t.expect(y2.has_value());
+  t.expect(!y2->is_inline());
+  (*y2)->bump();
+  t.expect_eq(y->get(), 3);
+  t.expect_eq((*y2)->get(), 4);
+
+  // A moved-from value has nothing to copy.
+  auto z = BEST_MOVE(x);
+  t.expect(!x.try_copy().has_value());
+  t.expect_eq(z->get(), 1);
+};
+
+best::test Leaks = [](auto& t) {
+  LeakTest l_(t);
+
+  best::inline_dyn<Counter> x = Leaky{};
+  best::inline_dyn<Counter, sizeof(void*)> y = Leaky{};
+  t.expect(x.is_inline());
+  t.expect(!y.is_inline());
+
+  auto x2 = x.try_copy();
+  auto y2 = y.try_copy();
+  x = BEST_MOVE(*x2);
+  y = BEST_MOVE(*y2);
+};
+}  // namespace best::inline_dyn_test
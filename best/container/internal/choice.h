@@ -23,6 +23,7 @@
 #include <array>
 #include <cstddef>
 
+#include "best/base/niche.h"
 #include "best/base/tags.h"
 #include "best/container/internal/pun.h"
 #include "best/container/object.h"
@@ -41,6 +42,13 @@ class tagged {
   template <size_t n>
   using type = decltype(types)::template type<n>;
 
+  using tag_t = best::smallest_uint_t<sizeof...(Ts)>;
+
+  // Tag values past the last alternative are spare, and can be used as niches
+  // by an enclosing choice.
+  static constexpr size_t BestNiches =
+    size_t(best::max_of<tag_t>) - sizeof...(Ts) + 1;
+
   constexpr tagged() = default;
   constexpr tagged(const tagged&) = default;
   constexpr tagged& operator=(const tagged&) = default;
@@ -52,6 +60,13 @@ class tagged {
     requires best::constructible<type<n>, Args&&...>
     : union_(best::index<n>, BEST_FWD(args)...), tag_(n) {}
 
+  constexpr explicit tagged(best::niche nh) requires (BestNiches > 0)
+    : tag_(sizeof...(Ts) + nh.index) {}
+  constexpr bool operator==(best::niche nh) const requires (BestNiches > 0)
+  {
+    return tag_ == sizeof...(Ts) + nh.index;
+  }
+
   constexpr size_t tag() const { return tag_; }
 
   template <size_t n>
@@ -64,25 +79,25 @@ class tagged {
   }
 
   best::pun<Ts...> union_;
-  best::smallest_uint_t<sizeof...(Ts)> tag_{};
+  tag_t tag_{};
 };
 
-template <size_t swap, typename Empty, typename Niched>
+// Storage for a choice with exactly one alternative, `k`, that carries data,
+// which has enough niches to encode all of the other alternatives. The `i`th
+// dataless alternative is encoded as the `i`th niche of alternative `k`, and
+// any niches left over are passed on to enclosing choices.
+template <size_t k, typename... Ts>
 class niched {
  public:
-  static constexpr auto types = best::types<Empty, Niched>;
+  static constexpr auto types = best::types<Ts...>;
   template <size_t n>
-  using type = decltype(types)::template type<swap ^ n>;
-
-  // Avoid making a one-element pun if we can avoid it.
-  static constexpr bool NeedPun = !best::destructible<Niched, trivially>;
-  static constexpr auto ctor_tag() {
-    if constexpr (NeedPun) {
-      return best::index<0>;
-    } else {
-      return best::in_place;
-    }
-  }
+  using type = decltype(types)::template type<n>;
+
+  using Niched = type<k>;
+
+  // The number of niches of `Niched` used to encode the other alternatives.
+  static constexpr size_t Used = sizeof...(Ts) - 1;
+  static constexpr size_t BestNiches = best::niche_count<Niched> - Used;
 
   constexpr niched() = default;
   constexpr niched(const niched&) = default;
@@ -90,68 +105,103 @@ class niched {
   constexpr niched(niched&&) = default;
   constexpr niched& operator=(niched&&) = default;
 
-  template <typename... Args>
-  constexpr explicit niched(best::index_t<swap ^ 0>, Args&&... args)
-    requires best::constructible<Empty, trivially, Args&&...>
-    : niched_(ctor_tag(), best::niche{}) {}
+  template <size_t n, typename... Args>
+  constexpr explicit niched(best::index_t<n>, Args&&... args)
+    requires (n != k) && best::constructible<type<n>, trivially, Args&&...>
+    : niched_(best::index<k>, best::niche{n < k ? n : n - 1}) {}
 
   template <typename... Args>
-  constexpr explicit niched(best::index_t<swap ^ 1>, Args&&... args)
+  constexpr explicit niched(best::index_t<k>, Args&&... args)
     requires best::constructible<Niched, Args&&...>
-    : niched_(ctor_tag(), BEST_FWD(args)...) {}
+    : niched_(best::index<k>, BEST_FWD(args)...) {}
+
+  constexpr explicit niched(best::niche nh) requires (BestNiches > 0)
+    : niched_(best::index<k>, best::niche{Used + nh.index}) {}
+  constexpr bool operator==(best::niche nh) const requires (BestNiches > 0)
+  {
+    return payload().is_niche(best::niche{Used + nh.index});
+  }
 
   constexpr size_t tag() const {
-    return swap ^ !get(unsafe("we're checking for the niche, so we need "
-                              "to pull out the non-empty side"),
-                       best::index<swap ^ 1>)
-                     .as_ptr()
-                     .is_niche();
+    auto p = payload();
+    size_t tag = k;
+    [&]<size_t... i>(std::index_sequence<i...>) {
+      ((p.is_niche(best::niche{i}) ? (tag = i < k ? i : i + 1, true) : false) ||
+       ...);
+    }(std::make_index_sequence<Used>{});
+    return tag;
   }
 
+  // The dataless alternatives share the union with the payload, so each choice
+  // has its own (empty) object for them without taking up any extra space.
   template <size_t n>
-  constexpr const auto& get(unsafe, best::index_t<n>) const {
-    if constexpr ((swap ^ n) == 0) {
-      return empty_;
-    } else if constexpr (NeedPun) {
-      return niched_.object(unsafe("the non-empty variant is always engaged,"
-                                   "except when after destructor runs"),
-                            index<0>);
-    } else {
-      return niched_;
-    }
+  constexpr const best::object<type<n>>& get(unsafe u,
+                                             best::index_t<n> i) const {
+    return niched_.object(u, i);
   }
   template <size_t n>
-  constexpr auto& get(unsafe, best::index_t<n>) {
-    if constexpr ((swap ^ n) == 0) {
-      return empty_;
-    } else if constexpr (NeedPun) {
-      return niched_.object(unsafe("the non-empty variant is always engaged,"
-                                   "except when after destructor runs"),
-                            index<0>);
-    } else {
-      return niched_;
-    }
+  constexpr best::object<type<n>>& get(unsafe u, best::index_t<n> i) {
+    return niched_.object(u, i);
   }
 
-  best::select<NeedPun, best::pun<Niched>, best::object<Niched>> niched_;
-  [[no_unique_address]] best::object<Empty> empty_;
+  best::pun<Ts...> niched_;
+
+ private:
+  // Returns a pointer to the data-carrying alternative, which may hold a
+  // niche.
+  constexpr auto payload() const {
+    return niched_
+      .object(unsafe("we're checking for the niche, so we need to pull out "
+                     "the non-empty side"),
+              index<k>)
+      .as_ptr();
+  }
 };
 
+// Returns the index of the unique data-carrying alternative, or -1 if there is
+// not exactly one.
 template <typename... Ts>
-tagged<Ts...> which_storage(best::tlist<Ts...>, best::rank<0>);
+constexpr size_t find_payload() {
+  if constexpr (sizeof...(Ts) < 2) {
+    return -1;
+  } else {
+    constexpr bool empty[] = {
+      (best::is_empty<Ts> && best::constructible<Ts, trivially> &&
+       best::destructible<Ts, trivially>)...};
+
+    size_t payload = -1;
+    for (size_t i = 0; i < sizeof...(Ts); ++i) {
+      if (empty[i]) { continue; }
+      if (payload != size_t(-1)) { return -1; }
+      payload = i;
+    }
+    return payload;
+  }
+}
 
-template <typename A, typename B>
-niched<1, B, A> which_storage(best::tlist<A, B>, best::rank<1>)
-  requires (has_niche<A> && best::is_empty<B> &&
-            best::constructible<B, trivially>);
+// Returns the index of the data-carrying alternative if it has enough niches
+// to encode all of the others; otherwise, returns -1.
+template <typename... Ts>
+inline constexpr size_t niche_payload = [] {
+  constexpr size_t k = find_payload<Ts...>();
+  if constexpr (k == size_t(-1)) {
+    return k;
+  } else {
+    using Payload = decltype(best::types<Ts...>)::template type<k>;
+    return best::niche_count<Payload> >= sizeof...(Ts) - 1 ? k : size_t(-1);
+  }
+}();
 
-template <typename A, typename B>
-niched<0, A, B> which_storage(best::tlist<A, B>, best::rank<2>)
-  requires (has_niche<B> && best::is_empty<A> &&
-            best::constructible<A, trivially>);
+template <typename... Ts>
+tagged<Ts...> which_storage(best::tlist<Ts...>, best::rank<0>);
+
+template <typename... Ts>
+niched<niche_payload<Ts...>, Ts...> which_storage(best::tlist<Ts...>,
+                                                  best::rank<1>)
+  requires (niche_payload<Ts...> != size_t(-1));
 
 template <typename... Ts>
-using storage = decltype(which_storage(types<Ts...>, best::rank<2>{}));
+using storage = decltype(which_storage(types<Ts...>, best::rank<1>{}));
 
 template <typename... Ts>
 class impl : public storage<Ts...> {
@@ -164,8 +214,10 @@ class impl : public storage<Ts...> {
 
   using Base = storage<Ts...>;
   using Base::Base;
+  using Base::BestNiches;
   using Base::get;
   using Base::tag;
+  using Base::operator==;
 
   constexpr impl() = default;
 
@@ -217,6 +269,7 @@ class impl : public storage<Ts...> {
   constexpr void emplace(Args&&... args) {
     if (which == tag()) {
       if constexpr (best::is_object<type<which>> &&
+                    !best::is_empty<type<which>> &&
                     best::assignable<type<which>, Args&&...>) {
         get(unsafe{"checked tag() before this"}, best::index<which>)
           .as_ptr()
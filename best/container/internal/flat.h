@@ -0,0 +1,102 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_INTERNAL_FLAT_H_
+#define BEST_CONTAINER_INTERNAL_FLAT_H_
+
+#include <cstddef>
+
+#include "best/base/ord.h"
+#include "best/memory/span_sort.h"
+
+//! Sorted-vector helpers shared by `best::flat_map` and `best::flat_set`.
+
+namespace best::flat_internal {
+// Sorts `v` by `key` and removes every run of elements with equal keys except
+// for one: the first if `keep_last` is false, the last otherwise.
+//
+// Input that is already strictly sorted (which is common, e.g. when copying
+// out of another flat container) is detected with one linear scan and skips
+// the sort entirely.
+template <typename Vec>
+void sort_unique(Vec& v, auto key, bool keep_last) {
+  size_t n = v.size();
+  if (n < 2) { return; }
+
+  bool sorted = true;
+  for (size_t i = 1; i < n; ++i) {
+    if ((key(v[i - 1]) <=> key(v[i])) >= 0) {
+      sorted = false;
+      break;
+    }
+  }
+  if (sorted) { return; }
+
+  // A stable sort keeps equal keys in insertion order, which is what makes
+  // "first wins" and "last wins" meaningful.
+  v->stable_sort(key);
+
+  size_t out = 0;
+  for (size_t i = 1; i < n; ++i) {
+    if (key(v[out]) == key(v[i])) {
+      if (keep_last) { v[out] = std::move(v[i]); }
+      continue;
+    }
+    if (++out != i) { v[out] = std::move(v[i]); }
+  }
+  v.truncate(out + 1);
+}
+
+// Merges the sorted, duplicate-free `batch` into the sorted, duplicate-free
+// `v`. Where both have an element with the same key, the one in `batch` wins.
+template <typename Vec>
+void merge(Vec& v, Vec batch, auto key) {
+  if (batch.is_empty()) { return; }
+  if (v.is_empty()) {
+    v = std::move(batch);
+    return;
+  }
+
+  // Fast path: the whole batch sorts after the existing elements, so it can
+  // be appended without shuffling anything.
+  if ((key(*v.last()) <=> key(*batch.first())) < 0) {
+    v.reserve(batch.size());
+    for (auto& e : batch) { v.push(std::move(e)); }
+    return;
+  }
+
+  Vec out(v.allocator());
+  out.reserve(v.size() + batch.size());
+  size_t i = 0, j = 0;
+  while (i < v.size() && j < batch.size()) {
+    auto ord = key(v[i]) <=> key(batch[j]);
+    if (ord < 0) {
+      out.push(std::move(v[i++]));
+      continue;
+    }
+    if (ord == 0) { ++i; }
+    out.push(std::move(batch[j++]));
+  }
+  for (; i < v.size(); ++i) { out.push(std::move(v[i])); }
+  for (; j < batch.size(); ++j) { out.push(std::move(batch[j])); }
+  v = std::move(out);
+}
+}  // namespace best::flat_internal
+
+#endif  // BEST_CONTAINER_INTERNAL_FLAT_H_
@@ -20,9 +20,11 @@
 #ifndef BEST_CONTAINER_INTERNAL_ROW_H_
 #define BEST_CONTAINER_INTERNAL_ROW_H_
 
+#include <array>
 #include <utility>
 
 #include "best/container/object.h"
+#include "best/memory/layout.h"
 #include "best/meta/internal/tlist.h"
 #include "best/meta/tlist.h"
 
@@ -56,6 +58,52 @@ struct elem {
   [[no_unique_address]] best::object<T> value;
 };
 
+/// The indices of `Elems`, sorted by descending alignment, with ties broken by
+/// index. Laying values out in this order never produces more padding than
+/// declaration order does, and usually produces none at all (aside from tail
+/// padding).
+template <typename... Elems>
+inline constexpr auto align_order = [] {
+  constexpr size_t n = sizeof...(Elems);
+  std::array<size_t, n> order{}, align = {best::align_of<Elems>...};
+  for (size_t i = 0; i < n; ++i) { order[i] = i; }
+
+  // Insertion sort, which is stable, and n is small.
+  for (size_t i = 1; i < n; ++i) {
+    for (size_t j = i; j > 0 && align[order[j - 1]] < align[order[j]]; --j) {
+      std::swap(order[j - 1], order[j]);
+    }
+  }
+  return order;
+}();
+
+/// The order in which the elements of a row are laid out in memory, which is
+/// `align_order`.
+///
+/// Rows with two or fewer elements are always laid out in declaration order,
+/// since reordering cannot make them any smaller.
+template <typename... Elems>
+inline constexpr auto layout_order = [] {
+  constexpr size_t n = sizeof...(Elems);
+  if constexpr (n <= 2) {
+    std::array<size_t, n> order{};
+    for (size_t i = 0; i < n; ++i) { order[i] = i; }
+    return order;
+  } else {
+    return align_order<Elems...>;
+  }
+}();
+
+/// A tag carrying `layout_order` as a pack, for constructing a row's elements
+/// in the order that they are laid out.
+template <size_t...>
+struct ordered final {};
+template <typename... Elems>
+inline constexpr auto in_layout_order =
+  []<size_t... i>(std::index_sequence<i...>) {
+    return ordered<layout_order<Elems...>[i]...>{};
+  }(std::index_sequence_for<Elems...>{});
+
 template <typename, typename...>
 struct impl;
 
@@ -89,9 +137,13 @@ struct impl<I, A, B> {
   [[no_unique_address]] best::object<B> x1;
 };
 
+template <size_t i, typename... Elems>
+using nth_elem = elem<i, typename best::tlist<Elems...>::template type<i>>;
+
 template <size_t... i, typename... Elems>
 requires (sizeof...(i) > 2)
-struct impl<const best::vlist<i...>, Elems...> : elem<i, Elems>... {
+struct impl<const best::vlist<i...>, Elems...>
+  : nth_elem<layout_order<Elems...>[i], Elems...>... {
   template <size_t j>
   constexpr const auto& get_impl(best::index_t<j>) const {
     using T = best::tlist<Elems...>::template type<j>;
@@ -120,8 +172,21 @@ constexpr decltype(auto) object_call(auto&& cb, auto&& obj) {
   }
 }
 
-// See tlist_internal::slice_impl().
+// Selects the `n`th argument out of a pack, without recursion.
 using ::best::tlist_internal::splat;
+template <size_t... i>
+constexpr auto make_picker(std::index_sequence<i...>) {
+  return []<splat<i>... prefix>(prefix&&..., auto&& arg,
+                                auto&&...) -> decltype(auto) {
+    return BEST_FWD(arg);
+  };
+}
+template <size_t n>
+constexpr decltype(auto) pick(auto&&... args) {
+  return make_picker(std::make_index_sequence<n>{})(BEST_FWD(args)...);
+}
+
+// See tlist_internal::slice_impl().
 template <typename Out, size_t... i, size_t... j, size_t... k>
 constexpr auto make_slicer(std::index_sequence<i...>, std::index_sequence<j...>,
                            std::index_sequence<k...>) {
@@ -0,0 +1,95 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_INTERNAL_SOA_VEC_H_
+#define BEST_CONTAINER_INTERNAL_SOA_VEC_H_
+
+#include <array>
+#include <cstddef>
+
+#include "best/container/row.h"
+#include "best/memory/layout.h"
+#include "best/meta/reflect.h"
+#include "best/meta/tlist.h"
+
+//! Internal implementation of best::soa_vec.
+
+namespace best::soa_vec_internal {
+/// The column types of a row or a reflected struct, as a tlist.
+template <typename T>
+inline constexpr auto columns = [] {
+  if constexpr (best::is_row<T>) {
+    return T::types;
+  } else {
+    return best::reflect<T>.apply(
+      [](auto... f) { return best::types<typename decltype(f)::type...>; });
+  }
+}();
+
+/// Splits a row or reflected struct into a row of references to its columns.
+constexpr auto split(auto&& value) {
+  if constexpr (best::is_row<decltype(value)>) {
+    return BEST_FWD(value).as_ref();
+  } else {
+    return best::fields(BEST_FWD(value));
+  }
+}
+
+/// Static information about a set of columns.
+template <typename... Cols>
+struct info final {
+  using row = best::row<Cols...>;
+  using ref = best::row<Cols&...>;
+  using cref = best::row<const Cols&...>;
+
+  /// The alignment of the whole buffer, and the number of bytes each element
+  /// contributes to it.
+  static constexpr size_t Align = best::layout::of_struct<Cols...>().align();
+  static constexpr size_t Stride = (0 + ... + best::size_of<Cols>);
+
+  /// The layout of a single element, as reported to the growth policy.
+  static constexpr best::layout Elem = best::layout::of_struct<Cols...>();
+
+  /// The offset of each column from the start of the buffer, in units of the
+  /// capacity.
+  ///
+  /// Columns are placed in order of descending alignment. Because each column
+  /// is a whole number of elements, and every element size is a multiple of its
+  /// alignment, this means that every column starts out aligned, no matter
+  /// what the capacity is.
+  static constexpr auto Offsets = [] {
+    constexpr size_t n = sizeof...(Cols);
+    constexpr auto order = row_internal::align_order<Cols...>;
+    std::array<size_t, n> offsets{};
+    std::array<size_t, n> size = {best::size_of<Cols>...};
+
+    size_t offset = 0;
+    for (size_t i = 0; i < n; ++i) {
+      offsets[order[i]] = offset;
+      offset += size[order[i]];
+    }
+    return offsets;
+  }();
+};
+
+template <typename T>
+using info_of = decltype(columns<T>.template apply<info>());
+}  // namespace best::soa_vec_internal
+
+#endif  // BEST_CONTAINER_INTERNAL_SOA_VEC_H_
@@ -0,0 +1,366 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_INTERNAL_SWISS_H_
+#define BEST_CONTAINER_INTERNAL_SWISS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "best/container/object.h"
+#include "best/container/option.h"
+#include "best/container/row.h"
+#include "best/math/bit.h"
+#include "best/math/int.h"
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+#include "best/memory/ptr.h"
+#include "best/meta/init.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//! The swiss table shared by `best::hash_map` and `best::hash_set`.
+//!
+//! A swiss table is an open-addressing hash table with one byte of metadata
+//! (a "control byte") per slot. Probing loads a whole group of control bytes
+//! at once and matches them against the key's hash in parallel, using SSE2
+//! where available and SWAR (SIMD-within-a-register) otherwise.
+
+namespace best::swiss_internal {
+// Control bytes. A full slot's control byte is the low seven bits of its
+// hash (its "H2"); all other slots have one of the negative values below.
+inline constexpr int8_t Empty = -128;  // 0b1000'0000
+inline constexpr int8_t Deleted = -2;  // 0b1111'1110
+
+inline bool is_full(int8_t ctrl) { return ctrl >= 0; }
+
+// Splits a hash into the part used to pick a starting group ("H1") and the
+// part stored in the control byte ("H2").
+inline size_t h1(uint64_t hash) { return hash >> 7; }
+inline int8_t h2(uint64_t hash) { return static_cast<int8_t>(hash & 0x7f); }
+
+// A set of slots within a group, as returned by group::match*().
+class bitmask final {
+ public:
+#if defined(__SSE2__)
+  using word = uint32_t;
+  static constexpr uint32_t Shift = 0;  // One bit per slot.
+#else
+  using word = uint64_t;
+  static constexpr uint32_t Shift = 3;  // The high bit of each byte.
+#endif
+
+  explicit bitmask(word bits) : bits_(bits) {}
+
+  explicit operator bool() const { return bits_ != 0; }
+
+  // Returns the offset of the first slot in this mask.
+  size_t lowest() const { return best::trailing_zeros(bits_) >> Shift; }
+
+  // Removes the first slot from this mask.
+  void pop() { bits_ &= bits_ - 1; }
+
+ private:
+  word bits_;
+};
+
+// A group of consecutive control bytes, which are probed in parallel.
+class group final {
+ public:
+#if defined(__SSE2__)
+  static constexpr size_t Size = 16;
+
+  explicit group(const int8_t* ctrl)
+    : ctrl_(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+  bitmask match(int8_t h2) const {
+    return bitmask(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_, _mm_set1_epi8(h2))));
+  }
+  bitmask match_empty() const {
+    return bitmask(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl_, _mm_set1_epi8(Empty))));
+  }
+  bitmask match_empty_or_deleted() const {
+    // These are exactly the control bytes with their sign bit set.
+    return bitmask(_mm_movemask_epi8(ctrl_));
+  }
+
+ private:
+  __m128i ctrl_;
+#else
+  static constexpr size_t Size = 8;
+
+  explicit group(const int8_t* ctrl) {
+    // Assemble the word explicitly, so that the first control byte is always
+    // the least significant byte; this compiles to a plain load on
+    // little-endian targets.
+    for (size_t i = 0; i < Size; ++i) {
+      ctrl_ |= uint64_t(uint8_t(ctrl[i])) << (i * 8);
+    }
+  }
+
+  bitmask match(int8_t h2) const {
+    // This may produce false positives, which is fine, because every match is
+    // followed by a key comparison.
+    uint64_t x = ctrl_ ^ (Lsbs * uint8_t(h2));
+    return bitmask((x - Lsbs) & ~x & Msbs);
+  }
+  bitmask match_empty() const {
+    // Empty is the only special value with bit 1 clear.
+    return bitmask(ctrl_ & ~(ctrl_ << 6) & Msbs);
+  }
+  bitmask match_empty_or_deleted() const { return bitmask(ctrl_ & Msbs); }
+
+ private:
+  static constexpr uint64_t Lsbs = 0x0101010101010101;
+  static constexpr uint64_t Msbs = 0x8080808080808080;
+
+  uint64_t ctrl_ = 0;
+#endif
+};
+
+// The raw table underlying best::hash_map and best::hash_set. It knows
+// nothing about keys; callers provide hashes (computed with best::hash()) and
+// equality predicates.
+//
+// The table's memory is a single allocation, which contains `cap_` slots
+// followed by `cap_ + group::Size` control bytes. The last `group::Size`
+// control bytes mirror the first ones, so that a group can be loaded starting
+// at any slot without wrapping around.
+template <best::relocatable Slot, best::allocator A>
+class table final {
+ public:
+  static constexpr size_t MinCapacity = 16;
+  static_assert(MinCapacity >= group::Size);
+
+  explicit table(A alloc) : alloc_(best::in_place, std::move(alloc)) {}
+
+  table(const table& that) requires best::copyable<Slot> && best::copyable<A>
+    : alloc_(that.alloc_) {
+    copy_from(that);
+  }
+  table& operator=(const table& that)
+    requires best::copyable<Slot> && best::copyable<A>
+  {
+    if (best::equal(this, &that)) { return *this; }
+    destroy();
+    copy_from(that);
+    return *this;
+  }
+
+  table(table&& that) : alloc_(std::move(that.alloc_)) { steal(that); }
+  table& operator=(table&& that) {
+    if (best::equal(this, &that)) { return *this; }
+    destroy();
+    alloc_ = std::move(that.alloc_);
+    steal(that);
+    return *this;
+  }
+
+  ~table() { destroy(); }
+
+  size_t size() const { return size_; }
+  size_t capacity() const { return cap_; }
+  best::as_ref<const A> allocator() const { return *alloc_; }
+  best::as_ref<A> allocator() { return *alloc_; }
+
+  // Returns the slot at `idx`, which is only initialized if is_full(idx).
+  best::ptr<Slot> slot(size_t idx) const { return slots_ + idx; }
+  bool is_full(size_t idx) const { return swiss_internal::is_full(ctrl_[idx]); }
+
+  // Finds the index of a full slot for which `eq` returns true.
+  best::option<size_t> find(uint64_t hash, auto&& eq) const {
+    if (cap_ == 0) { return best::none; }
+
+    size_t mask = cap_ - 1;
+    size_t pos = h1(hash) & mask;
+    for (size_t stride = group::Size;; stride += group::Size) {
+      group g(ctrl_ + pos);
+      for (auto m = g.match(h2(hash)); m; m.pop()) {
+        size_t idx = (pos + m.lowest()) & mask;
+        if (eq(*(slots_ + idx))) { return idx; }
+      }
+
+      // An empty slot terminates the probe sequence, since an insertion of
+      // the key we're looking for would have stopped there.
+      if (g.match_empty()) { return best::none; }
+      pos = (pos + stride) & mask;
+    }
+  }
+
+  // Finds the slot for a key with the given hash. If `eq` matches a full slot,
+  // returns its index and false. Otherwise, claims a free slot and returns its
+  // index and true; the caller must then construct the slot.
+  //
+  // If the table needs to grow, `rehash` is used to recompute the hash of each
+  // slot.
+  best::row<size_t, bool> insert(uint64_t hash, auto&& eq, auto&& rehash) {
+    if (auto idx = find(hash, eq)) { return {*idx, false}; }
+
+    if (growth_left_ == 0) {
+      // If much of the table is tombstones, rehashing at the same capacity is
+      // enough to make room.
+      size_t new_cap = best::max(cap_ * 2, MinCapacity);
+      if (size_ < max_size(cap_) / 2) { new_cap = cap_; }
+      resize(new_cap, rehash);
+    }
+
+    size_t idx = find_free(hash);
+    if (ctrl_[idx] == Empty) { --growth_left_; }
+    set_ctrl(idx, h2(hash));
+    ++size_;
+    return {idx, true};
+  }
+
+  // Destroys the full slot at `idx`, and marks it as deleted.
+  void erase(size_t idx) {
+    (slots_ + idx).destroy();
+    set_ctrl(idx, Deleted);
+    --size_;
+  }
+
+  // Ensures that `count` more elements can be inserted without rehashing.
+  void reserve(size_t count, auto&& rehash) {
+    if (count <= growth_left_) { return; }
+
+    size_t new_cap = MinCapacity;
+    while (max_size(new_cap) < size_ + count) { new_cap *= 2; }
+    resize(new_cap, rehash);
+  }
+
+  // Destroys every slot, without freeing memory.
+  void clear() {
+    if (cap_ == 0) { return; }
+    if (!best::destructible<Slot, trivially>) {
+      for (size_t i = 0; i < cap_; ++i) {
+        if (is_full(i)) { (slots_ + i).destroy(); }
+      }
+    }
+
+    std::memset(ctrl_, Empty, cap_ + group::Size);
+    size_ = 0;
+    growth_left_ = max_size(cap_);
+  }
+
+ private:
+  // The maximum number of elements a table of the given capacity may hold,
+  // which keeps the load factor at or below 7/8.
+  static size_t max_size(size_t cap) { return cap - cap / 8; }
+
+  static best::layout layout_for(size_t cap) {
+    size_t align = best::align_of<Slot>;
+    size_t size = cap * best::size_of<Slot> + cap + group::Size;
+    return best::layout(unsafe("rounded up to the alignment of Slot"),
+                        (size + align - 1) & ~(align - 1), align);
+  }
+
+  void set_ctrl(size_t idx, int8_t ctrl) {
+    ctrl_[idx] = ctrl;
+    if (idx < group::Size) { ctrl_[cap_ + idx] = ctrl; }
+  }
+
+  // Finds the first empty or deleted slot in the probe sequence for `hash`.
+  size_t find_free(uint64_t hash) const {
+    size_t mask = cap_ - 1;
+    size_t pos = h1(hash) & mask;
+    for (size_t stride = group::Size;; stride += group::Size) {
+      if (auto m = group(ctrl_ + pos).match_empty_or_deleted()) {
+        return (pos + m.lowest()) & mask;
+      }
+      pos = (pos + stride) & mask;
+    }
+  }
+
+  void allocate(size_t cap) {
+    auto mem = alloc_->alloc(layout_for(cap));
+    slots_ = mem.cast(best::types<Slot>);
+    ctrl_ = reinterpret_cast<int8_t*>(mem.raw()) + cap * best::size_of<Slot>;
+    std::memset(ctrl_, Empty, cap + group::Size);
+    cap_ = cap;
+  }
+
+  // Moves every slot into a fresh allocation of the given capacity, dropping
+  // any tombstones.
+  void resize(size_t new_cap, auto&& rehash) {
+    auto old_slots = slots_;
+    auto old_ctrl = ctrl_;
+    size_t old_cap = cap_;
+
+    allocate(new_cap);
+    growth_left_ = max_size(new_cap) - size_;
+    for (size_t i = 0; i < old_cap; ++i) {
+      if (!swiss_internal::is_full(old_ctrl[i])) { continue; }
+
+      uint64_t hash = rehash(*(old_slots + i));
+      size_t idx = find_free(hash);
+      set_ctrl(idx, h2(hash));
+      // For trivially relocatable slots, this is a memcpy().
+      (slots_ + idx).relo(old_slots + i);
+    }
+
+    if (old_cap > 0) { alloc_->dealloc(old_slots, layout_for(old_cap)); }
+  }
+
+  void copy_from(const table& that) {
+    if (that.cap_ == 0) { return; }
+
+    allocate(that.cap_);
+    std::memcpy(ctrl_, that.ctrl_, cap_ + group::Size);
+    for (size_t i = 0; i < cap_; ++i) {
+      if (is_full(i)) { (slots_ + i).copy(that.slots_ + i); }
+    }
+    size_ = that.size_;
+    growth_left_ = that.growth_left_;
+  }
+
+  void steal(table& that) {
+    slots_ = that.slots_;
+    ctrl_ = that.ctrl_;
+    cap_ = that.cap_;
+    size_ = that.size_;
+    growth_left_ = that.growth_left_;
+
+    that.slots_ = nullptr;
+    that.ctrl_ = nullptr;
+    that.cap_ = that.size_ = that.growth_left_ = 0;
+  }
+
+  void destroy() {
+    clear();
+    if (cap_ > 0) { alloc_->dealloc(slots_, layout_for(cap_)); }
+
+    slots_ = nullptr;
+    ctrl_ = nullptr;
+    cap_ = size_ = growth_left_ = 0;
+  }
+
+  best::object<A> alloc_;
+  best::ptr<Slot> slots_ = nullptr;
+  int8_t* ctrl_ = nullptr;
+  size_t cap_ = 0;
+  size_t size_ = 0;
+  size_t growth_left_ = 0;
+};
+}  // namespace best::swiss_internal
+
+#endif  // BEST_CONTAINER_INTERNAL_SWISS_H_
@@ -0,0 +1,115 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_INTERNAL_VEC_H_
+#define BEST_CONTAINER_INTERNAL_VEC_H_
+
+#include <cstddef>
+#include <cstring>
+
+#include "best/base/port.h"
+#include "best/math/int.h"
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+
+//! Internal implementation of best::vec.
+//!
+//! Most of what `best::vec` does to its buffer is independent of the element
+//! type, as long as elements can be moved with `memcpy()`. The functions in
+//! this file implement that for trivially relocatable element types, taking
+//! the element layout as a runtime argument, so that every such `best::vec`
+//! with the same allocator shares one copy of them.
+
+namespace best::vec_internal {
+// A heap buffer: a pointer and a capacity, in elements.
+struct buffer final {
+  void* data;
+  size_t capacity;
+};
+
+// The type-independent state of a vector that `core` operates on.
+struct state final {
+  best::layout elem;  // The layout of a single element.
+  void* data;         // The current buffer, either inline or on the heap.
+  size_t capacity;    // The current capacity.
+  size_t size;        // The current number of elements.
+  bool on_heap;       // Whether `data` came from the allocator.
+};
+
+template <typename A>
+struct core final {
+  // Moves `st`'s elements into a heap buffer with room for `new_cap`
+  // elements, leaving `gap_len` uninitialized slots at index `gap_at`, and
+  // freeing the old buffer if it was on the heap. This is `vec::regrow()` for
+  // trivially relocatable types.
+  BEST_INLINE_NEVER static buffer regrow(A& alloc, const state& st,
+                                         size_t new_cap, bool exact,
+                                         size_t gap_at, size_t gap_len);
+};
+
+template <typename A>
+buffer core<A>::regrow(A& alloc, const state& st, size_t new_cap, bool exact,
+                       size_t gap_at, size_t gap_len) {
+  auto array = [&](size_t n) {
+    return best::layout(unsafe("this is the layout of an array of n elements, "
+                               "whose size is a multiple of its alignment"),
+                        st.elem.size() * n, st.elem.align());
+  };
+  auto capacity_of = [&](const best::allocation& a) {
+    if (exact) { return new_cap; }
+    return best::max(new_cap, a.size / st.elem.size());
+  };
+
+  char* old_data = static_cast<char*>(st.data);
+  size_t prefix = gap_at * st.elem.size();
+  size_t tail = (st.size - gap_at) * st.elem.size();
+  size_t gap = gap_len * st.elem.size();
+
+  auto old_layout = array(st.capacity);
+  auto new_layout = array(new_cap);
+
+  if (st.on_heap) {
+    if (best::grow_in_place(alloc, old_data, old_layout, new_layout)) {
+      if (gap > 0 && tail > 0) {
+        std::memmove(old_data + prefix + gap, old_data + prefix, tail);
+      }
+      return {old_data, new_cap};
+    }
+
+    if (gap == 0 || tail == 0) {
+      auto grown =
+        best::realloc_at_least(alloc, old_data, old_layout, new_layout);
+      return {grown.ptr.raw(), capacity_of(grown)};
+    }
+  }
+
+  auto fresh = best::alloc_at_least(alloc, new_layout);
+  char* new_data = static_cast<char*>(fresh.ptr.raw());
+  std::memcpy(new_data, old_data, prefix);
+  std::memcpy(new_data + prefix + gap, old_data + prefix, tail);
+  if (st.on_heap) { alloc.dealloc(old_data, old_layout); }
+
+  return {new_data, capacity_of(fresh)};
+}
+
+// The overwhelmingly common case is compiled once, in vec.cc.
+extern template struct core<best::malloc>;
+}  // namespace best::vec_internal
+
+#endif  // BEST_CONTAINER_INTERNAL_VEC_H_
@@ -105,9 +105,12 @@ class object final {
     requires best::constructible<T, Args&&...> &&
              (best::is_object<T> && !std::is_array_v<T>)
     : BEST_OBJECT_VALUE_(BEST_FWD(args)...) {}
-  constexpr explicit object(best::in_place_t, best::niche)
+  constexpr explicit object(best::in_place_t, best::niche nh)
     requires best::is_ref<T>
-    : BEST_OBJECT_VALUE_(nullptr) {}
+    : BEST_OBJECT_VALUE_(
+        nh.index == 0
+          ? nullptr
+          : reinterpret_cast<wrapped_type>(best::niche_addr(nh))) {}
 
   /// # `object::operator=()`
   ///
@@ -205,6 +208,12 @@ class object final {
     query = query.template of<T>;
   }
 
+  friend void BestHash(auto& hasher, const object& obj)
+    requires best::is_void<T> || requires { hasher.hash(*obj); }
+  {
+    if constexpr (!best::is_void<T>) { hasher.hash(*obj); }
+  }
+
  public:
   [[no_unique_address]] wrapped_type BEST_OBJECT_VALUE_;
 };
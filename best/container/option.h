@@ -680,6 +680,15 @@ class option final {
     query.requires_debug = true;
   }
 
+  friend void BestHash(auto& hasher, const option& opt)
+    requires (best::is_void<T>) || requires { hasher.hash(*opt); }
+  {
+    hasher.write(opt.has_value());
+    if constexpr (!best::is_void<T>) {
+      if (opt.has_value()) { hasher.hash(*opt); }
+    }
+  }
+
   // Conversions w/ simple_option.
  private:
   using objT = best::select<best::is_object<T>, T, best::empty>;
@@ -707,6 +716,15 @@ class option final {
                       : BEST_MOVE(*this).value();
   }
 
+  // Niches are inherited from the underlying choice.
+  static constexpr size_t BestNiches = best::choice<void, T>::BestNiches;
+  constexpr explicit option(niche nh) requires (BestNiches > 0)
+    : BEST_OPTION_IMPL_(nh) {}
+  constexpr bool operator==(niche nh) const requires (BestNiches > 0)
+  {
+    return impl() == nh;
+  }
+
   // Comparisons.
   template <best::equatable<T> U>
   constexpr bool operator==(const best::option<U>& that) const {
@@ -30,6 +30,38 @@ using ::best_fodder::LeakTest;
 static_assert(sizeof(best::option<int>) == 2 * sizeof(int));
 static_assert(sizeof(best::option<int*>) == 2 * sizeof(int*));
 static_assert(sizeof(best::option<int&>) == sizeof(int*));
+static_assert(sizeof(best::option<best::option<int>>) == 2 * sizeof(int));
+static_assert(sizeof(best::option<best::option<best::option<int>>>) ==
+              2 * sizeof(int));
+static_assert(sizeof(best::option<best::option<int&>>) == sizeof(int*));
+
+best::test Nested = [](auto& t) {
+  best::option<best::option<int>> x0;
+  best::option<best::option<int>> x1 = best::option<int>();
+  best::option<best::option<int>> x2 = best::option<int>(42);
+
+  t.expect(x0.is_empty());
+  t.expect(x1.has_value());
+  t.expect(x1->is_empty());
+  t.expect(x2.has_value());
+  t.expect_eq(**x2, 42);
+
+  x0 = x2;
+  t.expect_eq(x0, x2);
+  x2 = best::none;
+  t.expect(x2.is_empty());
+
+  int x = 5;
+  best::option<best::option<int&>> y0;
+  best::option<best::option<int&>> y1 = best::option<int&>();
+  best::option<best::option<int&>> y2 = best::option<int&>(x);
+
+  t.expect(y0.is_empty());
+  t.expect(y1.has_value());
+  t.expect(y1->is_empty());
+  t.expect(y2.has_value());
+  t.expect_eq(&**y2, &x);
+};
 
 best::test Empty = [](auto& t) {
   best::option<void> x1;
@@ -0,0 +1,404 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_RC_H_
+#define BEST_CONTAINER_RC_H_
+
+#include <atomic>
+#include <cstddef>
+
+#include "best/base/hint.h"
+#include "best/base/niche.h"
+#include "best/base/ord.h"
+#include "best/base/tags.h"
+#include "best/container/object.h"
+#include "best/func/dyn.h"
+#include "best/math/int.h"
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+#include "best/memory/ptr.h"
+#include "best/meta/init.h"
+
+//! Reference-counted pointers.
+//!
+//! `best::rc<T>` and `best::arc<T>` are shared-ownership pointers to a value on
+//! the heap, analogous to Rust's `Rc<T>` and `Arc<T>`. Unlike
+//! `std::shared_ptr`, the reference count lives in the same allocation as the
+//! value (there is no separate control block), and only `best::arc` pays for
+//! atomic operations.
+//!
+//! Like `best::box`, these are built on `best::ptr`, so they work with unsized
+//! pointees such as `best::rc<int[]>` and `best::arc<best::dyn<I>>`.
+
+namespace best {
+/// # `best::rc<T>`
+///
+/// A non-null, reference-counted pointer to a value on the heap.
+///
+/// Copying an `rc` increments the reference count; the value is destroyed when
+/// the last copy is. If `Atomic` is true, the count is maintained with atomic
+/// operations, making it safe to share copies of the `rc` across threads (see
+/// `best::arc`).
+///
+/// Like `best::box`, dereferencing an `rc` preserves its constness. Note that
+/// mutating the value through one `rc` is visible through all of its copies.
+template <typename T, typename A = best::malloc, bool Atomic = false>
+class BEST_RELOCATABLE rc final {
+ public:
+  /// # `rc::type`
+  ///
+  /// The wrapped type; `rc<T>` is nominally a `T*`.
+  using type = T;
+
+  /// # `rc::ptr`
+  ///
+  /// The pointer type for this rc.
+  using ptr = best::ptr<T>;
+
+  /// # `rc::pointee`, `rc::meta`
+  ///
+  /// The pointer component types for this rc.
+  using pointee = ptr::pointee;
+  using metadata = ptr::metadata;
+
+  /// # `rc::alloc`
+  ///
+  /// The allocator type for this rc.
+  using alloc = A;
+
+  /// # `rc::is_atomic`
+  ///
+  /// Whether this is an atomically reference-counted pointer.
+  static constexpr bool is_atomic = Atomic;
+
+  /// # `rc::rc(rc)`
+  ///
+  /// Trivially relocatable. Copies increment the reference count, and never
+  /// allocate.
+  rc(const rc& that) requires best::copyable<alloc>;
+  rc& operator=(const rc& that) requires best::copyable<alloc>;
+  rc(rc&& that) requires best::moveable<alloc>;
+  rc& operator=(rc&& that) requires best::moveable<alloc>;
+
+  /// # `rc::rc(...)`
+  ///
+  /// Constructs an rc by allocating a new value and calling a constructor
+  /// in-place. The new rc has a reference count of one.
+  explicit rc(auto&&... args)
+    requires best::constructible<alloc> &&
+             best::ptr_constructible<T, decltype(args)&&...> &&
+             (!best::same<best::as_auto<decltype(args)>, rc> && ...)
+    : rc(alloc{}, best::in_place, BEST_FWD(args)...) {}
+  template <typename U>
+  explicit rc(std::initializer_list<U> il, auto&&... args)
+    requires best::constructible<alloc> &&
+             best::ptr_constructible<T, std::initializer_list<U>,
+                                     decltype(args)&&...>
+    : rc(alloc{}, best::in_place, il, BEST_FWD(args)...) {}
+  explicit rc(best::in_place_t, auto&&... args)
+    requires best::constructible<alloc> &&
+             best::ptr_constructible<T, decltype(args)&&...>
+    : rc(alloc{}, best::in_place, BEST_FWD(args)...) {}
+  explicit rc(alloc alloc, best::in_place_t, auto&&... args)
+    requires best::ptr_constructible<T, decltype(args)&&...>;
+
+  /// # `rc::rc(rc<U>)`
+  ///
+  /// Converts an rc into an rc of a different type, such as a `best::dyn`.
+  /// The conversion must be lossless, as with `best::box`.
+  template <best::ptr_losslessly_converts_to<T> U>
+  rc(const rc<U, A, Atomic>& that) requires best::copyable<alloc>
+    : rc(rc<U, A, Atomic>(that)) {}
+  template <best::ptr_losslessly_converts_to<T> U>
+  rc(rc<U, A, Atomic>&& that) requires best::moveable<alloc>
+    : ptr_(std::exchange(that.ptr_, nullptr)),
+      alloc_(BEST_MOVE(that.alloc_)) {}
+
+  /// # `rc::~rc()`
+  ///
+  /// Decrements the reference count, destroying and freeing the value if this
+  /// was the last reference.
+  ~rc();
+
+  /// # `rc::as_ptr()`
+  ///
+  /// Returns the underlying `best::ptr`.
+  constexpr best::ptr<T> as_ptr() const { return ptr_; }
+
+  /// # `rc::allocator()`
+  ///
+  /// Returns a reference to the rc's allocator.
+  constexpr const alloc& allocator() const { return *alloc_; }
+  constexpr alloc& allocator() { return *alloc_; }
+
+  /// # `rc::raw()`, `rc::meta()`
+  ///
+  /// Returns the raw underlying pointer and its metadata.
+  constexpr pointee* raw() const { return as_ptr().raw(); }
+  constexpr metadata meta() const { return as_ptr().meta(); }
+
+  /// # `rc::layout()`,
+  ///
+  /// Returns the layout of the pointed-to value.
+  constexpr best::layout layout() const { return as_ptr().layout(); }
+
+  /// # `rc::count()`
+  ///
+  /// Returns the number of `rc`s that currently share this value.
+  ///
+  /// For an atomic `rc`, this value may be stale by the time it is observed.
+  size_t count() const;
+
+  /// # `rc::is_unique()`
+  ///
+  /// Returns whether this is the only reference to its value.
+  bool is_unique() const { return count() == 1; }
+
+  /// # `rc::shares_with()`
+  ///
+  /// Returns whether this and `that` point to the same value (as opposed to
+  /// equal values, which is what `operator==` checks).
+  bool shares_with(const rc& that) const { return raw() == that.raw(); }
+
+  /// # `rc::operator*, rc::operator->`
+  ///
+  /// Dereferences the rc. Note that rcs cannot be null!
+  constexpr decltype(auto) operator*() const { return *ptr_.as_const(); }
+  constexpr decltype(auto) operator*() { return *ptr_; }
+  constexpr auto operator->() const { return ptr_.as_const().operator->(); }
+  constexpr auto operator->() { return ptr_.operator->(); }
+
+  /// # `rc[idx]`
+  ///
+  /// If the pointee of this `rc` is indexable, this will forward to it.
+  // clang-format off
+  constexpr decltype(auto) operator[](size_t i) const requires requires { as_ptr()[i]; } { return as_ptr().as_const()[i]; }
+  constexpr decltype(auto) operator[](size_t i) requires requires { as_ptr()[i]; } { return as_ptr()[i]; }
+  constexpr decltype(auto) operator[](bounds i) const requires requires { as_ptr()[i]; } { return as_ptr().as_const()[i]; }
+  constexpr decltype(auto) operator[](bounds i) requires requires { as_ptr()[i]; } { return as_ptr()[i]; }
+  constexpr decltype(auto) operator[](auto&& i) const requires requires { as_ptr()[i]; } { return as_ptr().as_const()[i]; }
+  constexpr decltype(auto) operator[](auto&& i) requires requires { as_ptr()[i]; } { return as_ptr()[i]; }
+  // clang-format on
+
+  template <typename U>
+  constexpr operator best::ptr<U>() const requires requires {
+    { as_ptr().as_const() } -> best::converts_to<best::ptr<U>>;
+  }
+  {
+    return as_ptr().as_const();
+  }
+  template <typename U>
+  constexpr operator best::ptr<U>() requires requires {
+    { as_ptr() } -> best::converts_to<best::ptr<U>>;
+  }
+  {
+    return as_ptr();
+  }
+
+  friend void BestFmt(auto& fmt, const rc& rc) {
+    if constexpr (requires { fmt.format(*rc); }) {
+      if (fmt.current_spec().method != 'p') { fmt.format(*rc); }
+      return;
+    }
+    fmt.format(rc.as_ptr());
+  }
+  constexpr friend void BestFmtQuery(auto& query, rc*) {
+    query = query.template of<T>;
+    query.uses_method = [](auto r) {
+      if (r == 'p') { return true; }
+      auto that = best::as_auto<decltype(query)>::template of<T>.uses_method;
+      return that && that(r);
+    };
+  }
+
+  template <typename U, typename B, bool C>
+  constexpr bool operator==(const best::rc<U, B, C>& that) const
+    requires best::equatable<best::view<T>, best::view<U>>
+  {
+    return **this == *that;
+  }
+  template <best::equatable<best::view<T>> U>
+  constexpr bool operator==(const U& u) const {
+    return **this == u;
+  }
+
+  template <typename U, typename B, bool C>
+  constexpr best::order_type<best::view<T>, best::view<U>> operator<=>(
+    const best::rc<U, B, C>& that) const
+    requires best::comparable<best::view<T>, best::view<U>>
+  {
+    return **this <=> *that;
+  }
+  template <best::comparable<best::view<T>> U>
+  constexpr best::order_type<best::view<T>, U> operator<=>(const U& u) const {
+    return **this <=> u;
+  }
+
+  // A rc is never null, so null is its first niche; the rest are the
+  // niches of `best::ptr`.
+  static constexpr size_t BestNiches = ptr::BestNiches + 1;
+  constexpr explicit rc(niche nh) : ptr_(nullptr) {
+    if constexpr (BestNiches > 1) {
+      if (nh.index != 0) { ptr_ = ptr(niche{nh.index - 1}); }
+    }
+  }
+  constexpr bool operator==(niche nh) const {
+    if (nh.index == 0) { return ptr_ == nullptr; }
+    if constexpr (BestNiches > 1) { return ptr_ == niche{nh.index - 1}; }
+    return false;
+  }
+
+ private:
+  template <typename, typename, bool>
+  friend class rc;
+
+  using count_t = best::select<Atomic, std::atomic<size_t>, size_t>;
+
+  // The reference count is stored immediately before the value, so that
+  // dereferencing the rc does not need to skip over it.
+  count_t& counter() const;
+
+  // Returns the offset of the value in the allocation, and the layout of the
+  // whole allocation, given the layout of the value.
+  static size_t offset_of(best::layout value);
+  static best::layout layout_of(best::layout value);
+
+  best::ptr<T> ptr_;
+  [[no_unique_address]] best::object<alloc> alloc_;
+};
+
+template <best::is_thin T>
+rc(T&&) -> rc<best::as_auto<T>>;
+template <best::is_object T>
+rc(std::initializer_list<T>) -> rc<T[]>;
+
+/// # `best::arc<T>`
+///
+/// An atomically reference-counted pointer. This is `best::rc` with
+/// `Atomic = true`, so copies can be shared across threads.
+template <typename T, typename A = best::malloc>
+using arc = best::rc<T, A, true>;
+}  // namespace best
+
+/* ////////////////////////////////////////////////////////////////////////// *\
+ * ////////////////// !!! IMPLEMENTATION DETAILS BELOW !!! ////////////////// *
+\* ////////////////////////////////////////////////////////////////////////// */
+
+namespace best {
+template <typename T, typename A, bool Atomic>
+size_t rc<T, A, Atomic>::offset_of(best::layout value) {
+  return best::max(sizeof(count_t), value.align());
+}
+
+template <typename T, typename A, bool Atomic>
+best::layout rc<T, A, Atomic>::layout_of(best::layout value) {
+  size_t align = best::max(alignof(count_t), value.align());
+  size_t size = offset_of(value) + value.size();
+  size = (size + align - 1) & ~(align - 1);
+  return best::layout(unsafe("size was rounded up to align, which is the "
+                             "max of two powers of two"),
+                      size, align);
+}
+
+template <typename T, typename A, bool Atomic>
+auto rc<T, A, Atomic>::counter() const -> count_t& {
+  auto* value =
+    static_cast<char*>(const_cast<void*>(static_cast<const void*>(raw())));
+  return *reinterpret_cast<count_t*>(value - sizeof(count_t));
+}
+
+template <typename T, typename A, bool Atomic>
+rc<T, A, Atomic>::rc(alloc alloc, best::in_place_t, auto&&... args)
+  requires best::ptr_constructible<T, decltype(args)&&...>
+  : alloc_(best::in_place, BEST_FWD(alloc)) {
+  ptr null{nullptr, ptr::meta_for(BEST_FWD(args)...)};
+  auto value = null.layout();
+
+  char* base =
+    static_cast<char*>(allocator().alloc(layout_of(value)).raw());
+  char* data = base + offset_of(value);
+  new (data - sizeof(count_t)) count_t(1);
+
+  ptr_ = {static_cast<pointee*>(static_cast<void*>(data)), null.meta()};
+  ptr_.construct(BEST_FWD(args)...);
+}
+
+template <typename T, typename A, bool Atomic>
+rc<T, A, Atomic>::rc(const rc& that) requires best::copyable<alloc>
+  : ptr_(that.ptr_), alloc_(that.alloc_) {
+  if constexpr (Atomic) {
+    // Relaxed is sufficient: a new reference can only be created from an
+    // existing one, so there is nothing to synchronize with.
+    counter().fetch_add(1, std::memory_order_relaxed);
+  } else {
+    ++counter();
+  }
+}
+
+template <typename T, typename A, bool Atomic>
+rc<T, A, Atomic>& rc<T, A, Atomic>::operator=(const rc& that)
+  requires best::copyable<alloc>
+{
+  // Take the new reference first, in case `that` is only kept alive by the
+  // value we are about to release.
+  rc copy(that);
+  return *this = BEST_MOVE(copy);
+}
+
+template <typename T, typename A, bool Atomic>
+rc<T, A, Atomic>::rc(rc&& that) requires best::moveable<alloc>
+  : ptr_(std::exchange(that.ptr_, nullptr)), alloc_(BEST_MOVE(that.alloc_)) {}
+
+template <typename T, typename A, bool Atomic>
+rc<T, A, Atomic>& rc<T, A, Atomic>::operator=(rc&& that)
+  requires best::moveable<alloc>
+{
+  if (best::equal(this, &that)) { return *this; }
+  this->~rc();
+  return *new (this) rc(BEST_MOVE(that));
+}
+
+template <typename T, typename A, bool Atomic>
+rc<T, A, Atomic>::~rc() {
+  if (ptr_ == nullptr) { return; }
+
+  if constexpr (Atomic) {
+    if (counter().fetch_sub(1, std::memory_order_release) != 1) { return; }
+    std::atomic_thread_fence(std::memory_order_acquire);
+  } else {
+    if (--counter() != 0) { return; }
+  }
+
+  auto value = ptr_.layout();
+  char* base = reinterpret_cast<char*>(&counter() + 1) - offset_of(value);
+  ptr_.destroy();
+  allocator().dealloc(base, layout_of(value));
+}
+
+template <typename T, typename A, bool Atomic>
+size_t rc<T, A, Atomic>::count() const {
+  if constexpr (Atomic) {
+    return counter().load(std::memory_order_relaxed);
+  } else {
+    return counter();
+  }
+}
+}  // namespace best
+
+#endif  // BEST_CONTAINER_RC_H_
@@ -0,0 +1,134 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/container/rc.h"
+
+#include "best/container/option.h"
+#include "best/test/fodder.h"
+#include "best/test/test.h"
+
+namespace best::rc_test {
+using ::best_fodder::LeakTest;
+
+static_assert(sizeof(best::rc<int>) == sizeof(int*));
+static_assert(sizeof(best::arc<int>) == sizeof(int*));
+static_assert(sizeof(best::option<best::rc<int>>) == sizeof(int*));
+static_assert(sizeof(best::option<best::arc<int>>) == sizeof(int*));
+static_assert(best::relocatable<best::arc<int>, best::trivially>);
+
+class IntHolder : public best::interface_base<IntHolder> {
+ public:
+  BEST_INTERFACE(IntHolder, (int, get, (), const));
+};
+
+struct Struct {
+  int value;
+  int get() const { return value * 2; }
+};
+
+best::test Thin = [](auto& t) {
+  best::rc x0(42);
+  t.expect_eq(*x0, 42);
+  t.expect_eq(x0.count(), 1);
+  t.expect(x0.is_unique());
+
+  auto x1 = x0;
+  t.expect_eq(x0.count(), 2);
+  t.expect(x0.shares_with(x1));
+
+  *x1 = 43;
+  t.expect_eq(*x0, 43);
+
+  best::rc x2(43);
+  t.expect_eq(x0, x2);
+  t.expect(!x0.shares_with(x2));
+
+  best::option<best::rc<int>> x3;
+  t.expect_eq(x3, best::none);
+  x3 = x0;
+  t.expect_eq(x0.count(), 3);
+  x3 = best::none;
+  t.expect_eq(x0.count(), 2);
+};
+
+best::test Atomic = [](auto& t) {
+  best::arc<int> x0(42);
+  auto x1 = x0;
+  t.expect_eq(x0.count(), 2);
+
+  auto x2 = BEST_MOVE(x1);
+  t.expect_eq(x0.count(), 2);
+  t.expect_eq(*x2, 42);
+};
+
+best::test Span = [](auto& t) {
+  best::rc x0({1, 2, 3, 4, 5});
+  t.expect_eq(*x0, best::span{1, 2, 3, 4, 5});
+  t.expect_eq(x0->size(), 5);
+
+  auto x1 = x0;
+  x1[0] = 6;
+  t.expect_eq(*x0, best::span{6, 2, 3, 4, 5});
+};
+
+best::test Aligned = [](auto& t) {
+  struct alignas(64) Big {
+    int x;
+  };
+
+  best::arc<Big> x0(Big{42});
+  t.expect_eq(x0.as_ptr().to_addr() % 64, 0);
+  t.expect_eq(x0->x, 42);
+};
+
+best::test Dyn = [](auto& t) {
+  best::arc<best::dyn<IntHolder>> x0 = best::arc<Struct>(Struct{21});
+  t.expect_eq(x0->get(), 42);
+
+  auto x1 = x0;
+  t.expect_eq(x1.count(), 2);
+  t.expect_eq(IntHolder::of(x1)->get(), 42);
+};
+
+best::test Leaky = [](auto& t) {
+  LeakTest l_(t);
+
+  using Bubble = LeakTest::Bubble;
+
+  auto x0 = best::rc(Bubble());
+  x0 = best::rc(Bubble());
+
+  auto x1 = x0;
+  auto x2 = std::move(x0);
+
+  x2 = x1;
+  x2 = std::move(x1);
+
+  x0 = best::rc(Bubble());
+  x0 = x2;
+  x0 = best::rc(Bubble());
+  x2 = x0;
+
+  best::arc<Bubble[]> x3({Bubble{}, {}, {}});
+  auto x4 = x3;
+  x4 = x3;
+  auto x5 = std::move(x3);
+  x4 = best::arc<Bubble[]>({Bubble{}});
+};
+}  // namespace best::rc_test
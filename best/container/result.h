@@ -296,6 +296,15 @@ class [[nodiscard(
     return F::check_ok(this), *ok(), impl().as_ptr(index<0>);
   }
 
+  // Niches are inherited from the underlying choice.
+  static constexpr size_t BestNiches = best::choice<T, E>::BestNiches;
+  constexpr explicit result(niche nh) requires (BestNiches > 0)
+    : BEST_RESULT_IMPL_(nh) {}
+  constexpr bool operator==(niche nh) const requires (BestNiches > 0)
+  {
+    return impl() == nh;
+  }
+
   // Comparisons.
   template <best::equatable<T> U, best::equatable<E> F>
   BEST_INLINE_SYNTHETIC constexpr bool operator==(
@@ -28,6 +28,10 @@ namespace best::result_test {
 using ::best_fodder::NonTrivialPod;
 using ::best_fodder::Stuck;
 
+static_assert(sizeof(best::result<int, int>) == 2 * sizeof(int));
+static_assert(sizeof(best::option<best::result<int, int>>) ==
+              sizeof(best::result<int, int>));
+
 best::test Eq = [](auto& t) {
   best::result<int, best::str> x0 = best::ok(42);
   best::result<int, best::str> x1 = best::err(best::str("oops!"));
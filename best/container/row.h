@@ -116,6 +116,19 @@ args(Args&&...) -> args<Args&&...>;
 /// things.at<1>()->bonk();
 /// ```
 ///
+/// ## Layout
+///
+/// Like a Rust tuple, a `best::row` is free to lay out its elements in any
+/// order. Currently, elements are laid out in order of descending alignment,
+/// which minimizes padding: `best::row<char, u64, char, u64>` is 24 bytes
+/// rather than 32. This does not affect the order in which elements are
+/// indexed, bound, compared, or formatted, which is always the order in which
+/// they are declared.
+///
+/// Elements are constructed in layout order, and destroyed in the reverse of
+/// it. Rows with two or fewer elements are always laid out in declaration
+/// order.
+///
 /// ## Other Features
 ///
 /// - `best::row` supports structured bindings.
@@ -185,17 +198,29 @@ class row final
   constexpr row(auto&&... args)
     requires (best::constructible<Elems, decltype(args)> && ...) &&
              (!best::same<decltype(args), best::as_rref<Elems>> || ...)
-    : impl{{best::object<Elems>(best::in_place, BEST_FWD(args))}...} {}
+    : row(Order, BEST_FWD(args)...) {}
   constexpr row(devoid<Elems>&&... args) requires (sizeof...(args) > 0)
-    : impl{{best::object<Elems>(best::in_place, BEST_FWD(args))}...} {}
+    : row(Order, BEST_FWD(args)...) {}
 
   constexpr row(best::bind_t, auto&&... args)
     requires (best::constructible<Elems, decltype(args)> && ...) &&
              (!best::same<decltype(args), best::as_rref<Elems>> || ...)
-    : impl{{best::object<Elems>(best::in_place, BEST_FWD(args))}...} {}
+    : row(Order, BEST_FWD(args)...) {}
   constexpr row(best::bind_t, devoid<Elems>&&... args)
     requires (sizeof...(args) > 0)
-    : impl{{best::object<Elems>(best::in_place, BEST_FWD(args))}...} {}
+    : row(Order, BEST_FWD(args)...) {}
+
+ private:
+  static constexpr auto Order = row_internal::in_layout_order<Elems...>;
+
+  // Elements must be initialized in the order they are laid out in, so we
+  // need to shuffle the arguments accordingly.
+  template <size_t... n>
+  constexpr row(row_internal::ordered<n...>, auto&&... args)
+    : impl{{best::object<type<n>>(
+        best::in_place, row_internal::pick<n>(BEST_FWD(args)...))}...} {}
+
+ public:
 
   /// # `row::size()`
   ///
@@ -502,6 +527,12 @@ class row final
     indices.each([&](auto i) { tup.entry(row.object(i)); });
   }
 
+  friend void BestHash(auto& hasher, const row& row)
+    requires requires(best::object<Elems>... els) { (hasher.hash(els), ...); }
+  {
+    indices.each([&](auto i) { hasher.hash(row.object(i)); });
+  }
+
   template <typename Q>
   constexpr friend void BestFmtQuery(Q& query, row*) {
     query.supports_width = (query.template of<Elems>.supports_width || ...);
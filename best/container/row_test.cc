@@ -27,6 +27,38 @@ using ::best_fodder::MoveOnly;
 
 static_assert(best::is_empty<best::row<>>);
 
+// Elements are laid out to minimize padding.
+static_assert(sizeof(best::row<char, uint64_t, char, uint64_t>) == 24);
+static_assert(sizeof(best::row<char, int, char, int, char>) == 12);
+static_assert(sizeof(best::row<char, uint64_t, uint16_t, uint32_t, char>) ==
+              16);
+static_assert(sizeof(best::row<char, int&, char, int&>) == 3 * sizeof(void*));
+static_assert(sizeof(best::row<char, void, int, best::row<>, char>) == 8);
+static_assert(sizeof(best::row<char, uint64_t>) == 16);
+
+best::test Reordered = [](auto& t) {
+  best::row<int16_t, uint64_t, int16_t, uint64_t> x0(1, 2, 3, 4);
+  static_assert(sizeof(x0) == 24);
+  t.expect_eq(x0[best::index<0>], 1);
+  t.expect_eq(x0[best::index<1>], 2);
+  t.expect_eq(x0[best::index<2>], 3);
+  t.expect_eq(x0[best::index<3>], 4);
+
+  auto [a, b, c, d] = x0;
+  t.expect_eq(a, 1);
+  t.expect_eq(b, 2);
+  t.expect_eq(c, 3);
+  t.expect_eq(d, 4);
+
+  t.expect_eq(x0, best::row(1, 2, 3, 4));
+  t.expect_eq(best::format("{:?}", x0), "(1, 2, 3, 4)");
+
+  best::row<MoveOnly, char, uint64_t> x1(MoveOnly{}, 'x', 3);
+  auto x2 = BEST_MOVE(x1);
+  t.expect_eq(x2[best::index<1>], 'x');
+  t.expect_eq(x2[best::index<2>], 3);
+};
+
 best::test Nums = [](auto& t) {
   best::row<int, float, bool> x0(42, 1.5, true);
   t.expect_eq(x0[best::index<0>], 42);
@@ -0,0 +1,388 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_SLOT_MAP_H_
+#define BEST_CONTAINER_SLOT_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "best/container/option.h"
+#include "best/container/row.h"
+#include "best/container/vec.h"
+#include "best/iter/iter.h"
+#include "best/log/internal/crash.h"
+#include "best/memory/allocator.h"
+#include "best/memory/span.h"
+#include "best/meta/init.h"
+
+//! Slot maps.
+//!
+//! `best::slot_map<T>` is a container that hands out stable, generational
+//! handles to its elements. It is a good fit for graph-like data, where nodes
+//! refer to each other by handle rather than by pointer or index.
+
+namespace best {
+/// # `best::slot_key`
+///
+/// A handle to an element of a `best::slot_map`. Keys are cheap to copy,
+/// hashable, and comparable.
+///
+/// A key consists of a slot index and a generation. When an element is
+/// removed, its slot's generation is bumped, so that stale keys to that slot
+/// no longer resolve to anything, even after the slot is reused.
+///
+/// A default-constructed key never refers to any element.
+class slot_key final {
+ public:
+  /// # `slot_key::slot_key()`
+  ///
+  /// Constructs the null key.
+  constexpr slot_key() = default;
+
+  /// # `slot_key::index()`, `slot_key::generation()`
+  ///
+  /// Returns the components of this key.
+  constexpr uint32_t index() const { return idx_; }
+  constexpr uint32_t generation() const { return gen_; }
+
+  /// # `slot_key::is_null()`
+  ///
+  /// Returns whether this is the null key.
+  constexpr bool is_null() const { return gen_ == 0; }
+
+  constexpr bool operator==(const slot_key&) const = default;
+  constexpr auto operator<=>(const slot_key&) const = default;
+
+  friend void BestFmt(auto& fmt, slot_key key) {
+    auto rec = fmt.record("slot_key");
+    rec.field("index", key.index());
+    rec.field("generation", key.generation());
+  }
+
+  friend void BestHash(auto& hasher, slot_key key) {
+    hasher.hash(key.index()).hash(key.generation());
+  }
+
+ private:
+  template <best::relocatable, best::allocator>
+  friend class slot_map;
+
+  constexpr slot_key(uint32_t idx, uint32_t gen) : idx_(idx), gen_(gen) {}
+
+  uint32_t idx_ = 0, gen_ = 0;
+};
+
+/// # `best::slot_map<T>`
+///
+/// A container of `T`s addressed by `best::slot_key`. Insertion, lookup, and
+/// removal are all O(1), and removing an element invalidates only keys to that
+/// element.
+///
+/// Elements are stored densely in a single `best::vec`, so iterating over them
+/// is as fast as iterating over a vector; removal moves the last element into
+/// the hole. Keys go through a separate array of slots, which map a key's
+/// index to wherever its element currently lives. Hence, iteration order is
+/// unspecified, and pointers to elements are invalidated by insertion and
+/// removal. Keys are not.
+///
+/// Each slot has a 32-bit generation, which is odd while the slot is occupied.
+/// A slot whose generation would wrap around is retired rather than reused, so
+/// a stale key can never resolve to a different element.
+template <best::relocatable T, best::allocator A = best::malloc>
+class slot_map final {
+ public:
+  /// Helper type aliases.
+  using type = T;
+  using value_type = best::un_qual<T>;
+
+  /// # `slot_map::alloc`
+  ///
+  /// This map's allocator type, which may be a reference.
+  using alloc = A;
+
+  /// # `slot_map::slot_map()`
+  ///
+  /// Constructs an empty slot map using the given allocator. An empty slot map
+  /// does not allocate.
+  slot_map() : slot_map(alloc{}) {}
+  explicit slot_map(alloc alloc)
+    requires best::copyable<alloc>
+    : values_(alloc), owners_(alloc), slots_(std::move(alloc)) {}
+
+  /// # `slot_map::slot_map(slot_map)`
+  ///
+  /// Slot maps are copyable if their elements are. Keys into a slot map are
+  /// also valid for copies of it.
+  ///
+  /// Moving from a slot map leaves it empty.
+  slot_map(const slot_map&) = default;
+  slot_map& operator=(const slot_map&) = default;
+  slot_map(slot_map&& that)
+    : values_(std::move(that.values_)),
+      owners_(std::move(that.owners_)),
+      slots_(std::move(that.slots_)),
+      free_(std::exchange(that.free_, None)) {}
+  slot_map& operator=(slot_map&& that) {
+    if (this == &that) { return *this; }
+    values_ = std::move(that.values_);
+    owners_ = std::move(that.owners_);
+    slots_ = std::move(that.slots_);
+    free_ = std::exchange(that.free_, None);
+    return *this;
+  }
+
+  /// # `slot_map::size()`, `slot_map::is_empty()`
+  ///
+  /// Returns the number of elements in this slot map, or whether it has none.
+  size_t size() const { return values_.size(); }
+  bool is_empty() const { return size() == 0; }
+
+  /// # `slot_map::as_span()`
+  ///
+  /// Returns the elements of this slot map as a contiguous span, in an
+  /// unspecified order.
+  best::span<const T> as_span() const { return values_; }
+  best::span<T> as_span() { return values_; }
+
+  /// # `slot_map::insert()`
+  ///
+  /// Constructs a new element in-place, and returns its key.
+  best::slot_key insert(auto&&... args)
+    requires best::constructible<T, decltype(args)&&...>;
+
+  /// # `slot_map::get()`
+  ///
+  /// Looks up the element for `key`, if it is still present.
+  best::option<const T&> get(best::slot_key key) const {
+    auto idx = find(key);
+    if (!idx) { return best::none; }
+    return values_[*idx];
+  }
+  best::option<T&> get(best::slot_key key) {
+    auto idx = find(key);
+    if (!idx) { return best::none; }
+    return values_[*idx];
+  }
+
+  /// # `slot_map::contains()`
+  ///
+  /// Returns whether `key` refers to an element of this slot map.
+  bool contains(best::slot_key key) const { return find(key).has_value(); }
+
+  /// # `slot_map::remove()`
+  ///
+  /// Removes the element for `key`, returning it, if it was present.
+  best::option<T> remove(best::slot_key key);
+
+  /// # `slot_map::reserve()`
+  ///
+  /// Ensures that `count` more elements can be inserted without the slot map
+  /// growing.
+  void reserve(size_t count);
+
+  /// # `slot_map::clear()`
+  ///
+  /// Removes every element from this slot map, invalidating all keys to it.
+  /// This does not free any memory.
+  void clear();
+
+  /// # `slot_map::iterator`
+  ///
+  /// This slot map's iterator types. They yield rows of a key and an element
+  /// reference, in the same order as `as_span()`.
+  template <typename E>
+  class iter_impl;
+  using iterator = best::iter<iter_impl<T>>;
+  using const_iterator = best::iter<iter_impl<const T>>;
+
+  /// # `slot_map::iter()`, `slot_map::begin()`, `slot_map::end()`
+  ///
+  /// Slot maps are iterable exactly how you'd expect.
+  const_iterator iter() const {
+    return const_iterator(iter_impl<const T>(this));
+  }
+  iterator iter() { return iterator(iter_impl<T>(this)); }
+  auto begin() const { return iter().into_range(); }
+  auto end() const { return best::iter_range_end{}; }
+  auto begin() { return iter().into_range(); }
+  auto end() { return best::iter_range_end{}; }
+
+ private:
+  // A slot in the indirection table. While occupied (i.e., `gen` is odd),
+  // `idx` is the index of the element in `values_`; otherwise, it is the next
+  // free slot, or `None`.
+  struct slot final {
+    uint32_t idx;
+    uint32_t gen;
+  };
+  static constexpr uint32_t None = -1;
+
+  best::option<size_t> find(best::slot_key key) const {
+    if (key.is_null()) { return best::none; }
+    auto s = slots_.at(key.index());
+    if (!s || s->gen != key.generation()) { return best::none; }
+    return s->idx;
+  }
+
+  // Returns the key for the element at `values_[idx]`.
+  best::slot_key key_at(size_t idx) const {
+    uint32_t owner = owners_[idx];
+    return best::slot_key(owner, slots_[owner].gen);
+  }
+
+  // Marks the slot at `idx` as vacant and puts it on the free list.
+  void vacate(uint32_t idx);
+
+  // `owners_[i]` is the index of the slot pointing to `values_[i]`, so that
+  // removal can fix up the slot of the element it moves.
+  best::vec<T, 0, alloc> values_;
+  best::vec<uint32_t, 0, alloc> owners_;
+  best::vec<slot, 0, alloc> slots_;
+  uint32_t free_ = None;
+};
+
+/// # `best::slot_map::iter_impl`
+///
+/// The iterator implementation for `best::slot_map`.
+template <best::relocatable T, best::allocator A>
+template <typename E>
+class slot_map<T, A>::iter_impl final {
+ public:
+  using BestIterArrow = void;
+
+ private:
+  friend slot_map;
+  friend best::iter<iter_impl>;
+  friend best::iter<iter_impl&>;
+
+  using map = best::select<best::is_const<E>, const slot_map, slot_map>;
+
+  explicit iter_impl(map* map) : map_(map), end_(map->size()) {}
+
+  best::option<best::row<best::slot_key, E&>> next() {
+    if (idx_ == end_) { return best::none; }
+    return get(idx_++);
+  }
+
+  best::option<best::row<best::slot_key, E&>> next_back() {
+    if (idx_ == end_) { return best::none; }
+    return get(--end_);
+  }
+
+  best::size_hint size_hint() const { return {end_ - idx_, end_ - idx_}; }
+
+  size_t count() && { return end_ - idx_; }
+
+  best::row<best::slot_key, E&> get(size_t idx) const {
+    return {map_->key_at(idx), map_->values_[idx]};
+  }
+
+  map* map_;
+  size_t idx_ = 0, end_;
+};
+}  // namespace best
+
+/* ////////////////////////////////////////////////////////////////////////// *\
+ * ////////////////// !!! IMPLEMENTATION DETAILS BELOW !!! ////////////////// *
+\* ////////////////////////////////////////////////////////////////////////// */
+
+namespace best {
+template <best::relocatable T, best::allocator A>
+best::slot_key slot_map<T, A>::insert(auto&&... args)
+  requires best::constructible<T, decltype(args)&&...>
+{
+  uint32_t idx = free_;
+  if (idx == None) {
+    if (slots_.size() >= None) {
+      best::crash_internal::crash("slot_map ran out of slots");
+    }
+    idx = slots_.size();
+    slots_.push(slot{.idx = None, .gen = 0});
+  }
+
+  auto& s = slots_[idx];
+  values_.push(BEST_FWD(args)...);
+  owners_.push(idx);
+
+  free_ = s.idx;
+  s.idx = values_.size() - 1;
+  ++s.gen;
+  return best::slot_key(idx, s.gen);
+}
+
+template <best::relocatable T, best::allocator A>
+best::option<T> slot_map<T, A>::remove(best::slot_key key) {
+  auto found = find(key);
+  if (!found) { return best::none; }
+  size_t idx = *found;
+  size_t last = values_.size() - 1;
+
+  // Swap-remove: move the last element into the hole, and point its slot at
+  // its new home.
+  auto hole = values_.data() + idx;
+  T value = std::move(*hole);
+  hole.destroy();
+  if (idx != last) {
+    hole.relo(values_.data() + last);
+    owners_[idx] = owners_[last];
+    slots_[owners_[idx]].idx = idx;
+  }
+  values_.set_size(unsafe("we just destroyed or relocated the last element"),
+                   last);
+  owners_.pop();
+
+  vacate(key.index());
+  return value;
+}
+
+template <best::relocatable T, best::allocator A>
+void slot_map<T, A>::reserve(size_t count) {
+  values_.reserve(count);
+  owners_.reserve(count);
+
+  size_t vacant = slots_.size() - size();
+  if (count > vacant) { slots_.reserve(count - vacant); }
+}
+
+template <best::relocatable T, best::allocator A>
+void slot_map<T, A>::clear() {
+  for (uint32_t owner : owners_) { vacate(owner); }
+  values_.clear();
+  owners_.clear();
+}
+
+template <best::relocatable T, best::allocator A>
+void slot_map<T, A>::vacate(uint32_t idx) {
+  auto& s = slots_[idx];
+  ++s.gen;
+
+  // If the generation wrapped around, keys to this slot may already exist for
+  // every future generation, so retire it by leaving it off the free list.
+  if (s.gen == 0) {
+    s.idx = None;
+    return;
+  }
+  s.idx = free_;
+  free_ = idx;
+}
+}  // namespace best
+
+#endif  // BEST_CONTAINER_SLOT_MAP_H_
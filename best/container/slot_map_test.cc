@@ -0,0 +1,168 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/container/slot_map.h"
+
+#include "best/test/fodder.h"
+#include "best/test/test.h"
+#include "best/text/strbuf.h"
+
+namespace best::slot_map_test {
+using ::best_fodder::LeakTest;
+
+best::test Empty = [](auto& t) {
+  best::slot_map<int> empty;
+  t.expect(empty.is_empty());
+  t.expect_eq(empty.size(), 0);
+  t.expect_eq(empty.get(best::slot_key{}), best::none);
+  t.expect(!empty.contains(best::slot_key{}));
+  t.expect_eq(empty.remove(best::slot_key{}), best::none);
+};
+
+best::test InsertGet = [](auto& t) {
+  best::slot_map<best::strbuf> map;
+  auto k0 = map.insert("foo");
+  auto k1 = map.insert("bar");
+  auto k2 = map.insert("baz");
+  t.expect_ne(k0, k1);
+  t.expect_eq(map.size(), 3);
+
+  t.expect_eq(map.get(k0), "foo");
+  t.expect_eq(map.get(k1), "bar");
+  t.expect_eq(map.get(k2), "baz");
+  t.expect_eq(map.get(best::slot_key{}), best::none);
+
+  *map.get(k1) = best::strbuf("quux");
+  t.expect_eq(map.get(k1), "quux");
+  t.expect_eq(map.as_span().size(), 3);
+};
+
+best::test Remove = [](auto& t) {
+  best::slot_map<int> map;
+  best::vec<best::slot_key> keys;
+  for (int i = 0; i < 100; ++i) { keys.push(map.insert(i)); }
+
+  // Removing from the middle moves the last element into the hole, which must
+  // not invalidate its key.
+  t.expect_eq(map.remove(keys[10]), 10);
+  t.expect_eq(map.remove(keys[10]), best::none);
+  t.expect_eq(map.get(keys[10]), best::none);
+  t.expect_eq(map.get(keys[99]), 99);
+  t.expect_eq(map.size(), 99);
+
+  // The slot is reused, but the stale key stays dead.
+  auto fresh = map.insert(-1);
+  t.expect_eq(fresh.index(), keys[10].index());
+  t.expect_ne(fresh.generation(), keys[10].generation());
+  t.expect_eq(map.get(keys[10]), best::none);
+  t.expect_eq(map.get(fresh), -1);
+
+  for (int i = 0; i < 100; ++i) {
+    if (i == 10) { continue; }
+    t.expect_eq(map.remove(keys[i]), i);
+  }
+  t.expect_eq(map.size(), 1);
+  t.expect_eq(map.get(fresh), -1);
+};
+
+best::test Iter = [](auto& t) {
+  best::slot_map<int> map;
+  best::vec<best::slot_key> keys;
+  for (int i = 0; i < 10; ++i) { keys.push(map.insert(i)); }
+  map.remove(keys[3]);
+
+  int total = 0;
+  for (auto [k, v] : map) {
+    t.expect_eq(map.get(k), v);
+    total += v;
+  }
+  t.expect_eq(map.iter().count(), 9);
+
+  int sum = 0;
+  for (int v : map.as_span()) { sum += v; }
+  t.expect_eq(total, sum);
+  t.expect_eq(total, 45 - 3);
+
+  for (auto [k, v] : map) { v *= 10; }
+  for (auto [k, v] : map) { t.expect_eq(v % 10, 0); }
+};
+
+best::test Clear = [](auto& t) {
+  best::slot_map<int> map;
+  auto k0 = map.insert(0);
+  auto k1 = map.insert(1);
+  map.clear();
+  t.expect(map.is_empty());
+  t.expect(!map.contains(k0));
+  t.expect(!map.contains(k1));
+
+  auto k2 = map.insert(2);
+  t.expect_ne(k2, k0);
+  t.expect_ne(k2, k1);
+  t.expect_eq(map.get(k2), 2);
+};
+
+best::test CopyMove = [](auto& t) {
+  best::slot_map<int> map;
+  auto k = map.insert(42);
+
+  auto map2 = map;
+  t.expect_eq(map2.get(k), 42);
+
+  auto map3 = std::move(map);
+  t.expect_eq(map3.get(k), 42);
+
+  // A moved-from map is empty, and remains usable, even if it had vacant
+  // slots on its free list.
+  auto k2 = map3.insert(43);
+  map3.remove(k);
+  auto map4 = std::move(map3);
+  t.expect_eq(map4.get(k2), 43);
+  for (auto [key, value] : map3) { t.expect(false, "{}: {}", key, value); }
+  t.expect(map3.is_empty());
+  auto k3 = map3.insert(44);
+  t.expect_eq(map3.get(k3), 44);
+  t.expect_eq(map3.size(), 1);
+
+  map = std::move(map4);
+  t.expect(map4.is_empty());
+  k3 = map4.insert(45);
+  t.expect_eq(map4.get(k3), 45);
+  t.expect_eq(map.get(k2), 43);
+};
+
+best::test Leaky = [](auto& t) {
+  LeakTest l_(t);
+
+  using Bubble = LeakTest::Bubble;
+
+  best::slot_map<Bubble> x0;
+  best::vec<best::slot_key> keys;
+  for (int i = 0; i < 100; ++i) { keys.push(x0.insert()); }
+  for (int i = 0; i < 50; ++i) { x0.remove(keys[i * 2]); }
+  x0.insert(Bubble());
+
+  auto x1 = x0;
+  auto x2 = std::move(x0);
+  x2 = x1;
+  x2 = std::move(x1);
+  x2.clear();
+  x2.insert();
+};
+}  // namespace best::slot_map_test
@@ -0,0 +1,497 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_CONTAINER_SOA_VEC_H_
+#define BEST_CONTAINER_SOA_VEC_H_
+
+#include <cstddef>
+#include <utility>
+
+#include "best/base/hint.h"
+#include "best/base/unsafe.h"
+#include "best/container/internal/soa_vec.h"
+#include "best/container/object.h"
+#include "best/container/option.h"
+#include "best/container/row.h"
+#include "best/container/vec.h"
+#include "best/log/internal/crash.h"
+#include "best/math/overflow.h"
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+#include "best/memory/ptr.h"
+#include "best/memory/span.h"
+#include "best/meta/init.h"
+#include "best/meta/reflect.h"
+
+//! Struct-of-arrays vectors.
+//!
+//! `best::soa_vec<T>` stores a sequence of `T`s, but rather than laying each
+//! `T` out contiguously, it stores each field of `T` in its own contiguous
+//! column. Scanning a single field of every element then only touches the
+//! memory for that field, and is readily vectorized.
+//!
+//! ```
+//! struct Particle {
+//!   float x, y, z;
+//!   uint32_t flags;
+//! };
+//!
+//! best::soa_vec<Particle> ps;
+//! ps.push({1, 2, 3, 0});
+//! for (float& x : ps.column<0>()) { x += 1; }
+//! ```
+
+namespace best {
+/// # `best::soa_type`
+///
+/// Whether `T` can be split into columns for a `best::soa_vec`: either a
+/// `best::row`, or a reflected struct. Every column must be a relocatable
+/// object type.
+template <typename T>
+concept soa_type =
+  (best::is_row<T> || best::is_reflected_struct<T>) &&
+  best::soa_vec_internal::columns<T>.apply([]<typename... Cols> {
+    return sizeof...(Cols) > 0 &&
+           ((best::is_object<Cols> && best::relocatable<Cols>) && ...);
+  });
+
+/// # `best::soa_vec<T>`
+///
+/// A growable sequence of `T`s, stored as a struct of arrays.
+///
+/// The columns of a `soa_vec<T>` are the fields of `T`: if `T` is a
+/// `best::row`, its elements, and otherwise, its fields as reported by
+/// `best::reflect`. All of the columns live in a single allocation, one after
+/// another, and all have the same length.
+///
+/// Elements are accessed through row proxies: `v[i]` is a `best::row` of
+/// references to the `i`th entry of each column, which supports structured
+/// bindings. Whole columns are available as `best::span`s via `column()`.
+///
+/// `get()`, which rebuilds a whole `T`, is only available if `T` can be
+/// constructed from its columns, e.g., if it is an aggregate with no hidden
+/// fields.
+template <best::soa_type T, best::allocator A = best::malloc,
+          best::vec_growth G = best::grow_pow2<>>
+class soa_vec final {
+ private:
+  using info = soa_vec_internal::info_of<T>;
+
+  static constexpr auto Cols = soa_vec_internal::columns<T>;
+  static constexpr bool Copyable = Cols.apply([]<typename... C> {
+    return (best::copyable<C> && ...);
+  });
+  static constexpr bool Rebuildable = Cols.apply([]<typename... C> {
+    return requires(const C&... cols) { T{cols...}; };
+  });
+  template <typename... Args>
+  static constexpr bool emplaceable =
+    sizeof...(Args) == Cols.size() &&
+    best::indices<sizeof...(Args)>.apply([]<size_t... n> {
+      return (best::constructible<
+                typename decltype(Cols)::template type<n>,
+                typename decltype(best::types<Args...>)::template type<n>> &&
+              ...);
+    });
+
+ public:
+  /// Helper type aliases.
+  using type = T;
+
+  /// # `soa_vec::types`
+  ///
+  /// A `tlist` of the column types of this vector.
+  static constexpr auto types = Cols;
+
+  /// # `soa_vec::column_type<n>`
+  ///
+  /// The type of the `n`th column.
+  template <size_t n>
+  using column_type = decltype(types)::template type<n>;
+
+  /// # `soa_vec::row`, `soa_vec::ref`, `soa_vec::cref`
+  ///
+  /// A row of the column types, and rows of references to them. The latter two
+  /// are the row proxies returned by `operator[]`.
+  using row = info::row;
+  using ref = info::ref;
+  using cref = info::cref;
+
+  /// # `soa_vec::alloc`
+  ///
+  /// This vector's allocator type, which may be a reference.
+  using alloc = A;
+
+  /// # `soa_vec::growth`
+  ///
+  /// This vector's growth policy.
+  using growth = G;
+
+  /// # `soa_vec::soa_vec()`
+  ///
+  /// Constructs an empty vector using the given allocator. An empty vector
+  /// does not allocate.
+  soa_vec() : soa_vec(alloc{}) {}
+  explicit soa_vec(alloc alloc) : alloc_(best::in_place, std::move(alloc)) {}
+
+  /// # `soa_vec::soa_vec(soa_vec)`
+  ///
+  /// Copyable if every column is; copies allocate exactly enough capacity.
+  soa_vec(const soa_vec& that) requires Copyable && best::copyable<alloc>;
+  soa_vec& operator=(const soa_vec& that)
+    requires Copyable && best::copyable<alloc>;
+  soa_vec(soa_vec&& that);
+  soa_vec& operator=(soa_vec&& that);
+
+  /// # `soa_vec::~soa_vec()`
+  ///
+  /// Destroys every element and frees the buffer.
+  ~soa_vec() { destroy(); }
+
+  /// # `soa_vec::size()`, `soa_vec::is_empty()`, `soa_vec::capacity()`
+  ///
+  /// Returns the number of elements, whether that is zero, and the number of
+  /// elements that fit in the current allocation.
+  size_t size() const { return size_; }
+  bool is_empty() const { return size_ == 0; }
+  size_t capacity() const { return cap_; }
+
+  /// # `soa_vec::allocator()`
+  ///
+  /// Returns a reference to the allocator.
+  const alloc& allocator() const { return *alloc_; }
+  alloc& allocator() { return *alloc_; }
+
+  /// # `soa_vec::column()`, `soa_vec::columns()`
+  ///
+  /// Returns the `n`th column as a span, or a row of spans of every column.
+  template <size_t n>
+  best::span<const column_type<n>> column(best::index_t<n> = {}) const {
+    return {col<n>(), size_};
+  }
+  template <size_t n>
+  best::span<column_type<n>> column(best::index_t<n> = {}) {
+    return {col<n>(), size_};
+  }
+  auto columns() const;
+  auto columns();
+
+  /// # `soa_vec[idx]`, `soa_vec::at()`
+  ///
+  /// Returns a row of references to the `idx`th element of each column.
+  /// `operator[]` crashes if `idx` is out of bounds; `at()` returns
+  /// `best::none` instead.
+  cref operator[](size_t idx) const;
+  ref operator[](size_t idx);
+  best::option<cref> at(size_t idx) const;
+  best::option<ref> at(size_t idx);
+
+  /// # `soa_vec::get()`
+  ///
+  /// Rebuilds the `idx`th element as a `T`, by copying each of its columns.
+  /// Crashes if `idx` is out of bounds.
+  T get(size_t idx) const requires Rebuildable;
+
+  /// # `soa_vec::reserve()`
+  ///
+  /// Ensures that pushing an additional `count` elements would not cause this
+  /// vector to reallocate.
+  void reserve(size_t count);
+
+  /// # `soa_vec::push()`
+  ///
+  /// Splits `value` into columns and appends it to the end of this vector.
+  ref push(const T& value) requires Copyable;
+  ref push(T&& value);
+
+  /// # `soa_vec::emplace()`
+  ///
+  /// Appends a new element to the end of this vector, constructing each
+  /// column in place from the corresponding argument.
+  ref emplace(auto&&... args) requires emplaceable<decltype(args)&&...>;
+
+  /// # `soa_vec::pop()`
+  ///
+  /// Removes the last element from this vector, if it is nonempty.
+  best::option<row> pop();
+
+  /// # `soa_vec::remove()`
+  ///
+  /// Removes the element at `idx`, shifting every later element down. Crashes
+  /// if `idx` is out of bounds.
+  row remove(size_t idx);
+
+  /// # `soa_vec::erase()`
+  ///
+  /// Removes all elements within `bounds` from every column.
+  void erase(best::bounds bounds);
+
+  /// # `soa_vec::truncate()`, `soa_vec::clear()`
+  ///
+  /// Shortens the vector to be at most `count` elements long, or to zero.
+  void truncate(size_t count);
+  void clear() { truncate(0); }
+
+  friend void BestFmt(auto& fmt, const soa_vec& v)
+    requires requires { fmt.format(v[0]); }
+  {
+    auto list = fmt.list();
+    for (size_t i = 0; i < v.size(); ++i) { list.entry(v[i]); }
+  }
+
+ private:
+  // Returns a pointer to the start of the `n`th column, either of this vector
+  // or of a buffer with the given capacity.
+  template <size_t n>
+  best::ptr<column_type<n>> col() const {
+    return col<n>(data_, cap_);
+  }
+  template <size_t n>
+  static best::ptr<column_type<n>> col(char* data, size_t cap) {
+    return reinterpret_cast<column_type<n>*>(data + cap * info::Offsets[n]);
+  }
+
+  // Returns the layout of a buffer with the given capacity.
+  static best::layout layout_for(size_t capacity);
+
+  // Reallocates to hold exactly `new_cap` elements.
+  void regrow(size_t new_cap);
+
+  // Copies every element of `that` into this vector, which must be empty.
+  void copy_from(const soa_vec& that);
+
+  // Destroys all elements and frees the buffer.
+  void destroy();
+
+  // Checks that `idx` is in bounds.
+  void check(size_t idx) const;
+
+  char* data_ = nullptr;
+  size_t size_ = 0;
+  size_t cap_ = 0;
+  [[no_unique_address]] best::object<alloc> alloc_;
+};
+}  // namespace best
+
+/* ////////////////////////////////////////////////////////////////////////// *\
+ * ////////////////// !!! IMPLEMENTATION DETAILS BELOW !!! ////////////////// *
+\* ////////////////////////////////////////////////////////////////////////// */
+
+namespace best {
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+soa_vec<T, A, G>::soa_vec(const soa_vec& that)
+  requires Copyable && best::copyable<alloc>
+  : alloc_(that.alloc_) {
+  copy_from(that);
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+soa_vec<T, A, G>& soa_vec<T, A, G>::operator=(const soa_vec& that)
+  requires Copyable && best::copyable<alloc>
+{
+  if (this == &that) { return *this; }
+  destroy();
+  alloc_ = that.alloc_;
+  copy_from(that);
+  return *this;
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+soa_vec<T, A, G>::soa_vec(soa_vec&& that)
+  : data_(std::exchange(that.data_, nullptr)),
+    size_(std::exchange(that.size_, 0)),
+    cap_(std::exchange(that.cap_, 0)),
+    alloc_(BEST_MOVE(that.alloc_)) {}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+soa_vec<T, A, G>& soa_vec<T, A, G>::operator=(soa_vec&& that) {
+  if (this == &that) { return *this; }
+  destroy();
+  data_ = std::exchange(that.data_, nullptr);
+  size_ = std::exchange(that.size_, 0);
+  cap_ = std::exchange(that.cap_, 0);
+  alloc_ = BEST_MOVE(that.alloc_);
+  return *this;
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+auto soa_vec<T, A, G>::columns() const {
+  return best::indices<types.size()>.apply(
+    [&]<size_t... n> { return best::row(column<n>()...); });
+}
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+auto soa_vec<T, A, G>::columns() {
+  return best::indices<types.size()>.apply(
+    [&]<size_t... n> { return best::row(column<n>()...); });
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+auto soa_vec<T, A, G>::operator[](size_t idx) const -> cref {
+  check(idx);
+  return best::indices<types.size()>.apply(
+    [&]<size_t... n> { return cref{*(col<n>() + idx)...}; });
+}
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+auto soa_vec<T, A, G>::operator[](size_t idx) -> ref {
+  check(idx);
+  return best::indices<types.size()>.apply(
+    [&]<size_t... n> { return ref{*(col<n>() + idx)...}; });
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+auto soa_vec<T, A, G>::at(size_t idx) const -> best::option<cref> {
+  if (idx >= size_) { return best::none; }
+  return (*this)[idx];
+}
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+auto soa_vec<T, A, G>::at(size_t idx) -> best::option<ref> {
+  if (idx >= size_) { return best::none; }
+  return (*this)[idx];
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+T soa_vec<T, A, G>::get(size_t idx) const requires Rebuildable
+{
+  return (*this)[idx].apply([](const auto&... cols) { return T{cols...}; });
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+void soa_vec<T, A, G>::reserve(size_t count) {
+  auto [needed, of] = best::overflow(size_) + count;
+  if (of) {
+    best::crash_internal::crash("soa_vec capacity overflow: %zu + %zu", size_,
+                                count);
+  }
+  if (needed <= cap_) { return; }
+  regrow(G::grow(cap_, needed, info::Elem));
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+auto soa_vec<T, A, G>::push(const T& value) -> ref requires Copyable
+{
+  return soa_vec_internal::split(value).apply(
+    [&](const auto&... cols) -> ref { return emplace(cols...); });
+}
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+auto soa_vec<T, A, G>::push(T&& value) -> ref {
+  return soa_vec_internal::split(BEST_MOVE(value))
+    .apply([&](auto&&... cols) -> ref { return emplace(BEST_MOVE(cols)...); });
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+auto soa_vec<T, A, G>::emplace(auto&&... args) -> ref
+  requires emplaceable<decltype(args)&&...>
+{
+  reserve(1);
+  auto args_ = best::row(best::bind, BEST_FWD(args)...);
+  best::indices<types.size()>.each([&]<size_t n> {
+    (col<n>() + size_).construct(BEST_MOVE(args_)[best::index<n>]);
+  });
+  return (*this)[size_++];
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+auto soa_vec<T, A, G>::pop() -> best::option<row> {
+  if (is_empty()) { return best::none; }
+  return remove(size_ - 1);
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+auto soa_vec<T, A, G>::remove(size_t idx) -> row {
+  check(idx);
+  auto value = best::indices<types.size()>.apply(
+    [&]<size_t... n> { return row{BEST_MOVE(*(col<n>() + idx))...}; });
+  erase({.start = idx, .count = 1});
+  return value;
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+void soa_vec<T, A, G>::erase(best::bounds bounds) {
+  size_t count = bounds.compute_count(size_);
+  size_t end = bounds.start + count;
+  size_t tail = size_ - end;
+
+  best::indices<types.size()>.each([&]<size_t n> {
+    auto start = col<n>() + bounds.start;
+    best::span(start, count).destroy();
+    start.relo_overlapping(start + count, tail);
+  });
+  size_ -= count;
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+void soa_vec<T, A, G>::truncate(size_t count) {
+  if (count >= size_) { return; }
+  erase({.start = count});
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+best::layout soa_vec<T, A, G>::layout_for(size_t capacity) {
+  // The columns are not padded, so the total size needs to be rounded up to
+  // the alignment separately.
+  auto [size, of] =
+    best::overflow(info::Stride) * capacity + (info::Align - 1);
+  if (of) {
+    best::crash_internal::crash("soa_vec capacity overflow: %zu elements",
+                                capacity);
+  }
+  return best::layout(unsafe("rounded up to Align, a power of two, above"),
+                      size & ~(info::Align - 1), info::Align);
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+void soa_vec<T, A, G>::regrow(size_t new_cap) {
+  auto* fresh = static_cast<char*>(alloc_->alloc(layout_for(new_cap)).raw());
+  best::indices<types.size()>.each(
+    [&]<size_t n> { col<n>(fresh, new_cap).relo(col<n>(), size_); });
+
+  if (data_ != nullptr) { alloc_->dealloc(data_, layout_for(cap_)); }
+  data_ = fresh;
+  cap_ = new_cap;
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+void soa_vec<T, A, G>::copy_from(const soa_vec& that) {
+  if (that.is_empty()) { return; }
+  regrow(that.size());
+  best::indices<types.size()>.each(
+    [&]<size_t n> { col<n>().copy(that.template col<n>(), that.size()); });
+  size_ = that.size();
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+void soa_vec<T, A, G>::destroy() {
+  if (data_ == nullptr) { return; }
+  best::indices<types.size()>.each(
+    [&]<size_t n> { best::span(col<n>(), size_).destroy(); });
+  alloc_->dealloc(data_, layout_for(cap_));
+  data_ = nullptr;
+  size_ = cap_ = 0;
+}
+
+template <best::soa_type T, best::allocator A, best::vec_growth G>
+void soa_vec<T, A, G>::check(size_t idx) const {
+  if (best::unlikely(idx >= size_)) {
+    best::crash_internal::crash("soa_vec index out of bounds: %zu >= %zu", idx,
+                                size_);
+  }
+}
+}  // namespace best
+
+#endif  // BEST_CONTAINER_SOA_VEC_H_
@@ -0,0 +1,117 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/container/soa_vec.h"
+
+#include "best/test/test.h"
+#include "best/text/format.h"
+#include "best/text/strbuf.h"
+
+namespace best::soa_vec_test {
+struct Particle final {
+  float x, y;
+  uint8_t flags;
+  uint64_t id;
+
+  constexpr friend auto BestReflect(auto& m, Particle*) { return m.infer(); }
+  constexpr bool operator==(const Particle&) const = default;
+};
+
+static_assert(best::soa_type<Particle>);
+static_assert(best::soa_type<best::row<int, bool>>);
+static_assert(!best::soa_type<int>);
+
+best::test Push = [](auto& t) {
+  best::soa_vec<Particle> ps;
+  t.expect(ps.is_empty());
+  t.expect_eq(ps.capacity(), 0);
+
+  ps.push({1, 2, 0, 42});
+  ps.push({3, 4, 1, 43});
+  ps.emplace(5, 6, 2, 44);
+  t.expect_eq(ps.size(), 3);
+  t.expect_ge(ps.capacity(), 3);
+
+  t.expect_eq(ps.column<0>(), best::span<const float>{1, 3, 5});
+  t.expect_eq(ps.column<2>(), best::span<const uint8_t>{0, 1, 2});
+  t.expect_eq(ps.column<3>(), best::span<const uint64_t>{42, 43, 44});
+  t.expect_eq(ps.get(1), Particle{3, 4, 1, 43});
+  t.expect_eq(ps.at(3), best::none);
+};
+
+best::test Columns = [](auto& t) {
+  best::soa_vec<Particle> ps;
+  for (int i = 0; i < 100; ++i) { ps.emplace(i, -i, i % 2, i * 1000); }
+
+  for (float& x : ps.column<0>()) { x *= 2; }
+  auto [x, y, flags, id] = ps[50];
+  t.expect_eq(x, 100);
+  t.expect_eq(y, -50);
+  t.expect_eq(flags, 0);
+  t.expect_eq(id, 50000);
+
+  // Every column must be aligned, no matter the capacity.
+  ps.columns().each([&](auto col) {
+    using Col = decltype(col)::type;
+    t.expect_eq(col.data().to_addr() % best::align_of<Col>, 0);
+    t.expect_eq(col.size(), 100);
+  });
+};
+
+best::test Remove = [](auto& t) {
+  best::soa_vec<best::row<int, best::strbuf>> v;
+  v.push({1, "one"});
+  v.push({2, "two"});
+  v.push({3, "three"});
+  v.push({4, "four"});
+
+  t.expect_eq(v.remove(1), best::row(2, "two"));
+  t.expect_eq(v.pop(), best::row(4, "four"));
+  t.expect_eq(v.size(), 2);
+  t.expect_eq(v[1], best::row(3, "three"));
+
+  v.push({5, "five"});
+  v.erase({.start = 0, .count = 2});
+  t.expect_eq(v.size(), 1);
+  t.expect_eq(v[0], best::row(5, "five"));
+
+  v.clear();
+  t.expect(v.is_empty());
+  t.expect_eq(v.pop(), best::none);
+};
+
+best::test CopyMove = [](auto& t) {
+  best::soa_vec<best::row<int, best::strbuf>> v;
+  for (int i = 0; i < 10; ++i) { v.emplace(i, best::format("{}", i)); }
+
+  auto v2 = v;
+  t.expect_eq(v2.size(), 10);
+  t.expect_eq(v2[7], best::row(7, "7"));
+
+  auto v3 = BEST_MOVE(v);
+  t.expect(v.is_empty());
+  t.expect_eq(v3[9], best::row(9, "9"));
+
+  v2 = v3;
+  v3 = BEST_MOVE(v2);
+  t.expect_eq(v3.size(), 10);
+  t.expect_eq(best::format("{:?}", v3.column<0>()),
+              "[0, 1, 2, 3, 4, 5, 6, 7, 8, 9]");
+};
+}  // namespace best::soa_vec_test
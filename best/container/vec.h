@@ -21,10 +21,12 @@
 #define BEST_CONTAINER_VEC_H_
 
 #include <cstddef>
+#include <cstring>
 #include <initializer_list>
 
 #include "best/base/tags.h"
 #include "best/container/box.h"
+#include "best/container/internal/vec.h"
 #include "best/container/object.h"
 #include "best/container/option.h"
 #include "best/func/arrow.h"
@@ -46,7 +48,95 @@
 //! ranges, i.e., ranges that can be represented as spans.
 
 namespace best {
-template <best::relocatable, size_t, best::allocator>
+/// # `best::vec_growth`
+///
+/// A growth policy for `best::vec`, which decides how large a vector's heap
+/// buffer should be when it needs to grow.
+///
+/// A policy is a type with a static function `grow(capacity, needed, elem)`,
+/// where `capacity` is the current heap capacity (zero if the vector has not
+/// spilled yet), `needed` is the minimum acceptable capacity, and `elem` is the
+/// layout of the element type. It must return a value that is at least
+/// `needed`.
+///
+/// A policy also provides a constant `First`, the smallest capacity to use
+/// when a vector is spilled to the heap without a capacity hint. Operations
+/// that know how many elements they need, such as `push()` and `reserve()`,
+/// do not use it.
+template <typename G>
+concept vec_growth = requires(size_t n, best::layout elem) {
+  { G::grow(n, n, elem) } -> std::same_as<size_t>;
+  { G::First } -> std::convertible_to<size_t>;
+};
+
+/// # `best::grow_pow2<first>`
+///
+/// Rounds capacities up to a power of two, which doubles the capacity each time
+/// a vector grows. An unhinted spill to the heap holds at least `first`
+/// elements.
+///
+/// This is the default growth policy.
+template <size_t first = 32>
+struct grow_pow2 final {
+  static constexpr size_t First = first;
+  static constexpr size_t grow(size_t, size_t needed, best::layout) {
+    if (!best::is_pow2(needed)) { needed = best::next_pow2(needed); }
+    return needed;
+  }
+};
+
+/// # `best::grow_geometric<num, den, first>`
+///
+/// Grows capacity by a factor of `num / den` (1.5 by default). This wastes less
+/// memory than doubling, at the cost of reallocating more often. An unhinted
+/// spill to the heap holds at least `first` elements.
+template <size_t num = 3, size_t den = 2, size_t first = 4>
+  requires (num > den && den > 0)
+struct grow_geometric final {
+  static constexpr size_t First = first;
+  static constexpr size_t grow(size_t capacity, size_t needed, best::layout) {
+    size_t scaled = best::saturating_mul(capacity, num) / den;
+    return best::max(needed, scaled);
+  }
+};
+
+/// # `best::grow_exact`
+///
+/// Allocates exactly as much capacity as is needed, and no more. This is
+/// appropriate for vectors whose final size is known up-front (via `reserve()`
+/// and friends), but makes repeated `push()`es quadratic.
+struct grow_exact final {
+  static constexpr size_t First = 0;
+  static constexpr size_t grow(size_t, size_t needed, best::layout) {
+    return needed;
+  }
+};
+
+/// # `best::grow_pages<page_size>`
+///
+/// Doubles the capacity like `best::grow_pow2`, and then rounds it up so that
+/// the buffer occupies a whole number of `page_size`-byte pages. This is
+/// useful for large vectors of large elements, whose power-of-two sizes would
+/// otherwise leave much of their last page unused.
+template <size_t page_size = 4096>
+  requires (best::is_pow2(page_size))
+struct grow_pages final {
+  static constexpr size_t First = 0;
+  static constexpr size_t grow(size_t capacity, size_t needed,
+                               best::layout elem) {
+    size_t count = best::max(needed, best::saturating_mul(capacity, 2));
+    // Past this point rounding up would overflow, and the allocation is going
+    // to fail anyway.
+    if (count > (best::max_of<size_t> - page_size) / elem.size()) {
+      return count;
+    }
+    size_t bytes = (count * elem.size() + page_size - 1) & ~(page_size - 1);
+    return best::max(count, bytes / elem.size());
+  }
+};
+
+template <best::relocatable, size_t, best::allocator,
+          best::vec_growth = best::grow_pow2<>>
 class vec;
 
 /// # `best::is_vec`
@@ -55,7 +145,8 @@ class vec;
 template <typename V>
 concept is_vec =
   best::same<best::as_auto<V>,
-             best::vec<typename V::type, V::MaxInline, typename V::alloc>>;
+             best::vec<typename V::type, V::MaxInline, typename V::alloc,
+                       typename V::growth>>;
 
 /// # `best::vec_inline_default()`
 ///
@@ -82,8 +173,11 @@ constexpr size_t vec_inline_default() {
 /// Note that `best::vec` only provides a subset of the `best::span` functions.
 /// To access the full suite of span operations, you must access them through
 /// `->`, e.g., `vec->sort()`.
+///
+/// The growth policy `G` controls how the heap buffer grows; see
+/// `best::vec_growth`.
 template <best::relocatable T, size_t max_inline = vec_inline_default<T>(),
-          best::allocator A = best::malloc>
+          best::allocator A = best::malloc, best::vec_growth G>
 class vec final {
  public:
   /// Helper type aliases.
@@ -102,6 +196,11 @@ class vec final {
   /// This vector's allocator type, which may be a reference.
   using alloc = A;
 
+  /// # `vec::growth`
+  ///
+  /// This vector's growth policy.
+  using growth = G;
+
   /// # `vec::MaxInline`
   ///
   /// The maximum number of elements in inline storage.
@@ -160,6 +259,20 @@ class vec final {
     assign(range);
   }
 
+  /// # `vec::zeroed()`
+  ///
+  /// Constructs a vector of `count` zeroed elements.
+  ///
+  /// The buffer is obtained with `alloc::zalloc()`, which for large buffers
+  /// usually means getting lazily-zeroed pages from the OS, so that the cost of
+  /// zeroing is only paid for the pages that are actually touched.
+  static vec zeroed(size_t count)
+    requires best::zeroable<T> && best::constructible<alloc>
+  {
+    return zeroed(alloc{}, count);
+  }
+  static vec zeroed(alloc alloc, size_t count) requires best::zeroable<T>;
+
   /// # `vec::vec(box)`
   ///
   /// Constructs a vector from an array box, by taking ownership of the
@@ -315,9 +428,16 @@ class vec final {
   /// Resizes the underlying allocation such that `capacity == size`.
   void shrink_to_fit() {
     if (size() == capacity() || !on_heap()) { return; }
-    spill_to_heap(size());
+    spill_to_heap(size(), true);
   }
 
+  /// # `vec::resize_zeroed()`
+  ///
+  /// Resizes this vector to `new_size` elements, filling any new elements with
+  /// zeroes. If the vector is empty and needs a new buffer, this uses
+  /// `alloc::zalloc()`, like `vec::zeroed()` does.
+  void resize_zeroed(size_t new_size) requires best::zeroable<T>;
+
   /// # `vec::truncate()`.
   ///
   /// Shortens the vector to be at most `count` elements long.
@@ -452,12 +572,17 @@ class vec final {
   }
 
  private:
-  template <best::relocatable, size_t, best::allocator>
+  template <best::relocatable, size_t, best::allocator, best::vec_growth>
   friend class vec;
 
   // Destroys the underlying array and its elements.
   void destroy();
 
+  // Moves this vector's elements into a heap buffer of capacity `new_size`,
+  // leaving `gap_len` uninitialized slots at index `gap_at`. The size is left
+  // unchanged, so the caller must fill the gap and update it.
+  void regrow(size_t new_size, bool exact, size_t gap_at, size_t gap_len);
+
   // Implements the move constructor and move assignment, which share a lot of
   // code but are not identical.
   void move_construct(vec&&, bool assign);
@@ -553,32 +678,37 @@ struct vec {
 };
 }  // namespace iter_internal
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-vec<T, max_inline, A>::vec(const vec& that)
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+vec<T, max_inline, A, G>::vec(const vec& that)
   requires best::copyable<T> && best::copyable<alloc>
   : vec(that.allocator()) {
   assign(that);
 }
-template <best::relocatable T, size_t max_inline, best::allocator A>
-auto vec<T, max_inline, A>::operator=(const vec& that)
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+auto vec<T, max_inline, A, G>::operator=(const vec& that)
   -> vec& requires best::copyable<T> && best::copyable<alloc>
 {
   assign(that);
   return *this;
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-vec<T, max_inline, A>::vec(vec&& that) : vec(std::move(that.allocator())) {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+vec<T, max_inline, A, G>::vec(vec&& that) : vec(std::move(that.allocator())) {
   move_construct(std::move(that), false);
 }
-template <best::relocatable T, size_t max_inline, best::allocator A>
-auto vec<T, max_inline, A>::operator=(vec&& that) -> vec& {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+auto vec<T, max_inline, A, G>::operator=(vec&& that) -> vec& {
   move_construct(std::move(that), true);
   return *this;
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-void vec<T, max_inline, A>::move_construct(vec&& that, bool assign) {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+void vec<T, max_inline, A, G>::move_construct(vec&& that, bool assign) {
   if (best::equal(this, &that)) { return; }
 
   if (auto heap = that.on_heap()) {
@@ -614,8 +744,9 @@ void vec<T, max_inline, A>::move_construct(vec&& that, bool assign) {
   that.store_size(0);  // This resets `that` to being empty and inlined.
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-void vec<T, max_inline, A>::destroy() {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+void vec<T, max_inline, A, G>::destroy() {
   clear();
   if (auto heap = on_heap()) {
     alloc_->dealloc(heap->data(), layout::array<T>(capacity()));
@@ -624,20 +755,23 @@ void vec<T, max_inline, A>::destroy() {
   store_size(0);  // This returns `this` to being empty and inlined.
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-best::ptr<const T> vec<T, max_inline, A>::data() const {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+best::ptr<const T> vec<T, max_inline, A, G>::data() const {
   if (auto heap = on_heap()) { return heap->data(); }
   return best::ptr(this).cast(best::types<const T>);
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-best::ptr<T> vec<T, max_inline, A>::data() {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+best::ptr<T> vec<T, max_inline, A, G>::data() {
   if (auto heap = on_heap()) { return heap->data(); }
   return best::ptr(this).cast(best::types<T>);
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-size_t vec<T, max_inline, A>::size() const {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+size_t vec<T, max_inline, A, G>::size() const {
   auto size = load_size();
   if constexpr (max_inline == 0) {
     // size_ is implicitly always zero if off-heap.
@@ -646,8 +780,9 @@ size_t vec<T, max_inline, A>::size() const {
     return on_heap() ? ~size : size >> (bits_of<size_t> - SizeBytes * 8);
   }
 }
-template <best::relocatable T, size_t max_inline, best::allocator A>
-void vec<T, max_inline, A>::set_size(unsafe, size_t new_size) {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+void vec<T, max_inline, A, G>::set_size(unsafe, size_t new_size) {
   if (new_size > capacity()) {
     best::crash_internal::crash("set_len(): %zu (new_size) > %zu (capacity)",
                                 new_size, capacity());
@@ -677,8 +812,9 @@ void vec<T, max_inline, A>::set_size(unsafe, size_t new_size) {
   }
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-void vec<T, max_inline, A>::assign(const contiguous auto& that) {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+void vec<T, max_inline, A, G>::assign(const contiguous auto& that) {
   if (best::equal(this, &that)) { return; }
 
   using Range = best::un_ref<decltype(that)>;
@@ -704,9 +840,10 @@ void vec<T, max_inline, A>::assign(const contiguous auto& that) {
   set_size(unsafe("updating size to that of the memcpy'd range"), new_size);
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-void vec<T, max_inline, A>::splice_within(size_t idx, size_t start,
-                                          size_t count) {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+void vec<T, max_inline, A, G>::splice_within(size_t idx, size_t start,
+                                             size_t count) {
   // If we are self-splicing, we need to make two copies: the outer chunk
   // and the inner chunk. After resizing, this vector looks like this:
   //
@@ -756,34 +893,82 @@ void vec<T, max_inline, A>::splice_within(size_t idx, size_t start,
   }
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-void vec<T, max_inline, A>::truncate(size_t count) {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+vec<T, max_inline, A, G> vec<T, max_inline, A, G>::zeroed(alloc alloc,
+                                                        size_t count)
+  requires best::zeroable<T>
+{
+  vec v(std::move(alloc));
+  v.resize_zeroed(count);
+  return v;
+}
+
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+void vec<T, max_inline, A, G>::resize_zeroed(size_t new_size)
+  requires best::zeroable<T>
+{
+  auto old_size = size();
+  if (new_size <= old_size) {
+    truncate(new_size);
+    return;
+  }
+
+  if (old_size == 0 && new_size > capacity()) {
+    // There is nothing to preserve, so we can throw away the old buffer and
+    // ask the allocator for zeroed memory directly.
+    if (auto heap = on_heap()) {
+      alloc_->dealloc(heap->data(), layout::array<T>(capacity()));
+    }
+
+    auto new_data =
+      alloc_->zalloc(layout::array<T>(new_size)).cast(best::types<T>);
+    // construct_at instead of assignment, since raw_ may contain garbage.
+    std::construct_at(&raw_, new_data, new_size);
+    store_size(~new_size);
+    return;
+  }
+
+  resize_uninit(new_size);
+  std::memset((data() + old_size).raw(), 0,
+              (new_size - old_size) * best::size_of<T>);
+  set_size(unsafe("zeroable types are initialized by zeroing them"), new_size);
+}
+
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+void vec<T, max_inline, A, G>::truncate(size_t count) {
   if (count > size()) { return; }
   resize_uninit(count);
 }
-template <best::relocatable T, size_t max_inline, best::allocator A>
-void vec<T, max_inline, A>::clear() {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+void vec<T, max_inline, A, G>::clear() {
   if (!best::destructible<T, trivially>) {
     for (size_t i = 0; i < size(); ++i) { (data() + i).destroy(); }
   }
   set_size(unsafe("we just destroyed all elements"), 0);
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-best::option<T> vec<T, max_inline, A>::pop() {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+best::option<T> vec<T, max_inline, A, G>::pop() {
   if (is_empty()) { return best::none; }
   return remove(size() - 1);
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-T vec<T, max_inline, A>::remove(size_t idx) {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+T vec<T, max_inline, A, G>::remove(size_t idx) {
   T at = std::move(operator[](idx));
   erase({.start = idx, .count = 1});
   return at;
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-void vec<T, max_inline, A>::erase(best::bounds bounds) {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+void vec<T, max_inline, A, G>::erase(best::bounds bounds) {
   auto range = operator[](bounds);
   range.destroy();
 
@@ -797,26 +982,31 @@ void vec<T, max_inline, A>::erase(best::bounds bounds) {
            size() - range.size());
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-best::ptr<T> vec<T, max_inline, A>::insert_uninit(unsafe u, size_t start,
-                                                  size_t count) {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+best::ptr<T> vec<T, max_inline, A, G>::insert_uninit(unsafe u, size_t start,
+                                                     size_t count) {
   (void)as_span()[{.start = start}];  // Trigger a bounds check.
   if (count == 0) { return data() + start; }
 
-  // TODO(mcyoung): Ideally, this operation should be fused with reserve,
-  // since there are cases where we can perform a memmove as-we-go when we
-  // resize.
-  reserve(count);
-
-  /// Relocate elements to create an empty space.
-  auto end = start + count;
-  if (start < size()) { as_span().shift_within(u, end, start, size() - start); }
+  size_t new_size = size() + count;
+  if (new_size > capacity()) {
+    // Growing and opening up the gap are done in one pass, so that the tail is
+    // relocated only once, directly into its final position.
+    new_size = G::grow(on_heap() ? capacity() : 0, new_size,
+                       best::layout::of<T>());
+    regrow(new_size, false, start, count);
+  } else if (start < size()) {
+    // Relocate elements to create an empty space.
+    as_span().shift_within(u, start + count, start, size() - start);
+  }
   set_size(u, size() + count);
   return data() + start;
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-void vec<T, max_inline, A>::resize_uninit(size_t new_size) {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+void vec<T, max_inline, A, G>::resize_uninit(size_t new_size) {
   auto old_size = this->size();
   if (new_size <= capacity()) {
     if (new_size < old_size) {
@@ -833,9 +1023,10 @@ void vec<T, max_inline, A>::resize_uninit(size_t new_size) {
   spill_to_heap(new_size);
 }
 
-template <best::relocatable T, size_t max_inline, best::allocator A>
-void vec<T, max_inline, A>::spill_to_heap(best::option<size_t> capacity_hint,
-                                          bool exact) {
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+void vec<T, max_inline, A, G>::spill_to_heap(
+  best::option<size_t> capacity_hint, bool exact) {
   if ((on_heap() && !exact && capacity_hint <= capacity()) ||
       (on_heap() && capacity_hint < size()) ||
       (size() == 0 && !capacity_hint)) {
@@ -843,38 +1034,83 @@ void vec<T, max_inline, A>::spill_to_heap(best::option<size_t> capacity_hint,
   }
 
   size_t new_size = best::max(size(), capacity_hint.value_or(capacity()));
-  // Always snap to a power of 2.
-  if (!best::is_pow2(new_size) && (!exact || !capacity_hint)) {
-    new_size = best::next_pow2(new_size);
+  // If we don't hint at a capacity, use the policy's "good default".
+  if (!capacity_hint) { new_size = best::max(new_size, G::First); }
+  if (!exact || !capacity_hint) {
+    new_size = G::grow(on_heap() ? capacity() : 0, new_size,
+                       best::layout::of<T>());
   }
 
-  // If we don't hint at a capacity, pick 32 as a "good default".
-  if (size() < 32 && !capacity_hint) { new_size = 32; }
+  regrow(new_size, exact, size(), 0);
+}
 
-  auto old_layout = best::layout::array<T>(capacity());
-  auto new_layout = best::layout::array<T>(new_size);
+template <best::relocatable T, size_t max_inline, best::allocator A,
+          best::vec_growth G>
+void vec<T, max_inline, A, G>::regrow(size_t new_size, bool exact,
+                                      size_t gap_at, size_t gap_len) {
+  size_t old_size = size();
+  if constexpr (best::relocatable<T, trivially>) {
+    // Trivially relocatable types are moved with memcpy(), which does not
+    // depend on T, so we use an implementation shared by all such vectors.
+    auto buf = vec_internal::core<A>::regrow(
+      *alloc_,
+      {
+        .elem = best::layout::of<T>(),
+        .data = data().raw(),
+        .capacity = capacity(),
+        .size = old_size,
+        .on_heap = on_heap().has_value(),
+      },
+      new_size, exact, gap_at, gap_len);
 
-  // If we're on-heap, we can resize somewhat more intelligently.
-  if (on_heap() && best::relocatable<T, trivially>) {
-    auto grown = alloc_->realloc(data(), old_layout, new_layout);
     // construct_at instead of assignment, since raw_ may contain garbage.
-    std::construct_at(&raw_, grown.cast(best::types<T>), new_size);
-    return;
-  }
+    std::construct_at(&raw_, best::ptr<T>(static_cast<T*>(buf.data)),
+                      buf.capacity);
+    store_size(~old_size);  // Update the size to the "on heap" form.
+  } else {
+    size_t tail = old_size - gap_at;
+    auto old_layout = best::layout::array<T>(capacity());
+    auto new_layout = best::layout::array<T>(new_size);
+
+    // The allocator may hand us more memory than we asked for; if so, make it
+    // part of the capacity, unless the caller asked for an exact size.
+    auto capacity_of = [&](const best::allocation& a) {
+      if (exact) { return new_size; }
+      return best::max(new_size, a.size / best::size_of<T>);
+    };
+
+    // If the allocator can resize the buffer without moving it, the only thing
+    // that needs to move is the tail, to open up the gap.
+    if (on_heap()) {
+      auto old_data = data();
+      if (best::grow_in_place(*alloc_, old_data, old_layout, new_layout)) {
+        if (gap_len > 0 && tail > 0) {
+          (old_data + gap_at + gap_len)
+            .relo_overlapping(old_data + gap_at, tail);
+        }
+        // construct_at instead of assignment, since raw_ may contain garbage.
+        std::construct_at(&raw_, old_data, new_size);
+        return;
+      }
+    }
 
-  // In the general case, we need to allocate new memory, relocate the values,
-  // destroy the moved-from values, and free the old buffer if it is on-heap.
-  auto new_data = alloc_->alloc(new_layout).cast(best::types<T>);
+    // In the general case, we need to allocate new memory, relocate the values,
+    // destroy the moved-from values, and free the old buffer if it is on-heap.
+    // The prefix and the tail go directly to their final positions on either
+    // side of the gap, so each element is relocated exactly once.
+    auto fresh = best::alloc_at_least(*alloc_, new_layout);
+    auto new_data = fresh.ptr.cast(best::types<T>);
 
-  size_t old_size = size();
-  new_data.relo(data(), old_size);
-  if (on_heap()) { alloc_->dealloc(data(), old_layout); }
+    new_data.relo(data(), gap_at);
+    if (tail > 0) { (new_data + gap_at + gap_len).relo(data() + gap_at, tail); }
+    if (on_heap()) { alloc_->dealloc(data(), old_layout); }
 
-  // construct_at instead of assignment, since raw_ may contain garbage, so
-  // calling its operator= is UB.
-  std::construct_at(&raw_, new_data, new_size);
+    // construct_at instead of assignment, since raw_ may contain garbage, so
+    // calling its operator= is UB.
+    std::construct_at(&raw_, new_data, capacity_of(fresh));
 
-  store_size(~old_size);  // Update the size to the "on heap" form.
+    store_size(~old_size);  // Update the size to the "on heap" form.
+  }
 }
 }  // namespace best
 
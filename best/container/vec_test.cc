@@ -142,6 +142,58 @@ best::test Append = [](auto& t) {
   t.expect_eq(x2, {"bar", "baz", "foo", "bar", "bar", "baz"});
 };
 
+best::test GrowingInsert = [](auto& t) {
+  best::vec<int, 0> x0 = {0};
+  while (x0.size() < x0.capacity()) { x0.push(x0.size()); }
+  int n = x0.size();
+
+  // This forces a reallocation with a gap in the middle.
+  x0.splice(4, {-1, -2, -3});
+  t.expect_eq(x0.size(), n + 3);
+  t.expect_eq(x0[{.start = 2, .count = 7}], {2, 3, -1, -2, -3, 4, 5});
+  t.expect_eq(x0[n + 2], n - 1);
+
+  best::vec<best::strbuf, 0> x1 = {"foo", "bar"};
+  x1.shrink_to_fit();
+  x1.insert(1, "baz");
+  t.expect_eq(x1, {"foo", "baz", "bar"});
+};
+
+best::test Growth = [](auto& t) {
+  static_assert(best::grow_pow2<>::grow(0, 5, best::layout::of<int>()) == 8);
+  static_assert(best::grow_pow2<>::First == 32);
+  static_assert(best::grow_geometric<>::grow(64, 65, best::layout::of<int>()) ==
+                96);
+  static_assert(best::grow_exact::grow(64, 65, best::layout::of<int>()) == 65);
+  static_assert(best::grow_pages<>::grow(0, 1000, best::layout::of<int>()) ==
+                1024);
+  static_assert(
+    best::grow_pages<>::grow(0, 10, best::layout::array<char>(1000)) == 12);
+  static_assert(best::grow_pages<>::grow(0, best::max_of<size_t> / 2,
+                                         best::layout::of<int>()) ==
+                best::max_of<size_t> / 2);
+
+  // Only an unhinted spill uses the policy's first capacity.
+  best::vec<int, 0> x2;
+  x2.reserve(1);
+  t.expect_lt(x2.capacity(), 32);
+  best::vec<int> x3 = {1};
+  x3.spill_to_heap();
+  t.expect_ge(x3.capacity(), 32);
+
+  best::vec<int, 0, best::malloc, best::grow_exact> x0;
+  x0.reserve(5);
+  t.expect_ge(x0.capacity(), 5);
+  for (int i = 0; i < 100; ++i) { x0.push(i); }
+  t.expect_eq(x0.size(), 100);
+  t.expect_eq(x0[99], 99);
+
+  best::vec<int, 0, best::malloc, best::grow_geometric<>> x1;
+  for (int i = 0; i < 100; ++i) { x1.push(i); }
+  t.expect_eq(x1.size(), 100);
+  t.expect_eq(x1[99], 99);
+};
+
 best::test Leaky = [](auto& t) {
   LeakTest l_(t);
 
@@ -182,4 +234,24 @@ best::test NoInline = [](auto& t) {
   t.expect_eq(v.size(), 4);
   t.expect_eq(v, {1, 1, 2, 3});
 };
+
+best::test Zeroed = [](auto& t) {
+  auto v0 = best::vec<int>::zeroed(3);
+  t.expect_eq(v0, {0, 0, 0});
+
+  auto v1 = best::vec<int>::zeroed(1000);
+  t.expect_eq(v1.size(), 1000);
+  for (int x : v1) { t.expect_eq(x, 0); }
+
+  best::vec<int> v2 = {1, 2};
+  v2.resize_zeroed(5);
+  t.expect_eq(v2, {1, 2, 0, 0, 0});
+  v2.resize_zeroed(1);
+  t.expect_eq(v2, {1});
+
+  v2.clear();
+  v2.resize_zeroed(100);
+  t.expect_eq(v2.size(), 100);
+  t.expect_eq(v2[99], 0);
+};
 }  // namespace best::vec_test
@@ -0,0 +1,102 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_FUNC_FN_H_
+#define BEST_FUNC_FN_H_
+
+#include "best/func/internal/fn.h"
+
+//! Owning function values.
+//!
+//! A `best::fn` is an owning, type-erased callable. It is similar to a
+//! `std::function`, but it is move-only, and it stores small callables inline
+//! instead of on the heap.
+
+namespace best {
+/// # `best::fn<R(...) const>`
+///
+/// An owning function. You can construct a `best::fn` from a lambda, a function
+/// pointer, or any other callable; the callable is moved into the `best::fn`.
+///
+/// As with `best::fnref`, `Signature` must be some function type, such as
+/// `int()` or `void(int, int) const`. The `const` indicates whether the
+/// callable is invoked through a const reference, and thus whether a const
+/// `best::fn` can be called.
+///
+/// Callables that are at most `Capacity` bytes and trivially relocatable (this
+/// includes almost every lambda) are stored inline; others are allocated with
+/// `best::malloc`. Either way, a `best::fn` is trivially relocatable and is
+/// four pointers wide: a two-pointer inline buffer, a pointer to the calling
+/// thunk, and a pointer to the destructor (if any).
+///
+/// Unlike `std::function`, `best::fn` does not require the callable to be
+/// copyable, and cannot itself be copied. Calling a null `best::fn` crashes.
+template <typename Signature>
+class BEST_RELOCATABLE fn final
+  : best::traits_internal::tame<Signature>::template apply<fn_internal::impl> {
+ private:
+  using impl_t =
+    best::traits_internal::tame<Signature>::template apply<fn_internal::impl>;
+
+ public:
+  /// # `fn::output`
+  ///
+  /// The output of this function.
+  using output = impl_t::output;
+
+  /// # `fn::Capacity`
+  ///
+  /// The largest callable that can be stored inline.
+  static constexpr size_t Capacity = impl_t::Capacity;
+
+  /// # `fn::fits_inline<F>`
+  ///
+  /// Whether a callable of type `F` will be stored inline.
+  template <typename F>
+  static constexpr bool fits_inline = impl_t::template fits_inline<F>;
+
+  /// # `fn::is_const`
+  ///
+  /// Whether or not this is a "const" function.
+  static constexpr bool is_const = best::is_const_func<Signature>;
+  static_assert(!best::is_ref_func<Signature>,
+                "cannot use ref-qualified function types with best::fn");
+
+  /// # `fn::fn()`
+  ///
+  /// Constructs a new fn. It may be constructed from a callable, a function
+  /// pointer, or `nullptr`. The default value is null.
+  using impl_t::impl_t;
+
+  fn() = default;
+
+  /// # `fn()`
+  ///
+  /// Calls the function.
+  using impl_t::operator();
+
+  /// # `fn::operator==`
+  ///
+  /// `fn`s may be compared to `nullptr` (and no other pointer).
+  using impl_t::operator==;
+  using impl_t::operator bool;
+};
+}  // namespace best
+
+#endif  // BEST_FUNC_FN_H_
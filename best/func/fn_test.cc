@@ -0,0 +1,106 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/func/fn.h"
+
+#include "best/test/fodder.h"
+#include "best/test/test.h"
+
+namespace best::fn_test {
+using ::best_fodder::LeakTest;
+
+int add(int x) { return x + 42; }
+
+static_assert(sizeof(best::fn<void()>) == 4 * sizeof(void*));
+static_assert(best::relocatable<best::fn<void()>, best::trivially>);
+static_assert(!best::copyable<best::fn<void()>>);
+
+best::test FromFnptr = [](auto& t) {
+  best::fn<int(int) const> f = add;
+  t.expect(f != nullptr);
+  t.expect_eq(f(8), 50);
+
+  f = nullptr;
+  t.expect_eq(f, nullptr);
+
+  int (*null)(int) = nullptr;
+  f = null;
+  t.expect_eq(f, nullptr);
+
+  f = [](int x) { return x - 42; };
+  t.expect_eq(f(8), -34);
+};
+
+best::test FromLambda = [](auto& t) {
+  int total = 0;
+  best::fn<int(int) const> f = [&](int x) { return total += x; };
+  t.expect_eq(f(5), 5);
+  t.expect_eq(total, 5);
+
+  best::fn<int(int)> g = [y = 0](int x) mutable { return y += x; };
+  t.expect_eq(g(5), 5);
+  t.expect_eq(g(5), 10);
+
+  auto mut = [y = 0](int x) mutable { return y += x; };
+  static_assert(!requires { best::fn<int(int) const>(mut); });
+  static_assert(best::fn<int(int)>::fits_inline<decltype(mut)>);
+};
+
+best::test Spilled = [](auto& t) {
+  int big[16] = {};
+  big[15] = 3;
+  auto lambda = [big](int x) { return big[15] + x; };
+  static_assert(!best::fn<int(int)>::fits_inline<decltype(lambda)>);
+
+  best::fn<int(int) const> f = lambda;
+  t.expect_eq(f(4), 7);
+
+  auto g = BEST_MOVE(f);
+  t.expect_eq(f, nullptr);
+  t.expect_eq(g(5), 8);
+
+  f = [](int x) { return x; };
+  f = BEST_MOVE(g);
+  t.expect_eq(g, nullptr);
+  t.expect_eq(f(6), 9);
+};
+
+best::test MoveOnly = [](auto& t) {
+  best::fn<int()> f = [p = best_fodder::MoveOnly()] { return 42; };
+  auto g = BEST_MOVE(f);
+  t.expect_eq(g(), 42);
+
+  f = BEST_MOVE(g);
+  t.expect_eq(f(), 42);
+  t.expect_eq(g, nullptr);
+};
+
+best::test Leaky = [](auto& t) {
+  LeakTest l_(t);
+
+  using Bubble = LeakTest::Bubble;
+
+  best::fn<void()> f = [b = Bubble()] {};
+  f = [b = Bubble()] {};
+  auto g = BEST_MOVE(f);
+  g = [b = Bubble()] {};
+  f = BEST_MOVE(g);
+  f = nullptr;
+};
+}  // namespace best::fn_test
@@ -0,0 +1,161 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_FUNC_INTERNAL_FN_H_
+#define BEST_FUNC_INTERNAL_FN_H_
+
+#include <cstddef>
+#include <cstring>
+
+#include "best/base/hint.h"
+#include "best/func/call.h"
+#include "best/log/internal/crash.h"
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+#include "best/meta/init.h"
+#include "best/meta/traits/empty.h"
+#include "best/meta/traits/funcs.h"
+#include "best/meta/traits/objects.h"
+#include "best/meta/traits/refs.h"
+#include "best/meta/traits/types.h"
+
+namespace best::fn_internal {
+template <typename Func, typename R, typename... Args>
+class BEST_RELOCATABLE impl {
+ private:
+  static constexpr bool c = best::is_const_func<Func>;
+  using sig = best::select<c, R(Args...) const, R(Args...)>;
+
+ public:
+  using output = R;
+
+  static constexpr size_t Capacity = 2 * sizeof(void*);
+
+  template <typename F>
+  static constexpr bool fits_inline =
+    sizeof(F) <= Capacity && alignof(F) <= alignof(void*) &&
+    best::relocatable<F, best::trivially>;
+
+  constexpr impl() = default;
+  constexpr impl(std::nullptr_t) {}
+
+  impl(R (*fn)(Args...)) {
+    if (fn != nullptr) { emplace(fn); }
+  }
+
+  template <typename Fn>
+  impl(Fn&& fn) requires best::is_object<best::as_auto<Fn>> &&
+                         (!best::same<best::as_auto<Fn>, std::nullptr_t>) &&
+                         best::callable<best::as_auto<Fn>, sig>
+  {
+    emplace(BEST_FWD(fn));
+  }
+
+  impl(const impl&) = delete;
+  impl& operator=(const impl&) = delete;
+
+  impl(impl&& that)
+    : call_(std::exchange(that.call_, &die)),
+      drop_(std::exchange(that.drop_, nullptr)) {
+    // Everything we store inline is trivially relocatable, and so is the
+    // pointer to a spilled callable.
+    std::memcpy(buf_, that.buf_, Capacity);
+  }
+  impl& operator=(impl&& that) {
+    if (this == &that) { return *this; }
+    release();
+    call_ = std::exchange(that.call_, &die);
+    drop_ = std::exchange(that.drop_, nullptr);
+    std::memcpy(buf_, that.buf_, Capacity);
+    return *this;
+  }
+
+  ~impl() { release(); }
+
+  BEST_INLINE_ALWAYS R operator()(Args... args) const requires c
+  {
+    return call_(const_cast<char*>(buf_), BEST_FWD(args)...);
+  }
+  BEST_INLINE_ALWAYS R operator()(Args... args) {
+    return call_(buf_, BEST_FWD(args)...);
+  }
+
+  constexpr bool operator==(std::nullptr_t) const { return call_ == &die; }
+  constexpr explicit operator bool() const { return *this != nullptr; }
+
+ private:
+  template <typename F>
+  using self = best::select<c, const F, F>;
+
+  [[noreturn]] static R die(void*, Args...) {
+    best::crash_internal::crash("called a null best::fn");
+  }
+
+  template <typename F>
+  static R invoke(F& f, Args... args) {
+    if constexpr (best::is_void<R>) {
+      best::call(f, BEST_FWD(args)...);
+    } else {
+      return best::call(f, BEST_FWD(args)...);
+    }
+  }
+
+  // Destroys the held callable, if any, leaving this function null.
+  void release() {
+    if (drop_ != nullptr) { drop_(buf_); }
+    call_ = &die;
+    drop_ = nullptr;
+  }
+
+  template <typename Fn>
+  void emplace(Fn&& fn) {
+    using F = best::as_auto<Fn>;
+    if constexpr (fits_inline<F>) {
+      new (buf_) F(BEST_FWD(fn));
+      call_ = +[](void* p, Args... args) -> R {
+        return invoke(*static_cast<self<F>*>(p), BEST_FWD(args)...);
+      };
+      if constexpr (!best::destructible<F, best::trivially>) {
+        drop_ = +[](void* p) { static_cast<F*>(p)->~F(); };
+      }
+    } else {
+      heap_ = best::malloc::alloc(best::layout::of<F>()).raw();
+      new (heap_) F(BEST_FWD(fn));
+      call_ = +[](void* p, Args... args) -> R {
+        auto* f = static_cast<self<F>*>(*static_cast<void**>(p));
+        return invoke(*f, BEST_FWD(args)...);
+      };
+      drop_ = +[](void* p) {
+        auto* f = static_cast<F*>(*static_cast<void**>(p));
+        f->~F();
+        best::malloc::dealloc(f, best::layout::of<F>());
+      };
+    }
+  }
+
+  union {
+    alignas(void*) char buf_[Capacity];
+    void* heap_;
+  };
+  R (*call_)(void*, Args...) = &die;
+  void (*drop_)(void*) = nullptr;
+};
+}  // namespace best::fn_internal
+
+#endif  // BEST_FUNC_INTERNAL_FN_H_
@@ -0,0 +1,97 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/hash/hash.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "best/memory/span.h"
+
+namespace best {
+namespace {
+// More digits of pi, used to decorrelate the independent lanes of the bulk
+// loop in write_bytes().
+constexpr uint64_t Lanes[4] = {
+  0xa4093822299f31d0,
+  0x082efa98ec4e6c89,
+  0x452821e638d01377,
+  0xbe5466cf34e90c6c,
+};
+
+uint64_t load64(const char* p) {
+  uint64_t word;
+  std::memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+uint64_t load32(const char* p) {
+  uint32_t word;
+  std::memcpy(&word, p, sizeof(word));
+  return word;
+}
+}  // namespace
+
+void hasher::write_bytes(best::span<const char> bytes) {
+  const char* p = bytes.data().raw();
+  size_t len = bytes.size();
+
+  // Small inputs are read with (possibly overlapping) loads from either end,
+  // so that there is no loop at all. This is the common case for hash table
+  // keys.
+  uint64_t a = 0, b = 0;
+  if (len <= 16) {
+    if (len >= 8) {
+      a = load64(p);
+      b = load64(p + len - 8);
+    } else if (len >= 4) {
+      a = load32(p);
+      b = load32(p + len - 4);
+    } else if (len > 0) {
+      a = uint64_t(uint8_t(p[0])) << 16 | uint64_t(uint8_t(p[len / 2])) << 8 |
+          uint64_t(uint8_t(p[len - 1]));
+    }
+    state_ = mix(a ^ Lanes[0], b ^ state_);
+    write(len);
+    return;
+  }
+
+  // Large inputs are processed 64 bytes at a time, in four independent lanes
+  // that the CPU can execute in parallel.
+  const char* end = p + len;
+  if (len > 64) {
+    uint64_t lanes[4] = {state_, state_, state_, state_};
+    for (; end - p > 64; p += 64) {
+      for (size_t i = 0; i < 4; ++i) {
+        lanes[i] = mix(load64(p + 16 * i) ^ Lanes[i],
+                       load64(p + 16 * i + 8) ^ lanes[i]);
+      }
+    }
+    state_ = lanes[0] ^ lanes[1] ^ lanes[2] ^ lanes[3];
+  }
+
+  // Then, the remaining 1 to 64 bytes are processed 16 at a time; the last
+  // chunk overlaps the one before it if the length is not a multiple of 16.
+  for (; end - p > 16; p += 16) {
+    state_ = mix(load64(p) ^ Lanes[0], load64(p + 8) ^ state_);
+  }
+  state_ = mix(load64(end - 16) ^ Lanes[1], load64(end - 8) ^ state_);
+  write(len);
+}
+}  // namespace best
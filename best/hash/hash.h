@@ -0,0 +1,201 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_HASH_HASH_H_
+#define BEST_HASH_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "best/memory/span.h"
+#include "best/meta/traits/ptrs.h"
+#include "best/meta/traits/quals.h"
+
+//! Hashing.
+//!
+//! `best::hash()` computes a 64-bit hash of any hashable value. The hash is
+//! deterministic, fast, and well-mixed, which makes it suitable for hash
+//! tables, but it is not a cryptographic hash.
+//!
+//! Values can make themselves hashable by implementing the `BestHash()`
+//! FTADLE, which feeds everything that participates in equality into the
+//! hasher:
+//!
+//! ```
+//! friend void BestHash(auto& hasher, const MyType& self) {
+//!   hasher.hash(self.x);
+//!   hasher.hash(self.name);
+//! }
+//! ```
+//!
+//! Values that compare equal must produce equal hashes. This means, for
+//! example, that a `best::str` and a `best::strbuf` with the same contents
+//! hash the same, so that either can be used to look up the other. For the
+//! same reason, string literals and pointers to characters hash like the
+//! strings they spell, and ranges of integers hash by value, regardless of
+//! the integer type. Strings in different encodings, which compare equal
+//! rune-by-rune, are the exception: they hash by code unit, and should not
+//! be mixed in one table.
+//!
+//! Implementations are provided for primitive types, contiguous ranges (such
+//! as spans, vectors, and strings), `best::row`, `best::option`,
+//! `best::choice`, and any reflected struct (see `best::reflect`).
+
+namespace best {
+class hasher;
+
+/// # `best::hashable`
+///
+/// Whether a type can be hashed.
+template <typename T>
+concept hashable =
+  requires(best::hasher& hasher, const T& value) { BestHash(hasher, value); };
+
+namespace hash_internal {
+// Character types that C strings are made of.
+template <typename T>
+concept is_code = best::same<best::un_qual<T>, char> ||
+                  best::same<best::un_qual<T>, char8_t> ||
+                  best::same<best::un_qual<T>, char16_t> ||
+                  best::same<best::un_qual<T>, char32_t> ||
+                  best::same<best::un_qual<T>, wchar_t>;
+
+template <typename T>
+concept int_like = std::is_integral_v<T> || std::is_enum_v<T>;
+
+template <typename Q, typename K>
+concept same_elems =
+  best::contiguous<Q> && best::contiguous<K> &&
+  best::same<best::un_qual<best::data_type<Q>>,
+             best::un_qual<best::data_type<K>>>;
+
+template <typename Q, typename K>
+concept c_str_of = best::is_raw_ptr<Q> && best::contiguous<K> &&
+                   is_code<best::un_raw_ptr<Q>> &&
+                   best::same<best::un_qual<best::un_raw_ptr<Q>>,
+                              best::un_qual<best::data_type<K>>>;
+}  // namespace hash_internal
+
+/// # `best::hash_compatible<Q, K>`
+///
+/// Whether a `Q` that compares equal to a `K` is guaranteed to hash the same
+/// as it. This is what makes `Q` usable for looking up `K`s in a hash table.
+///
+/// This holds when `Q` and `K` are the same type or both integers, when they
+/// are contiguous ranges of the same element type (such as `best::str`,
+/// `best::strbuf`, and string literals), and when `Q` is a C string of `K`'s
+/// element type.
+template <typename Q, typename K>
+concept hash_compatible =
+  best::hashable<Q> && best::hashable<K> && best::equatable<K, Q> &&
+  (best::same<best::as_auto<Q>, best::as_auto<K>> ||
+   (hash_internal::int_like<Q> && hash_internal::int_like<K>) ||
+   hash_internal::same_elems<Q, K> || hash_internal::c_str_of<Q, K>);
+
+/// # `best::hasher`
+///
+/// The state of an in-progress hash. Values are fed into it with `hash()`, and
+/// the final hash is obtained with `finish()`.
+///
+/// Hashers themselves provide two primitive operations: `write()`, which
+/// mixes in a single 64-bit word, and `write_bytes()`, which mixes in a byte
+/// string in bulk.
+class hasher final {
+ public:
+  /// # `hasher::Seed`
+  ///
+  /// The seed used by `hasher()` and `best::hash()`.
+  static constexpr uint64_t Seed = 0x243f6a8885a308d3;
+
+  /// # `hasher::hasher()`
+  ///
+  /// Creates a new hasher with the given seed. Different seeds produce
+  /// unrelated hashes for the same value.
+  constexpr hasher() = default;
+  constexpr explicit hasher(uint64_t seed) : state_(seed) {}
+
+  /// # `hasher::hash()`
+  ///
+  /// Mixes a hashable value into this hasher.
+  hasher& hash(const best::hashable auto& value) {
+    BestHash(*this, value);
+    return *this;
+  }
+
+  /// # `hasher::write()`
+  ///
+  /// Mixes a single word into this hasher.
+  constexpr void write(uint64_t word) {
+    state_ = mix(state_ ^ word, Multiplier);
+  }
+
+  /// # `hasher::write_bytes()`
+  ///
+  /// Mixes an arbitrary byte string into this hasher. This is much faster than
+  /// calling `write()` for each byte or word. The length of `bytes` is hashed
+  /// too, so that, e.g., hashing `"ab"` then `"c"` differs from hashing `"a"`
+  /// then `"bc"`.
+  void write_bytes(best::span<const char> bytes);
+
+  /// # `hasher::finish()`
+  ///
+  /// Returns the hash of everything written so far.
+  constexpr uint64_t finish() const { return mix(state_, Finisher); }
+
+ private:
+  static constexpr uint64_t Multiplier = 0x5851f42d4c957f2d;
+  static constexpr uint64_t Finisher = 0x13198a2e03707344;
+
+  // Multiplies two words into a 128-bit product, and XORs its halves together.
+  // This is the core of the hash function: a single multiplication
+  // thoroughly mixes every bit of both inputs.
+  static constexpr uint64_t mix(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    auto product = static_cast<unsigned __int128>(a) * b;
+    return static_cast<uint64_t>(product) ^
+           static_cast<uint64_t>(product >> 64);
+#else
+    uint64_t a_lo = a & 0xffffffff, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xffffffff, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+    uint64_t hi = hi_hi + (hi_lo >> 32) + (cross >> 32);
+    uint64_t lo = (cross << 32) | (lo_lo & 0xffffffff);
+    return lo ^ hi;
+#endif
+  }
+
+  uint64_t state_ = Seed;
+};
+
+/// # `best::hash()`
+///
+/// Hashes a value with a fresh `best::hasher`.
+inline uint64_t hash(const best::hashable auto& value,
+                     uint64_t seed = best::hasher::Seed) {
+  return best::hasher(seed).hash(value).finish();
+}
+}  // namespace best
+
+#include "best/hash/internal/hash_impls.h"
+
+#endif  // BEST_HASH_HASH_H_
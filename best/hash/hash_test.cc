@@ -0,0 +1,132 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/hash/hash.h"
+
+#include "best/container/choice.h"
+#include "best/container/option.h"
+#include "best/container/row.h"
+#include "best/container/vec.h"
+#include "best/test/test.h"
+#include "best/text/str.h"
+#include "best/text/strbuf.h"
+
+namespace best::hash_test {
+struct Point final {
+  int x, y;
+  best::str name;
+
+  constexpr friend auto BestReflect(auto& m, Point*) { return m.infer(); }
+  bool operator==(const Point&) const = default;
+};
+
+struct Custom final {
+  int key;
+  int cache = 0;  // Not part of equality.
+
+  friend void BestHash(auto& hasher, const Custom& self) {
+    hasher.hash(self.key);
+  }
+};
+
+static_assert(best::hashable<int>);
+static_assert(best::hashable<best::str>);
+static_assert(best::hashable<best::vec<int>>);
+static_assert(best::hashable<best::row<int, best::str>>);
+static_assert(best::hashable<best::option<int>>);
+static_assert(best::hashable<best::choice<int, best::str>>);
+static_assert(best::hashable<Point>);
+static_assert(best::hashable<Custom>);
+static_assert(!best::hashable<double>);
+
+best::test Ints = [](auto& t) {
+  t.expect_eq(best::hash(42), best::hash(42));
+  t.expect_ne(best::hash(42), best::hash(43));
+  t.expect_ne(best::hash(0), best::hash(0, 1));
+
+  // Integers hash by value, regardless of type.
+  t.expect_eq(best::hash(42), best::hash(uint8_t{42}));
+  t.expect_eq(best::hash(-1), best::hash(int64_t{-1}));
+};
+
+best::test Strings = [](auto& t) {
+  best::str s = "a string that is long enough to take the bulk path, probably";
+  best::strbuf buf = s;
+  t.expect_eq(best::hash(s), best::hash(buf));
+  t.expect_ne(best::hash(s), best::hash(best::str("a string")));
+
+  // Literals and C strings hash like the strings they spell.
+  const char* c_str = "foo";
+  t.expect_eq(best::hash("foo"), best::hash(best::str("foo")));
+  t.expect_eq(best::hash(c_str), best::hash(best::strbuf("foo")));
+
+  // Every length up to well past the bulk loop, and every single-byte change,
+  // should produce a different hash.
+  best::vec<uint64_t> hashes;
+  for (size_t len = 0; len <= 200; ++len) {
+    best::vec<char> bytes;
+    for (size_t i = 0; i < len; ++i) { bytes.push('a'); }
+    hashes.push(best::hash(bytes));
+
+    for (size_t i = 0; i < len; ++i) {
+      bytes[i] = 'b';
+      hashes.push(best::hash(bytes));
+      bytes[i] = 'a';
+    }
+  }
+  hashes->sort();
+  for (size_t i = 1; i < hashes.size(); ++i) {
+    t.expect_ne(hashes[i - 1], hashes[i]);
+  }
+};
+
+best::test Containers = [](auto& t) {
+  t.expect_eq(best::hash(best::vec{1, 2, 3}), best::hash(best::vec{1, 2, 3}));
+  t.expect_ne(best::hash(best::vec{1, 2, 3}), best::hash(best::vec{3, 2, 1}));
+
+  // Ranges of integers hash by value, like integers do, whether or not every
+  // value fits in a byte.
+  best::vec<int> ints = {1, -2, 3};
+  best::vec<long> longs = {1, -2, 3};
+  best::vec<signed char> bytes = {1, -2, 3};
+  t.expect_eq(best::hash(ints), best::hash(longs));
+  t.expect_eq(best::hash(ints), best::hash(bytes));
+  ints.push(1000);
+  longs.push(1000);
+  t.expect_eq(best::hash(ints), best::hash(longs));
+
+  t.expect_ne(best::hash(best::option<int>()), best::hash(best::option(0)));
+  t.expect_eq(best::hash(best::option(5)), best::hash(best::option(5)));
+
+  best::row<int, best::str> r1 = {1, "foo"}, r2 = {1, "bar"};
+  t.expect_ne(best::hash(r1), best::hash(r2));
+
+  best::choice<int, int> c1(best::index<0>, 5), c2(best::index<1>, 5);
+  t.expect_ne(best::hash(c1), best::hash(c2));
+};
+
+best::test Structs = [](auto& t) {
+  t.expect_eq(best::hash(Point{1, 2, "p"}), best::hash(Point{1, 2, "p"}));
+  t.expect_ne(best::hash(Point{1, 2, "p"}), best::hash(Point{2, 1, "p"}));
+  t.expect_ne(best::hash(Point{1, 2, "p"}), best::hash(Point{1, 2, "q"}));
+
+  t.expect_eq(best::hash(Custom{1, 2}), best::hash(Custom{1, 3}));
+  t.expect_eq(best::hash(Custom{1}), best::hash(1));
+};
+}  // namespace best::hash_test
@@ -0,0 +1,160 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_HASH_INTERNAL_HASH_IMPLS_H_
+#define BEST_HASH_INTERNAL_HASH_IMPLS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "best/math/int.h"
+#include "best/memory/internal/bytes.h"
+#include "best/memory/span.h"
+#include "best/meta/reflect.h"
+#include "best/meta/traits/arrays.h"
+#include "best/meta/traits/enums.h"
+#include "best/meta/traits/quals.h"
+
+//! Hashing impls for types that don't have a clear other place to live.
+
+namespace best {
+void BestHash(auto& hasher, best::same<bool> auto value) {
+  hasher.write(value);
+}
+
+void BestHash(auto& hasher, best::is_int auto value) {
+  // NOTE: this sign-extends, so that equal values of different integer types
+  // hash the same.
+  hasher.write(static_cast<uint64_t>(value));
+}
+
+void BestHash(auto& hasher, best::is_enum auto value) {
+  hasher.hash(static_cast<std::underlying_type_t<decltype(value)>>(value));
+}
+
+// Character types other than the char types, such as char32_t.
+template <typename T>
+void BestHash(auto& hasher, T value)
+  requires std::is_integral_v<T> && (!best::is_int<T>) &&
+           (!best::same<T, bool>)
+{
+  hasher.write(static_cast<uint64_t>(value));
+}
+
+namespace hash_internal {
+// The value of an integer as written by its BestHash() impl.
+template <int_like T>
+uint64_t widen(T value) {
+  if constexpr (std::is_enum_v<T>) {
+    return static_cast<uint64_t>(static_cast<std::underlying_type_t<T>>(value));
+  } else {
+    return static_cast<uint64_t>(value);
+  }
+}
+
+// Hashes a range of integers by value, so that ranges of different integer
+// types that compare equal also hash equal.
+//
+// The range is hashed in fixed-size chunks. A chunk whose values all fit in a
+// signed byte is written as bytes, and any other chunk is written as words.
+// Which form a chunk takes depends only on its values, so this produces the
+// same hash for every element type, while ranges of bytes (i.e., strings)
+// still take the bulk path without any copying.
+template <int_like T>
+void hash_ints(auto& hasher, best::span<const T> span) {
+  constexpr size_t Chunk = 128;
+  hasher.write(span.size());
+  for (size_t i = 0; i < span.size(); i += Chunk) {
+    const T* p = span.data().raw() + i;
+    size_t n = best::min(Chunk, span.size() - i);
+    if constexpr (sizeof(T) == 1 && std::is_signed_v<T>) {
+      hasher.write_bytes(
+        best::span<const char>(reinterpret_cast<const char*>(p), n));
+      continue;
+    }
+
+    bool narrow = true;
+    for (size_t j = 0; j < n && narrow; ++j) {
+      narrow = widen(p[j]) + 128 < 256;
+    }
+
+    if (narrow) {
+      char bytes[Chunk];
+      for (size_t j = 0; j < n; ++j) { bytes[j] = static_cast<char>(p[j]); }
+      hasher.write_bytes(best::span<const char>(bytes, n));
+    } else {
+      uint64_t words[Chunk];
+      for (size_t j = 0; j < n; ++j) { words[j] = widen(p[j]); }
+      hasher.write_bytes(best::span<const char>(
+        reinterpret_cast<const char*>(words), n * sizeof(uint64_t)));
+    }
+  }
+}
+}  // namespace hash_internal
+
+// Pointers to characters are assumed to be C strings, and are hashed like the
+// string they point to, since e.g. `best::strbuf` can be compared with them.
+// This takes a reference so that arrays prefer the contiguous impl below.
+template <typename T>
+void BestHash(auto& hasher, T* const& value) {
+  if constexpr (hash_internal::is_code<T>) {
+    hasher.hash(best::span<T>::from_nul(value));
+  } else {
+    hasher.write(reinterpret_cast<uintptr_t>(value));
+  }
+}
+
+template <best::contiguous R>
+void BestHash(auto& hasher, const R& range)
+  requires requires { hasher.hash(*best::data(range)); }
+{
+  using T = best::data_type<R>;
+
+  // Arrays of characters are assumed to be string literals, whose NUL is
+  // dropped, as `best::str` does.
+  size_t size = best::size(range);
+  if constexpr (best::is_array<R> && hash_internal::is_code<T>) { --size; }
+  best::span<const T> span(best::data(range), size);
+
+  // Ranges of integers can be compared with ranges of any other integer type,
+  // so they are hashed by value. Other ranges of values whose equality is just
+  // memcmp() can be hashed as bytes, which is much faster than hashing them
+  // one-by-one.
+  if constexpr (hash_internal::int_like<best::un_qual<T>>) {
+    hash_internal::hash_ints(hasher, best::span<const best::un_qual<T>>(span));
+  } else if constexpr (best::bytes_internal::byte_comparable<T>) {
+    hasher.write_bytes(best::span<const char>(
+      reinterpret_cast<const char*>(span.data().raw()),
+      span.size() * sizeof(T)));
+  } else {
+    hasher.write(span.size());
+    for (const auto& value : span) { hasher.hash(value); }
+  }
+}
+
+void BestHash(auto& hasher, const best::is_reflected_struct auto& value)
+  requires (!best::contiguous<decltype(value)>)
+{
+  auto refl = best::reflect<decltype(value)>;
+  refl.each([&](auto field) { hasher.hash(value->*field); });
+}
+}  // namespace best
+
+#endif  // BEST_HASH_INTERNAL_HASH_IMPLS_H_
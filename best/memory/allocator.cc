@@ -27,6 +27,13 @@
 #include "best/log/internal/crash.h"
 #include "best/memory/layout.h"
 
+#if BEST_HAS_INCLUDE(<malloc.h>) && defined(__linux__)
+#include <malloc.h>
+#define BEST_MALLOC_USABLE_SIZE_ 1
+#else
+#define BEST_MALLOC_USABLE_SIZE_ 0
+#endif
+
 namespace best {
 namespace {
 constexpr size_t MaxAlign = alignof(::max_align_t);
@@ -79,6 +86,23 @@ void check_addr(best::ptr<void> p) {
       "attempted to de/reallocate a dangling pointer");
   }
 }
+
+// Returns the number of bytes usable at `p`, which was returned by `::malloc()`
+// for `layout`.
+size_t usable_size(best::ptr<void> p, best::layout layout) {
+  if (UseCookies) {
+    // The cookie records the requested layout exactly, so we can't hand out
+    // any slack without tripping check_layout().
+    return layout.size();
+  }
+#if BEST_MALLOC_USABLE_SIZE_
+  // Round down, so that the result is still a valid size for a layout.
+  return ::malloc_usable_size(p.raw()) & ~(layout.align() - 1);
+#else
+  (void)p;
+  return layout.size();
+#endif
+}
 }  // namespace
 
 best::ptr<void> malloc::alloc(best::layout layout) {
@@ -163,4 +187,25 @@ void malloc::dealloc(best::ptr<void> ptr, best::layout layout) {
   }
   ::free(ptr.raw());
 }
+
+best::allocation malloc::alloc_at_least(best::layout layout) {
+  auto p = alloc(layout);
+  return {p, usable_size(p, layout)};
+}
+
+best::allocation malloc::realloc_at_least(best::ptr<void> ptr,
+                                          best::layout old,
+                                          best::layout layout) {
+  auto p = realloc(ptr, old, layout);
+  return {p, usable_size(p, layout)};
+}
+
+bool malloc::grow_in_place(best::ptr<void> ptr, best::layout old,
+                           best::layout layout) {
+  check_addr(ptr);
+  if (UseCookies || ptr.to_addr() % layout.align() != 0) { return false; }
+  // Shrinks go through realloc(), which can actually hand memory back.
+  if (layout.size() <= old.size()) { return false; }
+  return layout.size() <= usable_size(ptr, old);
+}
 }  // namespace best
@@ -78,8 +78,91 @@ concept allocator =  //
     /// The second argument is the original layout it was allocated with.
     /// Crashes on allocation failure.
     { alloc.dealloc(ptr, layout) };
+
+    /// Allocators may additionally provide any of the following functions,
+    /// which are accessed through the free functions of the same name; see
+    /// their documentation for details.
+    ///
+    /// ```
+    /// best::allocation alloc_at_least(best::layout layout);
+    /// best::allocation realloc_at_least(best::ptr<void> ptr, best::layout old,
+    ///                                   best::layout layout);
+    /// bool grow_in_place(best::ptr<void> ptr, best::layout old,
+    ///                    best::layout layout);
+    /// ```
   };
 
+/// # `best::allocation`
+///
+/// A block of memory returned by `best::alloc_at_least()`, along with the
+/// number of bytes that are actually usable in it.
+struct allocation final {
+  best::ptr<void> ptr;
+  size_t size = 0;
+};
+
+/// # `best::alloc_at_least()`
+///
+/// Allocates memory for `layout`, but returns the size of the block actually
+/// obtained, which may be larger than `layout.size()`. This allows callers to
+/// make use of slack that the allocator would otherwise waste.
+///
+/// When passing the resulting pointer back to the allocator, the layout may
+/// have any size between `layout.size()` and the returned size.
+///
+/// If `A` does not provide `alloc_at_least()`, this calls `alloc()` and returns
+/// exactly `layout.size()`.
+template <best::allocator A>
+best::allocation alloc_at_least(A& alloc, best::layout layout) {
+  if constexpr (requires {
+                  {
+                    alloc.alloc_at_least(layout)
+                  } -> std::same_as<best::allocation>;
+                }) {
+    return alloc.alloc_at_least(layout);
+  } else {
+    return {alloc.alloc(layout), layout.size()};
+  }
+}
+
+/// # `best::realloc_at_least()`
+///
+/// Like `best::alloc_at_least()`, but for `realloc()`.
+template <best::allocator A>
+best::allocation realloc_at_least(A& alloc, best::ptr<void> ptr,
+                                  best::layout old, best::layout layout) {
+  if constexpr (requires {
+                  {
+                    alloc.realloc_at_least(ptr, old, layout)
+                  } -> std::same_as<best::allocation>;
+                }) {
+    return alloc.realloc_at_least(ptr, old, layout);
+  } else {
+    return {alloc.realloc(ptr, old, layout), layout.size()};
+  }
+}
+
+/// # `best::grow_in_place()`
+///
+/// Attempts to resize an allocation without moving it. Returns whether this
+/// succeeded; on success, the allocation now has layout `layout`, and on
+/// failure, it is unchanged.
+///
+/// If `A` does not provide `grow_in_place()`, this always fails.
+template <best::allocator A>
+bool grow_in_place(A& alloc, best::ptr<void> ptr, best::layout old,
+                   best::layout layout) {
+  if constexpr (requires {
+                  {
+                    alloc.grow_in_place(ptr, old, layout)
+                  } -> std::same_as<bool>;
+                }) {
+    return alloc.grow_in_place(ptr, old, layout);
+  } else {
+    return false;
+  }
+}
+
 /// # `best::malloc`
 ///
 /// The global allocator.
@@ -87,6 +170,13 @@ concept allocator =  //
 /// Note that this calls into `malloc()`, not `::operator new`, in order to
 /// permit resizing-in-place (which C++, in TYOL 2024, does not allow?!).
 ///
+/// Where the platform provides `malloc_usable_size()`, the `*_at_least()`
+/// functions report the true size of the block `malloc()` returned, and
+/// `grow_in_place()` succeeds when the block already has enough slack; it never
+/// succeeds for a shrink, so that `realloc()` can return memory. In debug
+/// mode, these report no slack, so that the layout cookies can still detect
+/// mismatched frees.
+///
 /// See `best::allocator` for information on what the functions on this type do.
 struct malloc final {
   static best::ptr<void> alloc(layout layout);
@@ -95,6 +185,11 @@ struct malloc final {
                                  layout layout);
   static void dealloc(best::ptr<void> ptr, layout layout);
 
+  static best::allocation alloc_at_least(layout layout);
+  static best::allocation realloc_at_least(best::ptr<void> ptr, layout old,
+                                           layout layout);
+  static bool grow_in_place(best::ptr<void> ptr, layout old, layout layout);
+
   constexpr bool operator==(const malloc&) const = default;
 };
 static_assert(best::allocator<best::malloc>);
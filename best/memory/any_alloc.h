@@ -0,0 +1,160 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_MEMORY_ANY_ALLOC_H_
+#define BEST_MEMORY_ANY_ALLOC_H_
+
+#include "best/func/dyn.h"
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+#include "best/memory/ptr.h"
+#include "best/meta/traits/empty.h"
+#include "best/meta/traits/types.h"
+
+//! Type-erased allocators.
+//!
+//! `best::any_alloc` allows choosing an allocator at runtime without changing
+//! the type of the containers that use it: a single instantiation of
+//! `best::vec<T, N, best::any_alloc>` can be backed by `best::malloc`, a
+//! `best::arena`, a `best::pool_alloc`, and so on.
+//!
+//! ```
+//! best::arena arena;
+//! best::vec<int, 8, best::any_alloc> ints(arena);
+//! ```
+
+namespace best {
+/// # `best::dyn_allocator`
+///
+/// The `best::interface` for allocators. Every `best::allocator` implements
+/// it; the optional allocator functions are defaulted the same way the free
+/// functions in `allocator.h` are.
+class dyn_allocator final : public best::interface_base<dyn_allocator> {
+ public:
+  BEST_INTERFACE(dyn_allocator,
+                 (best::ptr<void>, alloc, (best::layout layout)),
+                 (best::ptr<void>, zalloc, (best::layout layout)),
+                 (best::ptr<void>, realloc,
+                  (best::ptr<void> ptr, best::layout old, best::layout layout)),
+                 (void, dealloc, (best::ptr<void> ptr, best::layout layout)),
+                 (best::allocation, alloc_at_least, (best::layout layout)),
+                 (best::allocation, realloc_at_least,
+                  (best::ptr<void> ptr, best::layout old, best::layout layout)),
+                 (bool, grow_in_place,
+                  (best::ptr<void> ptr, best::layout old, best::layout layout)));
+
+ private:
+  best::allocation alloc_at_least(best::defaulted, best::layout layout) {
+    return {alloc(layout), layout.size()};
+  }
+  best::allocation realloc_at_least(best::defaulted, best::ptr<void> ptr,
+                                    best::layout old, best::layout layout) {
+    return {realloc(ptr, old, layout), layout.size()};
+  }
+  bool grow_in_place(best::defaulted, best::ptr<void>, best::layout,
+                     best::layout) {
+    return false;
+  }
+};
+
+/// # `best::any_alloc`
+///
+/// A type-erased reference to an allocator.
+///
+/// An `any_alloc` is two pointers wide: one to the allocator and one to its
+/// vtable. It can be constructed from a reference to any allocator (which must
+/// outlive it), or from a value of a stateless allocator type, such as
+/// `best::malloc`. A default-constructed `any_alloc` uses `best::malloc`.
+///
+/// Calls through an `any_alloc` are indirect calls, but containers only call
+/// their allocator when they actually touch the heap; for example, a
+/// `best::vec` that fits in its inline storage never calls it at all.
+///
+/// Two `any_alloc`s are equal if they refer to the same allocator object.
+class any_alloc final {
+ public:
+  /// # `any_alloc::any_alloc()`
+  ///
+  /// Refers to `best::malloc`.
+  any_alloc() : any_alloc(best::malloc{}) {}
+
+  /// # `any_alloc::any_alloc(A&)`
+  ///
+  /// Refers to an existing allocator object.
+  template <typename A>
+  any_alloc(A& alloc)
+    requires (!best::same<A, any_alloc>) && (!best::is_empty<A>) &&
+             best::implements<A, dyn_allocator>
+    : ptr_(best::addr(alloc)) {}
+
+  /// # `any_alloc::any_alloc(A)`
+  ///
+  /// Refers to a stateless allocator type. Since all values of such a type
+  /// are interchangeable, this refers to a global instance of it.
+  template <typename A>
+  any_alloc(A)
+    requires (!best::same<A, any_alloc>) && best::is_empty<A> &&
+             best::allocator<A> && best::implements<A, dyn_allocator>
+    : ptr_(best::addr(stateless<A>)) {}
+
+  /// # `any_alloc::get()`
+  ///
+  /// Returns the underlying type-erased allocator.
+  best::dynptr<dyn_allocator> get() const { return ptr_; }
+
+  best::ptr<void> alloc(best::layout layout) const {
+    return ptr_->alloc(layout);
+  }
+  best::ptr<void> zalloc(best::layout layout) const {
+    return ptr_->zalloc(layout);
+  }
+  best::ptr<void> realloc(best::ptr<void> ptr, best::layout old,
+                          best::layout layout) const {
+    return ptr_->realloc(ptr, old, layout);
+  }
+  void dealloc(best::ptr<void> ptr, best::layout layout) const {
+    ptr_->dealloc(ptr, layout);
+  }
+
+  best::allocation alloc_at_least(best::layout layout) const {
+    return ptr_->alloc_at_least(layout);
+  }
+  best::allocation realloc_at_least(best::ptr<void> ptr, best::layout old,
+                                    best::layout layout) const {
+    return ptr_->realloc_at_least(ptr, old, layout);
+  }
+  bool grow_in_place(best::ptr<void> ptr, best::layout old,
+                     best::layout layout) const {
+    return ptr_->grow_in_place(ptr, old, layout);
+  }
+
+  bool operator==(const any_alloc& that) const {
+    return ptr_.raw() == that.ptr_.raw();
+  }
+
+ private:
+  template <typename A>
+  static inline A stateless{};
+
+  best::dynptr<dyn_allocator> ptr_;
+};
+static_assert(best::allocator<best::any_alloc>);
+}  // namespace best
+
+#endif  // BEST_MEMORY_ANY_ALLOC_H_
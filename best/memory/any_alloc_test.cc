@@ -0,0 +1,76 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/memory/any_alloc.h"
+
+#include "best/container/vec.h"
+#include "best/memory/arena.h"
+#include "best/memory/counting_alloc.h"
+#include "best/memory/pool_alloc.h"
+#include "best/test/test.h"
+
+namespace best::any_alloc_test {
+static_assert(best::implements<best::malloc, best::dyn_allocator>);
+static_assert(best::implements<best::arena, best::dyn_allocator>);
+static_assert(best::implements<best::pool_alloc, best::dyn_allocator>);
+
+using ints = best::vec<int, 4, best::any_alloc>;
+
+void fill(ints& v) {
+  for (int i = 0; i < 100; ++i) { v.push(i); }
+}
+
+best::test Malloc = [](auto& t) {
+  ints v;
+  fill(v);
+  t.expect_eq(v.size(), 100);
+  t.expect_eq(v[99], 99);
+  t.expect(v.allocator() == best::any_alloc(best::malloc{}));
+};
+
+best::test Arena = [](auto& t) {
+  best::arena arena;
+  {
+    ints v(arena);
+    fill(v);
+    t.expect_eq(v[99], 99);
+    t.expect_gt(arena.bytes_used(), 0);
+  }
+  t.expect(best::any_alloc(arena) != best::any_alloc());
+};
+
+best::test Pool = [](auto& t) {
+  ints v(best::pool_alloc{});
+  fill(v);
+  t.expect_eq(v[99], 99);
+};
+
+best::test Inline = [](auto& t) {
+  // A vector that never spills should never call its allocator.
+  best::alloc_stats stats;
+  best::counting_alloc<> counter(stats);
+  {
+    ints v(counter);
+    v.push(1);
+    v.push(2);
+    t.expect(v.is_inlined());
+  }
+  t.expect_eq(stats.snapshot().allocs, 0);
+};
+}  // namespace best::any_alloc_test
@@ -0,0 +1,172 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/memory/arena.h"
+
+#include <cstddef>
+#include <cstring>
+
+#include "best/base/port.h"
+#include "best/math/int.h"
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+
+namespace best {
+// Every chunk begins with one of these headers; the rest of the chunk is
+// available for allocation.
+struct alignas(::max_align_t) arena::chunk final {
+  chunk* prev;
+  size_t size;
+  // The value of `bytes_used()` when this chunk was created.
+  size_t used_before;
+
+  char* start() { return reinterpret_cast<char*>(this + 1); }
+  char* end() { return reinterpret_cast<char*>(this) + size; }
+
+  best::layout layout() const {
+    return best::layout(unsafe("size is always a multiple of the alignment, "
+                               "since it is rounded up in alloc_slow()"),
+                        size, alignof(chunk));
+  }
+};
+
+best::ptr<void> arena::alloc_slow(best::layout layout) {
+  // Make sure there is enough room for the worst possible alignment padding.
+  size_t needed = sizeof(chunk) + layout.size() + layout.align() - 1;
+  size_t size = best::max(needed, next_chunk_size_);
+  size = (size + alignof(chunk) - 1) & ~(alignof(chunk) - 1);
+
+  if (needed <= next_chunk_size_) {
+    next_chunk_size_ = best::min(next_chunk_size_ * 2, MaxChunkSize);
+  }
+
+  auto* fresh = static_cast<chunk*>(
+    best::malloc::alloc(best::layout(
+                          unsafe("rounded up to alignof(chunk) above"), size,
+                          alignof(chunk)))
+      .raw());
+  fresh->prev = chunk_;
+  fresh->size = size;
+  fresh->used_before = bytes_used();
+
+  chunk_ = fresh;
+  cursor_ = fresh->start();
+  end_ = fresh->end();
+  reserved_ += size;
+
+  return alloc(layout);
+}
+
+best::ptr<void> arena::zalloc(best::layout layout) {
+  // Arena memory is recycled, so we cannot assume that it is zeroed.
+  auto p = alloc(layout);
+  std::memset(p.raw(), 0, layout.size());
+  return p;
+}
+
+best::ptr<void> arena::realloc(best::ptr<void> ptr, best::layout old,
+                               best::layout layout) {
+  if (grow_in_place(ptr, old, layout)) { return ptr; }
+
+  auto p = alloc(layout);
+  std::memcpy(p.raw(), ptr.raw(), best::min(old.size(), layout.size()));
+  dealloc(ptr, old);
+  return p;
+}
+
+bool arena::grow_in_place(best::ptr<void> ptr, best::layout old,
+                          best::layout layout) {
+  char* raw = static_cast<char*>(ptr.raw());
+  if (!is_last(ptr, old) || ptr.to_addr() % layout.align() != 0 ||
+      layout.size() > static_cast<size_t>(end_ - raw)) {
+    return false;
+  }
+
+  // This is the most recent allocation, so we can grow or shrink it in place
+  // by moving the cursor.
+  cursor_ = raw + layout.size();
+  return true;
+}
+
+void arena::dealloc(best::ptr<void> ptr, best::layout layout) {
+  if (best::is_debug()) { std::memset(ptr.raw(), 0xcd, layout.size()); }
+  if (is_last(ptr, layout)) { cursor_ = static_cast<char*>(ptr.raw()); }
+}
+
+arena::mark arena::save() const {
+  mark m;
+  m.chunk_ = chunk_;
+  m.cursor_ = cursor_;
+  return m;
+}
+
+void arena::restore(mark mark) {
+  if (mark.chunk_ == nullptr) {
+    reset();
+    return;
+  }
+
+  // After this, `cursor_` may point into a chunk that was just freed, so the
+  // poisoned range must be computed relative to the chunk that is current
+  // again.
+  release(mark.chunk_);
+  if (best::is_debug()) {
+    std::memset(mark.cursor_, 0xcd, end_ - mark.cursor_);
+  }
+  cursor_ = mark.cursor_;
+}
+
+void arena::reset() {
+  if (chunk_ == nullptr) { return; }
+
+  // Keep the newest chunk, since it is the largest one.
+  chunk* keep = chunk_;
+  for (chunk* c = keep->prev; c != nullptr;) {
+    chunk* prev = c->prev;
+    reserved_ -= c->size;
+    best::malloc::dealloc(c, c->layout());
+    c = prev;
+  }
+
+  keep->prev = nullptr;
+  keep->used_before = 0;
+  cursor_ = keep->start();
+  if (best::is_debug()) { std::memset(cursor_, 0xcd, end_ - cursor_); }
+}
+
+size_t arena::bytes_used() const {
+  if (chunk_ == nullptr) { return 0; }
+  return chunk_->used_before + (cursor_ - chunk_->start());
+}
+
+void arena::release(chunk* keep) {
+  while (chunk_ != keep && chunk_ != nullptr) {
+    chunk* prev = chunk_->prev;
+    reserved_ -= chunk_->size;
+    best::malloc::dealloc(chunk_, chunk_->layout());
+    chunk_ = prev;
+  }
+
+  if (chunk_ == nullptr) {
+    cursor_ = end_ = nullptr;
+  } else {
+    end_ = chunk_->end();
+  }
+}
+}  // namespace best
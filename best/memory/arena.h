@@ -0,0 +1,265 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_MEMORY_ARENA_H_
+#define BEST_MEMORY_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "best/base/hint.h"
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+#include "best/memory/ptr.h"
+
+//! Arena allocation.
+//!
+//! `best::arena` is a bump allocator: allocating from it is a pointer
+//! increment, and freeing everything in it at once is (nearly) free. This is
+//! useful for building up data with a well-defined lifetime, such as the
+//! per-request state of a server, and then throwing it all away at once.
+//!
+//! Arenas are not themselves allocators, because they are not moveable.
+//! Instead, containers should be parameterized on `best::arena_ref`, which is.
+//!
+//! ```
+//! best::arena arena;
+//! best::vec<int, 0, best::arena_ref> ints(arena);
+//! ints.push(42);
+//! ```
+
+namespace best {
+/// # `best::arena`
+///
+/// A bump allocator that allocates out of a chain of large chunks obtained from
+/// `best::malloc`.
+///
+/// Deallocating memory in an arena is a no-op, except for the most recent
+/// allocation, which is rolled back. Similarly, resizing the most recent
+/// allocation happens in-place when possible. This makes the common pattern of
+/// "push onto a vector until done" cheap.
+///
+/// All memory is returned to the system when the arena is destroyed. Memory
+/// can be recycled earlier with `reset()` or `restore()`.
+class arena final {
+ private:
+  struct chunk;
+
+ public:
+  /// # `arena::DefaultChunkSize`
+  ///
+  /// The default size of the first chunk an arena allocates.
+  static constexpr size_t DefaultChunkSize = 4096;
+
+  /// # `arena::MaxChunkSize`
+  ///
+  /// The largest size a chunk will grow to, unless a single allocation demands
+  /// a larger chunk.
+  static constexpr size_t MaxChunkSize = 1024 * 1024;
+
+  /// # `arena::arena()`
+  ///
+  /// Creates a new, empty arena. No memory is allocated until the first call
+  /// to `alloc()`.
+  ///
+  /// The first chunk will be `chunk_size` bytes; subsequent chunks double in
+  /// size, up to `MaxChunkSize`.
+  arena() = default;
+  explicit arena(size_t chunk_size) : next_chunk_size_(chunk_size) {}
+
+  /// # `arena::arena(arena)`
+  ///
+  /// Arenas are neither copyable nor moveable, since allocations point into
+  /// them.
+  arena(const arena&) = delete;
+  arena& operator=(const arena&) = delete;
+
+  /// # `arena::~arena()`
+  ///
+  /// Frees every chunk this arena owns. Any pointers into the arena are
+  /// invalidated.
+  ~arena() { release(nullptr); }
+
+  /// # `arena::alloc()`, et. al.
+  ///
+  /// Allocator functions. See `best::allocator` for what these do.
+  best::ptr<void> alloc(best::layout layout);
+  best::ptr<void> zalloc(best::layout layout);
+  best::ptr<void> realloc(best::ptr<void> ptr, best::layout old,
+                          best::layout layout);
+  void dealloc(best::ptr<void> ptr, best::layout layout);
+
+  /// # `arena::grow_in_place()`
+  ///
+  /// Resizes the most recent allocation in place, if there is room left in the
+  /// current chunk. See `best::grow_in_place()`.
+  bool grow_in_place(best::ptr<void> ptr, best::layout old,
+                     best::layout layout);
+
+  /// # `arena::mark`
+  ///
+  /// A saved position in an arena. See `arena::save()`.
+  class mark final {
+   private:
+    friend arena;
+    chunk* chunk_ = nullptr;
+    char* cursor_ = nullptr;
+  };
+
+  /// # `arena::save()`, `arena::restore()`
+  ///
+  /// Saves the current allocation position of this arena, and later rolls back
+  /// to it. Restoring a mark frees everything allocated since it was saved
+  /// (without running any destructors!).
+  ///
+  /// Marks nest: it is valid to restore an older mark after a newer one, but
+  /// once a mark is restored, every mark saved after it is invalidated.
+  mark save() const;
+  void restore(mark mark);
+
+  /// # `arena::scope`
+  ///
+  /// An RAII wrapper over `save()` and `restore()`: the arena is rolled back
+  /// to where it was when the scope was created when the scope is destroyed.
+  class scope;
+
+  /// # `arena::reset()`
+  ///
+  /// Frees everything allocated in this arena. The most recent chunk is kept
+  /// around to satisfy future allocations; the rest are returned to
+  /// `best::malloc`.
+  void reset();
+
+  /// # `arena::bytes_used()`, `arena::bytes_reserved()`
+  ///
+  /// Returns the number of bytes handed out to callers (including alignment
+  /// padding), and the number of bytes this arena has obtained from the
+  /// system, respectively.
+  size_t bytes_used() const;
+  size_t bytes_reserved() const { return reserved_; }
+
+ private:
+  // Allocates `layout` from a fresh chunk. This is the slow path of `alloc()`.
+  BEST_INLINE_NEVER best::ptr<void> alloc_slow(best::layout layout);
+
+  // Frees all chunks that were allocated after `keep`, which may be null.
+  void release(chunk* keep);
+
+  // Returns whether `ptr` with the given layout is the most recent allocation.
+  bool is_last(best::ptr<void> ptr, best::layout layout) const {
+    return static_cast<char*>(ptr.raw()) + layout.size() == cursor_;
+  }
+
+  chunk* chunk_ = nullptr;
+  char* cursor_ = nullptr;
+  char* end_ = nullptr;
+  size_t reserved_ = 0;
+  size_t next_chunk_size_ = DefaultChunkSize;
+};
+
+/// # `best::arena_ref`
+///
+/// A reference to a `best::arena` that satisfies `best::allocator`. Two
+/// `arena_ref`s are equal if they refer to the same arena.
+///
+/// This is what should be passed to containers, such as `best::vec` or
+/// `best::textbuf`. It is implicitly constructible from an `arena&`.
+class arena_ref final {
+ public:
+  /// # `arena_ref::arena_ref()`
+  ///
+  /// Wraps a reference to an arena.
+  constexpr arena_ref(best::arena& arena) : arena_(&arena) {}
+
+  /// # `arena_ref::get()`
+  ///
+  /// Returns the referenced arena.
+  constexpr best::arena& get() const { return *arena_; }
+
+  best::ptr<void> alloc(best::layout layout) const {
+    return arena_->alloc(layout);
+  }
+  best::ptr<void> zalloc(best::layout layout) const {
+    return arena_->zalloc(layout);
+  }
+  best::ptr<void> realloc(best::ptr<void> ptr, best::layout old,
+                          best::layout layout) const {
+    return arena_->realloc(ptr, old, layout);
+  }
+  void dealloc(best::ptr<void> ptr, best::layout layout) const {
+    arena_->dealloc(ptr, layout);
+  }
+  bool grow_in_place(best::ptr<void> ptr, best::layout old,
+                     best::layout layout) const {
+    return arena_->grow_in_place(ptr, old, layout);
+  }
+
+  constexpr bool operator==(const arena_ref&) const = default;
+
+ private:
+  best::arena* arena_;
+};
+static_assert(best::allocator<best::arena_ref>);
+
+class arena::scope final {
+ public:
+  /// # `scope::scope()`
+  ///
+  /// Saves the current position of `arena`.
+  explicit scope(best::arena& arena) : arena_(&arena), mark_(arena.save()) {}
+
+  scope(const scope&) = delete;
+  scope& operator=(const scope&) = delete;
+
+  /// # `scope::~scope()`
+  ///
+  /// Restores the arena to the saved position.
+  ~scope() { arena_->restore(mark_); }
+
+ private:
+  best::arena* arena_;
+  best::arena::mark mark_;
+};
+}  // namespace best
+
+/* ////////////////////////////////////////////////////////////////////////// *\
+ * ////////////////// !!! IMPLEMENTATION DETAILS BELOW !!! ////////////////// *
+\* ////////////////////////////////////////////////////////////////////////// */
+
+namespace best {
+inline best::ptr<void> arena::alloc(best::layout layout) {
+  // NOTE: this is the fast path, which must stay small enough to inline into
+  // every container that uses an arena.
+  auto addr = reinterpret_cast<uintptr_t>(cursor_);
+  auto aligned = (addr + layout.align() - 1) & ~(layout.align() - 1);
+  if (best::unlikely(cursor_ == nullptr ||
+                     aligned + layout.size() >
+                       reinterpret_cast<uintptr_t>(end_))) {
+    return alloc_slow(layout);
+  }
+
+  cursor_ += (aligned - addr) + layout.size();
+  void* p = reinterpret_cast<void*>(aligned);
+  if (best::is_debug()) { std::memset(p, 0xcd, layout.size()); }
+  return p;
+}
+}  // namespace best
+
+#endif  // BEST_MEMORY_ARENA_H_
@@ -0,0 +1,148 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/memory/arena.h"
+
+#include <cstring>
+
+#include "best/container/vec.h"
+#include "best/test/test.h"
+#include "best/text/strbuf.h"
+
+namespace best::arena_test {
+best::test Alloc = [](auto& t) {
+  best::arena arena;
+  t.expect_eq(arena.bytes_used(), 0);
+  t.expect_eq(arena.bytes_reserved(), 0);
+
+  auto p0 = arena.alloc(best::layout::of<int>());
+  auto p1 = arena.alloc(best::layout::of<double>());
+  t.expect_eq(p0.to_addr() % alignof(int), 0);
+  t.expect_eq(p1.to_addr() % alignof(double), 0);
+  t.expect_ne(p0.to_addr(), p1.to_addr());
+  t.expect_le(arena.bytes_used(), 16);
+  t.expect_eq(arena.bytes_reserved(), best::arena::DefaultChunkSize);
+
+  auto big = arena.alloc(best::layout::array<char>(100000));
+  t.expect_ne(big.to_addr(), 0);
+  t.expect_gt(arena.bytes_reserved(), 100000);
+};
+
+best::test Rollback = [](auto& t) {
+  best::arena arena;
+  auto p0 = arena.alloc(best::layout::array<int>(4));
+  auto used = arena.bytes_used();
+
+  auto p1 = arena.realloc(p0, best::layout::array<int>(4),
+                          best::layout::array<int>(8));
+  t.expect_eq(p0.to_addr(), p1.to_addr());
+  t.expect_eq(arena.bytes_used(), used + 4 * sizeof(int));
+
+  arena.dealloc(p1, best::layout::array<int>(8));
+  t.expect_eq(arena.bytes_used(), used - 4 * sizeof(int));
+};
+
+best::test GrowInPlace = [](auto& t) {
+  best::arena arena;
+  auto p0 = arena.alloc(best::layout::array<int>(4));
+  t.expect(arena.grow_in_place(p0, best::layout::array<int>(4),
+                               best::layout::array<int>(16)));
+
+  auto p1 = arena.alloc(best::layout::of<int>());
+  t.expect(!arena.grow_in_place(p0, best::layout::array<int>(16),
+                                best::layout::array<int>(32)));
+  arena.dealloc(p1, best::layout::of<int>());
+};
+
+best::test Vec = [](auto& t) {
+  best::arena arena;
+  best::vec<int, 0, best::arena_ref> ints(arena);
+  for (int i = 0; i < 1000; ++i) { ints.push(i); }
+
+  t.expect_eq(ints.size(), 1000);
+  t.expect_eq(ints[0], 0);
+  t.expect_eq(ints[999], 999);
+  t.expect_gt(arena.bytes_used(), 0);
+};
+
+best::test Text = [](auto& t) {
+  best::arena arena;
+  best::textbuf<best::utf8, best::arena_ref> buf(arena);
+  buf.push("hello, ");
+  buf.push("world!");
+  t.expect_eq(buf, "hello, world!");
+};
+
+best::test Marks = [](auto& t) {
+  best::arena arena(64);
+  arena.alloc(best::layout::of<int>());
+  auto used = arena.bytes_used();
+
+  auto outer = arena.save();
+  arena.alloc(best::layout::array<char>(32));
+  {
+    best::arena::scope scope(arena);
+    arena.alloc(best::layout::array<char>(1000));
+    t.expect_gt(arena.bytes_used(), used + 1000);
+  }
+  t.expect_eq(arena.bytes_used(), used + 32);
+
+  arena.restore(outer);
+  t.expect_eq(arena.bytes_used(), used);
+};
+
+best::test RestoreAcrossChunks = [](auto& t) {
+  best::arena arena(64);
+  auto p0 = arena.alloc(best::layout::array<char>(8));
+  std::memset(p0.raw(), 'x', 8);
+  auto mark = arena.save();
+  auto used = arena.bytes_used();
+  auto reserved = arena.bytes_reserved();
+
+  // Open several chunks past the mark; in debug builds, restoring poisons the
+  // tail of the marked chunk, which must not touch any of the freed ones.
+  for (int i = 0; i < 4; ++i) { arena.alloc(best::layout::array<char>(1000)); }
+  t.expect_gt(arena.bytes_reserved(), reserved);
+
+  arena.restore(mark);
+  t.expect_eq(arena.bytes_used(), used);
+  t.expect_eq(arena.bytes_reserved(), reserved);
+  t.expect_eq(best::span(static_cast<char*>(p0.raw()), 8),
+              best::span<const char>::from_nul("xxxxxxxx"));
+
+  auto p1 = arena.alloc(best::layout::array<char>(8));
+  t.expect_eq(p1.to_addr(), p0.to_addr() + 8);
+};
+
+best::test Reset = [](auto& t) {
+  best::arena arena(64);
+  for (int i = 0; i < 100; ++i) { arena.alloc(best::layout::array<char>(50)); }
+  auto reserved = arena.bytes_reserved();
+
+  arena.reset();
+  t.expect_eq(arena.bytes_used(), 0);
+  t.expect_gt(arena.bytes_reserved(), 0);
+  t.expect_le(arena.bytes_reserved(), reserved);
+
+  // The kept chunk should be reused.
+  auto before = arena.bytes_reserved();
+  arena.alloc(best::layout::array<char>(50));
+  t.expect_eq(arena.bytes_reserved(), before);
+};
+}  // namespace best::arena_test
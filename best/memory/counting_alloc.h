@@ -0,0 +1,281 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_MEMORY_COUNTING_ALLOC_H_
+#define BEST_MEMORY_COUNTING_ALLOC_H_
+
+#include <atomic>
+#include <cstddef>
+
+#include "best/math/bit.h"
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+#include "best/memory/ptr.h"
+#include "best/meta/init.h"
+
+//! Allocator instrumentation.
+//!
+//! `best::counting_alloc` wraps another allocator and records statistics about
+//! every call made through it into a `best::alloc_stats`. These statistics can
+//! be inspected at any time, from any thread, via `alloc_stats::snapshot()`.
+//!
+//! ```
+//! best::alloc_stats stats;
+//! best::vec<int, 0, best::counting_alloc<>> ints(stats);
+//! ints.push(42);
+//! best::println("{:#?}", stats.snapshot());
+//! ```
+
+namespace best {
+/// # `best::alloc_snapshot`
+///
+/// A point-in-time copy of the counters in a `best::alloc_stats`.
+struct alloc_snapshot final {
+  /// # `alloc_snapshot::Buckets`
+  ///
+  /// The number of size-class buckets in the histogram. Bucket `n` counts
+  /// allocations of size in `(2^(n-1), 2^n]`; the last bucket also counts
+  /// everything larger.
+  static constexpr size_t Buckets = 24;
+
+  /// Bytes currently allocated, and the largest that value has ever been.
+  size_t live_bytes = 0;
+  size_t peak_bytes = 0;
+
+  /// The number of times each allocator function was called.
+  size_t allocs = 0;
+  size_t reallocs = 0;
+  size_t deallocs = 0;
+
+  /// A histogram of allocation sizes. See `Buckets`.
+  size_t histogram[Buckets] = {};
+
+  friend void BestFmt(auto& fmt, const alloc_snapshot& snap) {
+    auto rec = fmt.record("alloc_snapshot");
+    rec.field("live_bytes", snap.live_bytes);
+    rec.field("peak_bytes", snap.peak_bytes);
+    rec.field("allocs", snap.allocs);
+    rec.field("reallocs", snap.reallocs);
+    rec.field("deallocs", snap.deallocs);
+    rec.field("histogram", snap.histogram);
+  }
+};
+
+/// # `best::alloc_stats`
+///
+/// A set of allocation counters, which can be shared by many
+/// `best::counting_alloc`s. All operations on it are thread-safe.
+class alloc_stats final {
+ public:
+  /// # `alloc_stats::alloc_stats()`
+  ///
+  /// Creates a new set of counters, all zero.
+  alloc_stats() = default;
+
+  alloc_stats(const alloc_stats&) = delete;
+  alloc_stats& operator=(const alloc_stats&) = delete;
+
+  /// # `alloc_stats::global()`
+  ///
+  /// The counters used by a default-constructed `best::counting_alloc`.
+  static alloc_stats& global() {
+    static alloc_stats stats;
+    return stats;
+  }
+
+  /// # `alloc_stats::snapshot()`
+  ///
+  /// Reads the current value of every counter. The counters are read
+  /// individually, so a snapshot taken while other threads are allocating may
+  /// be slightly inconsistent.
+  alloc_snapshot snapshot() const;
+
+  /// # `alloc_stats::reset()`
+  ///
+  /// Zeroes the call counters and histogram, and sets the peak to the current
+  /// number of live bytes. The live byte count is unaffected, since memory
+  /// allocated before the reset may still be freed after it.
+  void reset();
+
+  /// # `alloc_stats::on_alloc()`, et. al.
+  ///
+  /// Records an allocator call. These are called by `best::counting_alloc`,
+  /// but can also be called directly to account for memory obtained some
+  /// other way.
+  void on_alloc(best::layout layout);
+  void on_realloc(best::layout old, best::layout layout);
+  void on_dealloc(best::layout layout);
+
+ private:
+  static size_t bucket_of(size_t size);
+  void add_live(size_t bytes);
+
+  std::atomic<size_t> live_bytes_ = 0;
+  std::atomic<size_t> peak_bytes_ = 0;
+  std::atomic<size_t> allocs_ = 0;
+  std::atomic<size_t> reallocs_ = 0;
+  std::atomic<size_t> deallocs_ = 0;
+  std::atomic<size_t> histogram_[alloc_snapshot::Buckets] = {};
+};
+
+/// # `best::counting_alloc<A>`
+///
+/// An allocator that forwards to `A`, recording every call into a
+/// `best::alloc_stats`.
+///
+/// Two `counting_alloc`s are equal if their underlying allocators are equal
+/// and they record into the same `alloc_stats`.
+///
+/// `alloc_at_least()` and `realloc_at_least()` do not pass the wrapped
+/// allocator's slack on to the caller: they report exactly the requested size.
+/// Callers may free with any size in between, so this is the only way to make
+/// the recorded sizes agree with the freed ones.
+template <best::allocator A = best::malloc>
+class counting_alloc final {
+ public:
+  /// # `counting_alloc::counting_alloc()`
+  ///
+  /// Wraps a default-constructed `A`, recording into `alloc_stats::global()`.
+  counting_alloc() requires best::constructible<A>
+    : counting_alloc(A{}, alloc_stats::global()) {}
+
+  /// # `counting_alloc::counting_alloc(stats)`
+  ///
+  /// Wraps a default-constructed `A`, recording into `stats`.
+  counting_alloc(alloc_stats& stats) requires best::constructible<A>
+    : counting_alloc(A{}, stats) {}
+
+  /// # `counting_alloc::counting_alloc(alloc, stats)`
+  ///
+  /// Wraps `alloc`, recording into `stats`.
+  counting_alloc(A alloc, alloc_stats& stats)
+    : alloc_(std::move(alloc)), stats_(&stats) {}
+
+  /// # `counting_alloc::stats()`, `counting_alloc::inner()`
+  ///
+  /// Returns the wrapped statistics and allocator, respectively.
+  alloc_stats& stats() const { return *stats_; }
+  A& inner() { return alloc_; }
+  const A& inner() const { return alloc_; }
+
+  best::ptr<void> alloc(best::layout layout) {
+    auto p = alloc_.alloc(layout);
+    stats_->on_alloc(layout);
+    return p;
+  }
+  best::ptr<void> zalloc(best::layout layout) {
+    auto p = alloc_.zalloc(layout);
+    stats_->on_alloc(layout);
+    return p;
+  }
+  best::ptr<void> realloc(best::ptr<void> ptr, best::layout old,
+                          best::layout layout) {
+    auto p = alloc_.realloc(ptr, old, layout);
+    stats_->on_realloc(old, layout);
+    return p;
+  }
+  void dealloc(best::ptr<void> ptr, best::layout layout) {
+    alloc_.dealloc(ptr, layout);
+    stats_->on_dealloc(layout);
+  }
+
+  best::allocation alloc_at_least(best::layout layout) {
+    return {alloc(layout), layout.size()};
+  }
+  best::allocation realloc_at_least(best::ptr<void> ptr, best::layout old,
+                                    best::layout layout) {
+    return {realloc(ptr, old, layout), layout.size()};
+  }
+  bool grow_in_place(best::ptr<void> ptr, best::layout old,
+                     best::layout layout) {
+    if (!best::grow_in_place(alloc_, ptr, old, layout)) { return false; }
+    stats_->on_realloc(old, layout);
+    return true;
+  }
+
+  bool operator==(const counting_alloc&) const = default;
+
+ private:
+  A alloc_;
+  alloc_stats* stats_;
+};
+static_assert(best::allocator<best::counting_alloc<>>);
+}  // namespace best
+
+/* ////////////////////////////////////////////////////////////////////////// *\
+ * ////////////////// !!! IMPLEMENTATION DETAILS BELOW !!! ////////////////// *
+\* ////////////////////////////////////////////////////////////////////////// */
+
+namespace best {
+inline alloc_snapshot alloc_stats::snapshot() const {
+  alloc_snapshot snap;
+  snap.live_bytes = live_bytes_.load(std::memory_order_relaxed);
+  snap.peak_bytes = peak_bytes_.load(std::memory_order_relaxed);
+  snap.allocs = allocs_.load(std::memory_order_relaxed);
+  snap.reallocs = reallocs_.load(std::memory_order_relaxed);
+  snap.deallocs = deallocs_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < alloc_snapshot::Buckets; ++i) {
+    snap.histogram[i] = histogram_[i].load(std::memory_order_relaxed);
+  }
+  return snap;
+}
+
+inline void alloc_stats::reset() {
+  peak_bytes_.store(live_bytes_.load(std::memory_order_relaxed),
+                    std::memory_order_relaxed);
+  allocs_.store(0, std::memory_order_relaxed);
+  reallocs_.store(0, std::memory_order_relaxed);
+  deallocs_.store(0, std::memory_order_relaxed);
+  for (auto& bucket : histogram_) { bucket.store(0, std::memory_order_relaxed); }
+}
+
+inline void alloc_stats::on_alloc(best::layout layout) {
+  allocs_.fetch_add(1, std::memory_order_relaxed);
+  histogram_[bucket_of(layout.size())].fetch_add(1, std::memory_order_relaxed);
+  add_live(layout.size());
+}
+
+inline void alloc_stats::on_realloc(best::layout old, best::layout layout) {
+  reallocs_.fetch_add(1, std::memory_order_relaxed);
+  histogram_[bucket_of(layout.size())].fetch_add(1, std::memory_order_relaxed);
+  live_bytes_.fetch_sub(old.size(), std::memory_order_relaxed);
+  add_live(layout.size());
+}
+
+inline void alloc_stats::on_dealloc(best::layout layout) {
+  deallocs_.fetch_add(1, std::memory_order_relaxed);
+  live_bytes_.fetch_sub(layout.size(), std::memory_order_relaxed);
+}
+
+inline size_t alloc_stats::bucket_of(size_t size) {
+  if (size <= 1) { return 0; }
+  size_t bucket = best::size_of<size_t> * 8 - best::leading_zeros(size - 1);
+  return bucket < alloc_snapshot::Buckets ? bucket
+                                          : alloc_snapshot::Buckets - 1;
+}
+
+inline void alloc_stats::add_live(size_t bytes) {
+  size_t live = live_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  size_t peak = peak_bytes_.load(std::memory_order_relaxed);
+  while (peak < live && !peak_bytes_.compare_exchange_weak(
+                          peak, live, std::memory_order_relaxed)) {}
+}
+}  // namespace best
+
+#endif  // BEST_MEMORY_COUNTING_ALLOC_H_
@@ -0,0 +1,130 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/memory/counting_alloc.h"
+
+#include "best/container/vec.h"
+#include "best/test/test.h"
+#include "best/text/format.h"
+#include "best/text/strbuf.h"
+
+namespace best::counting_alloc_test {
+best::test Counts = [](auto& t) {
+  best::alloc_stats stats;
+  best::counting_alloc<> alloc(stats);
+
+  auto p0 = alloc.alloc(best::layout::array<char>(100));
+  auto p1 = alloc.zalloc(best::layout::array<char>(8));
+  t.expect_eq(stats.snapshot().live_bytes, 108);
+
+  p0 = alloc.realloc(p0, best::layout::array<char>(100),
+                     best::layout::array<char>(300));
+  t.expect_eq(stats.snapshot().live_bytes, 308);
+  t.expect_eq(stats.snapshot().peak_bytes, 308);
+
+  alloc.dealloc(p0, best::layout::array<char>(300));
+  alloc.dealloc(p1, best::layout::array<char>(8));
+
+  auto snap = stats.snapshot();
+  t.expect_eq(snap.live_bytes, 0);
+  t.expect_eq(snap.peak_bytes, 308);
+  t.expect_eq(snap.allocs, 2);
+  t.expect_eq(snap.reallocs, 1);
+  t.expect_eq(snap.deallocs, 2);
+  t.expect_eq(snap.histogram[3], 1);  // 8
+  t.expect_eq(snap.histogram[7], 1);  // 100
+  t.expect_eq(snap.histogram[9], 1);  // 300
+
+  stats.reset();
+  snap = stats.snapshot();
+  t.expect_eq(snap.allocs, 0);
+  t.expect_eq(snap.peak_bytes, 0);
+};
+
+best::test Containers = [](auto& t) {
+  best::alloc_stats stats;
+  {
+    best::vec<int, 0, best::counting_alloc<>> ints(stats);
+    for (int i = 0; i < 100; ++i) { ints.push(i); }
+    t.expect_ge(stats.snapshot().live_bytes, 100 * sizeof(int));
+
+    best::textbuf<best::utf8, best::counting_alloc<>> buf(stats);
+    buf.push("a string long enough to be spilled onto the heap");
+    t.expect_gt(stats.snapshot().allocs, 1);
+  }
+  t.expect_eq(stats.snapshot().live_bytes, 0);
+};
+
+// An allocator that rounds every block up to 256 bytes, and reports that.
+struct slack_alloc final {
+  static best::layout rounded(best::layout layout) {
+    return best::layout(unsafe("256 is a multiple of any reasonable alignment"),
+                        (layout.size() + 255) & ~size_t{255}, layout.align());
+  }
+
+  best::ptr<void> alloc(best::layout layout) {
+    return best::malloc::alloc(rounded(layout));
+  }
+  best::ptr<void> zalloc(best::layout layout) {
+    return best::malloc::zalloc(rounded(layout));
+  }
+  best::ptr<void> realloc(best::ptr<void> ptr, best::layout old,
+                          best::layout layout) {
+    return best::malloc::realloc(ptr, rounded(old), rounded(layout));
+  }
+  void dealloc(best::ptr<void> ptr, best::layout layout) {
+    best::malloc::dealloc(ptr, rounded(layout));
+  }
+  best::allocation alloc_at_least(best::layout layout) {
+    return {alloc(layout), rounded(layout).size()};
+  }
+  best::allocation realloc_at_least(best::ptr<void> ptr, best::layout old,
+                                    best::layout layout) {
+    return {realloc(ptr, old, layout), rounded(layout).size()};
+  }
+
+  bool operator==(const slack_alloc&) const = default;
+};
+
+best::test Slack = [](auto& t) {
+  best::alloc_stats stats;
+  {
+    best::vec<int, 0, best::counting_alloc<slack_alloc>> ints(stats);
+    for (int i = 0; i < 1000; ++i) { ints.push(i); }
+    t.expect_eq(stats.snapshot().live_bytes, ints.capacity() * sizeof(int));
+
+    ints.truncate(10);
+    ints.shrink_to_fit();
+    t.expect_eq(stats.snapshot().live_bytes, ints.capacity() * sizeof(int));
+  }
+  t.expect_eq(stats.snapshot().live_bytes, 0);
+};
+
+best::test Format = [](auto& t) {
+  best::alloc_stats stats;
+  best::counting_alloc<> alloc(stats);
+  auto p = alloc.alloc(best::layout::of<int>());
+  alloc.dealloc(p, best::layout::of<int>());
+
+  t.expect_eq(best::format("{:?}", stats.snapshot()),
+              "alloc_snapshot {live_bytes: 0, peak_bytes: 4, allocs: 1, "
+              "reallocs: 0, deallocs: 1, histogram: [0, 0, 1, 0, 0, 0, 0, 0, "
+              "0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0]}");
+};
+}  // namespace best::counting_alloc_test
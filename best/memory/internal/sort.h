@@ -0,0 +1,828 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_MEMORY_INTERNAL_SORT_H_
+#define BEST_MEMORY_INTERNAL_SORT_H_
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "best/base/tags.h"
+#include "best/math/int.h"
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+#include "best/memory/ptr.h"
+#include "best/memory/span.h"
+#include "best/meta/traits/refs.h"
+
+//! Sorting algorithms backing best::span::sort() and friends.
+//!
+//! All of these operate on raw pointers and a `less` predicate, which the
+//! functions in span_sort.h build out of whatever the user passed in.
+//!
+//! There are four algorithms:
+//!
+//! 1. Pattern-defeating quicksort (pdqsort), for unstable comparison sorts.
+//!    When the keys are primitive, partitioning uses the branchless block
+//!    scheme from BlockQuicksort, which avoids the branch mispredictions that
+//!    dominate the cost of sorting random numbers.
+//! 2. A bottom-up merge sort with a scratch buffer of half the input, for
+//!    stable comparison sorts.
+//! 3. LSD radix sort, for large inputs with integer or floating-point keys.
+//!    This is stable, so it serves both `sort()` and `stable_sort()`.
+//! 4. Multikey quicksort, for unstable sorts of string keys. This looks at
+//!    each code unit of each key only a constant number of times, rather than
+//!    rescanning common prefixes on every comparison. Like pdqsort, it gives
+//!    up after too many unbalanced partitions, falling back to pdqsort.
+//!
+//! During constant evaluation, allocation is off the table, so stable sorts
+//! fall back to insertion sort and radix sort is never used.
+
+namespace best::sort_internal {
+// Below this size, insertion sort beats everything else.
+inline constexpr size_t InsertionThreshold = 24;
+// Above this size, pdqsort picks its pivot with Tukey's ninther rather than
+// median-of-three.
+inline constexpr size_t NintherThreshold = 128;
+// The number of element moves partial_insertion_sort() will tolerate before
+// giving up on the input being nearly sorted.
+inline constexpr size_t PartialInsertionLimit = 8;
+// The number of elements examined at a time by the branchless partition.
+// Offsets into a block must fit in a byte.
+inline constexpr size_t BlockSize = 64;
+// Merge sort begins by insertion-sorting runs of this length.
+inline constexpr size_t MergeRun = 32;
+// Radix sort makes one pass over the data per byte of key, so it only pays off
+// for large-enough inputs of small-enough elements. The threshold is per byte
+// of key.
+inline constexpr size_t RadixThreshold = 256;
+inline constexpr size_t RadixMaxElem = 32;
+
+/// Whether `K` is a key type that radix sort understands.
+template <typename K>
+concept radix_key =
+  (best::is_int<K> && sizeof(K) <= 8) || std::is_same_v<K, float> ||
+  std::is_same_v<K, double>;
+
+/// Converts a radix key into an unsigned integer of the same width whose
+/// ordering agrees with the key's.
+///
+/// Signed integers have their sign bit flipped. Floats are ordered by IEEE 754
+/// `totalOrder`: negative values have all of their bits flipped, and positive
+/// ones just the sign bit. This means that -0.0 sorts before +0.0, and that
+/// NaNs sort at either end depending on their sign.
+template <radix_key K>
+constexpr auto radix_bits(K key) {
+  using U = best::smallest_uint_t<uint64_t(1) << (sizeof(K) * 8 - 1)>;
+  constexpr U Sign = U(1) << (sizeof(K) * 8 - 1);
+  if constexpr (std::is_floating_point_v<K>) {
+    U bits = std::bit_cast<U>(key);
+    return (bits & Sign) != 0 ? U(~bits) : U(bits | Sign);
+  } else if constexpr (std::is_signed_v<K>) {
+    return U(U(key) ^ Sign);
+  } else {
+    return U(key);
+  }
+}
+
+template <typename T>
+BEST_INLINE_ALWAYS constexpr void swap_at(T* a, T* b) {
+  using ::std::swap;
+  swap(*a, *b);
+}
+
+// Moves `count` elements from `src` into uninitialized memory at `dst`,
+// leaving `src` uninitialized.
+template <typename T>
+BEST_INLINE_ALWAYS constexpr void relo(T* dst, T* src, size_t count = 1) {
+  best::ptr<T>(dst).relo(best::ptr<T>(src), count);
+}
+
+// Returns floor(log2(n)), or zero.
+constexpr size_t log2(size_t n) {
+  size_t log = 0;
+  while (n >>= 1) { ++log; }
+  return log;
+}
+
+/// Sorts [begin, end) with insertion sort.
+template <typename T>
+constexpr void insertion_sort(T* begin, T* end, auto& less) {
+  if (begin == end) { return; }
+  for (T* cur = begin + 1; cur != end; ++cur) {
+    if (!less(*cur, cur[-1])) { continue; }
+
+    T tmp = BEST_MOVE(*cur);
+    T* sift = cur;
+    do {
+      *sift = BEST_MOVE(sift[-1]);
+      --sift;
+    } while (sift != begin && less(tmp, sift[-1]));
+    *sift = BEST_MOVE(tmp);
+  }
+}
+
+/// Like insertion_sort(), but assumes that `begin[-1]` exists and is not
+/// greater than any element of [begin, end), which acts as a sentinel.
+template <typename T>
+constexpr void unguarded_insertion_sort(T* begin, T* end, auto& less) {
+  if (begin == end) { return; }
+  for (T* cur = begin + 1; cur != end; ++cur) {
+    if (!less(*cur, cur[-1])) { continue; }
+
+    T tmp = BEST_MOVE(*cur);
+    T* sift = cur;
+    do {
+      *sift = BEST_MOVE(sift[-1]);
+      --sift;
+    } while (less(tmp, sift[-1]));
+    *sift = BEST_MOVE(tmp);
+  }
+}
+
+/// Attempts to insertion sort [begin, end), but gives up and returns false if
+/// more than PartialInsertionLimit elements need to move.
+template <typename T>
+constexpr bool partial_insertion_sort(T* begin, T* end, auto& less) {
+  if (begin == end) { return true; }
+  size_t moved = 0;
+  for (T* cur = begin + 1; cur != end; ++cur) {
+    if (!less(*cur, cur[-1])) { continue; }
+
+    T tmp = BEST_MOVE(*cur);
+    T* sift = cur;
+    do {
+      *sift = BEST_MOVE(sift[-1]);
+      --sift;
+    } while (sift != begin && less(tmp, sift[-1]));
+    *sift = BEST_MOVE(tmp);
+
+    moved += cur - sift;
+    if (moved > PartialInsertionLimit) { return false; }
+  }
+  return true;
+}
+
+/// Sorts [begin, end) with heapsort. This is pdqsort's fallback when it keeps
+/// picking bad pivots, which bounds it at O(n log n).
+template <typename T>
+constexpr void heap_sort(T* begin, T* end, auto& less) {
+  auto sift_down = [&](size_t root, size_t len) {
+    while (true) {
+      size_t child = 2 * root + 1;
+      if (child >= len) { return; }
+      if (child + 1 < len && less(begin[child], begin[child + 1])) { ++child; }
+      if (!less(begin[root], begin[child])) { return; }
+      swap_at(begin + root, begin + child);
+      root = child;
+    }
+  };
+
+  size_t len = end - begin;
+  for (size_t i = len / 2; i-- > 0;) { sift_down(i, len); }
+  for (size_t i = len; i-- > 1;) {
+    swap_at(begin, begin + i);
+    sift_down(0, i);
+  }
+}
+
+template <typename T>
+constexpr void sort2(T* a, T* b, auto& less) {
+  if (less(*b, *a)) { swap_at(a, b); }
+}
+
+template <typename T>
+constexpr void sort3(T* a, T* b, T* c, auto& less) {
+  sort2(a, b, less);
+  sort2(b, c, less);
+  sort2(a, b, less);
+}
+
+template <typename T>
+struct partition final {
+  T* pivot;
+  bool already_partitioned;
+};
+
+/// Partitions [begin, end) around the pivot `*begin`. Elements equal to the
+/// pivot go to the right. Returns the final position of the pivot, and whether
+/// no elements needed to be swapped.
+///
+/// Assumes that the pivot is a median of at least three elements, so that
+/// there is an element not less than it to the right of it, and (unless
+/// this is the leftmost partition) one not greater than it to its left.
+template <typename T>
+constexpr partition<T> partition_right(T* begin, T* end, auto& less) {
+  T pivot = BEST_MOVE(*begin);
+  T* first = begin;
+  T* last = end;
+
+  while (less(*++first, pivot)) {}
+  if (first - 1 == begin) {
+    while (first < last && !less(*--last, pivot)) {}
+  } else {
+    while (!less(*--last, pivot)) {}
+  }
+
+  bool already_partitioned = first >= last;
+  while (first < last) {
+    swap_at(first, last);
+    while (less(*++first, pivot)) {}
+    while (!less(*--last, pivot)) {}
+  }
+
+  T* pivot_pos = first - 1;
+  *begin = BEST_MOVE(*pivot_pos);
+  *pivot_pos = BEST_MOVE(pivot);
+  return {pivot_pos, already_partitioned};
+}
+
+// Swaps `count` pairs of elements, described by offsets from `first` and
+// `last`. If the counts are unequal, a cyclic permutation is used instead of
+// swaps, which halves the number of moves.
+template <typename T>
+constexpr void swap_offsets(T* first, T* last, const uint8_t* offsets_l,
+                            const uint8_t* offsets_r, size_t count,
+                            bool use_swaps) {
+  if (use_swaps) {
+    // This is needed for correctness when both sides have the same number of
+    // elements, since the cycle below would not close.
+    for (size_t i = 0; i < count; ++i) {
+      swap_at(first + offsets_l[i], last - offsets_r[i]);
+    }
+    return;
+  }
+  if (count == 0) { return; }
+
+  T* l = first + offsets_l[0];
+  T* r = last - offsets_r[0];
+  T tmp = BEST_MOVE(*l);
+  *l = BEST_MOVE(*r);
+  for (size_t i = 1; i < count; ++i) {
+    l = first + offsets_l[i];
+    *r = BEST_MOVE(*l);
+    r = last - offsets_r[i];
+    *l = BEST_MOVE(*r);
+  }
+  *r = BEST_MOVE(tmp);
+}
+
+/// Like partition_right(), but uses BlockQuicksort's branchless scheme: each
+/// side first records the offsets of misplaced elements within a block without
+/// branching on the comparison, and then the recorded elements are swapped.
+template <typename T>
+constexpr partition<T> partition_right_branchless(T* begin, T* end,
+                                                  auto& less) {
+  T pivot = BEST_MOVE(*begin);
+  T* first = begin;
+  T* last = end;
+
+  while (less(*++first, pivot)) {}
+  if (first - 1 == begin) {
+    while (first < last && !less(*--last, pivot)) {}
+  } else {
+    while (!less(*--last, pivot)) {}
+  }
+
+  auto finish = [&] {
+    T* pivot_pos = first - 1;
+    *begin = BEST_MOVE(*pivot_pos);
+    *pivot_pos = BEST_MOVE(pivot);
+    return pivot_pos;
+  };
+  if (first >= last) { return {finish(), true}; }
+  swap_at(first, last);
+  ++first;
+
+  alignas(64) uint8_t offsets_l[BlockSize];
+  alignas(64) uint8_t offsets_r[BlockSize];
+  size_t num_l = 0, num_r = 0;
+  size_t start_l = 0, start_r = 0;
+
+  // Fills a block on the left with the offsets of elements that belong on the
+  // right, or vice-versa. The count is bumped unconditionally, and the offset
+  // is simply overwritten if the element was not misplaced.
+  auto fill_l = [&](size_t len) {
+    start_l = 0;
+    T* it = first;
+    for (size_t i = 0; i < len; ++i, ++it) {
+      offsets_l[num_l] = i;
+      num_l += !less(*it, pivot);
+    }
+  };
+  auto fill_r = [&](size_t len) {
+    start_r = 0;
+    T* it = last;
+    for (size_t i = 0; i < len;) {
+      offsets_r[num_r] = ++i;
+      num_r += less(*--it, pivot);
+    }
+  };
+  auto swap_blocks = [&] {
+    size_t num = num_l < num_r ? num_l : num_r;
+    swap_offsets(first, last, offsets_l + start_l, offsets_r + start_r, num,
+                 num_l == num_r);
+    num_l -= num;
+    num_r -= num;
+    start_l += num;
+    start_r += num;
+  };
+
+  while (last - first > 2 * ptrdiff_t(BlockSize)) {
+    if (num_l == 0) { fill_l(BlockSize); }
+    if (num_r == 0) { fill_r(BlockSize); }
+    swap_blocks();
+    if (num_l == 0) { first += BlockSize; }
+    if (num_r == 0) { last -= BlockSize; }
+  }
+
+  // Fewer than two blocks' worth of elements remain; one of the sides may
+  // still have a partially-processed block.
+  size_t l_size = 0, r_size = 0;
+  size_t unknown = (last - first) - ((num_r || num_l) ? BlockSize : 0);
+  if (num_r) {
+    l_size = unknown;
+    r_size = BlockSize;
+  } else if (num_l) {
+    l_size = BlockSize;
+    r_size = unknown;
+  } else {
+    l_size = unknown / 2;
+    r_size = unknown - l_size;
+  }
+
+  if (unknown && !num_l) { fill_l(l_size); }
+  if (unknown && !num_r) { fill_r(r_size); }
+  swap_blocks();
+  if (num_l == 0) { first += l_size; }
+  if (num_r == 0) { last -= r_size; }
+
+  // One side is now fully processed; move the leftovers from the other side
+  // to the boundary.
+  if (num_l) {
+    while (num_l--) { swap_at(first + offsets_l[start_l + num_l], --last); }
+    first = last;
+  }
+  if (num_r) {
+    while (num_r--) { swap_at(last - offsets_r[start_r + num_r], first++); }
+    last = first;
+  }
+
+  return {finish(), false};
+}
+
+/// Partitions [begin, end) around the pivot `*begin`, putting elements equal
+/// to the pivot on the left. This is used when the pivot is equal to the
+/// element just before `begin`, which means that every element equal to the
+/// pivot is already in its final position.
+template <typename T>
+constexpr T* partition_left(T* begin, T* end, auto& less) {
+  T pivot = BEST_MOVE(*begin);
+  T* first = begin;
+  T* last = end;
+
+  while (less(pivot, *--last)) {}
+  if (last + 1 == end) {
+    while (first < last && !less(pivot, *++first)) {}
+  } else {
+    while (!less(pivot, *++first)) {}
+  }
+
+  while (first < last) {
+    swap_at(first, last);
+    while (less(pivot, *--last)) {}
+    while (!less(pivot, *++first)) {}
+  }
+
+  T* pivot_pos = last;
+  *begin = BEST_MOVE(*pivot_pos);
+  *pivot_pos = BEST_MOVE(pivot);
+  return pivot_pos;
+}
+
+/// The main loop of pdqsort.
+///
+/// `bad_allowed` is the number of badly unbalanced partitions we tolerate
+/// before switching to heapsort. `leftmost` is false if there is an element
+/// at `begin[-1]` that is not greater than anything in [begin, end).
+template <bool Branchless, typename T>
+constexpr void pdqsort_loop(T* begin, T* end, auto& less, size_t bad_allowed,
+                            bool leftmost = true) {
+  while (true) {
+    size_t size = end - begin;
+    if (size < InsertionThreshold) {
+      if (leftmost) {
+        insertion_sort(begin, end, less);
+      } else {
+        unguarded_insertion_sort(begin, end, less);
+      }
+      return;
+    }
+
+    // Pick a pivot and move it to *begin.
+    size_t half = size / 2;
+    if (size > NintherThreshold) {
+      sort3(begin, begin + half, end - 1, less);
+      sort3(begin + 1, begin + (half - 1), end - 2, less);
+      sort3(begin + 2, begin + (half + 1), end - 3, less);
+      sort3(begin + (half - 1), begin + half, begin + (half + 1), less);
+      swap_at(begin, begin + half);
+    } else {
+      sort3(begin + half, begin, end - 1, less);
+    }
+
+    // If the pivot is equal to the element before this partition, everything
+    // equal to it is already in place, so we only need to sort what's
+    // greater. This is what makes inputs with many duplicates linear.
+    if (!leftmost && !less(begin[-1], *begin)) {
+      begin = partition_left(begin, end, less) + 1;
+      continue;
+    }
+
+    auto [pivot, already_partitioned] =
+      Branchless ? partition_right_branchless(begin, end, less)
+                 : partition_right(begin, end, less);
+
+    size_t l_size = pivot - begin;
+    size_t r_size = end - (pivot + 1);
+    if (l_size < size / 8 || r_size < size / 8) {
+      // The partition was very unbalanced. Too many of these means we are
+      // being fed an adversarial pattern, so give up on quicksort.
+      if (--bad_allowed == 0) {
+        heap_sort(begin, end, less);
+        return;
+      }
+
+      // Otherwise, shuffle some elements around to break up the pattern.
+      if (l_size >= InsertionThreshold) {
+        swap_at(begin, begin + l_size / 4);
+        swap_at(pivot - 1, pivot - l_size / 4);
+        if (l_size > NintherThreshold) {
+          swap_at(begin + 1, begin + (l_size / 4 + 1));
+          swap_at(begin + 2, begin + (l_size / 4 + 2));
+          swap_at(pivot - 2, pivot - (l_size / 4 + 1));
+          swap_at(pivot - 3, pivot - (l_size / 4 + 2));
+        }
+      }
+      if (r_size >= InsertionThreshold) {
+        swap_at(pivot + 1, pivot + (1 + r_size / 4));
+        swap_at(end - 1, end - r_size / 4);
+        if (r_size > NintherThreshold) {
+          swap_at(pivot + 2, pivot + (2 + r_size / 4));
+          swap_at(pivot + 3, pivot + (3 + r_size / 4));
+          swap_at(end - 2, end - (1 + r_size / 4));
+          swap_at(end - 3, end - (2 + r_size / 4));
+        }
+      }
+    } else if (already_partitioned &&
+               partial_insertion_sort(begin, pivot, less) &&
+               partial_insertion_sort(pivot + 1, end, less)) {
+      // A well-balanced partition that needed no swaps suggests the input is
+      // already sorted; if it really is, we are done.
+      return;
+    }
+
+    // Recurse into the left side and loop on the right.
+    pdqsort_loop<Branchless>(begin, pivot, less, bad_allowed, leftmost);
+    begin = pivot + 1;
+    leftmost = false;
+  }
+}
+
+/// Sorts `data` with pdqsort. Not stable.
+template <bool Branchless, typename T>
+constexpr void pdqsort(T* data, size_t len, auto&& less) {
+  if (len < 2) { return; }
+  pdqsort_loop<Branchless>(data, data + len, less, log2(len));
+}
+
+/// Merges the sorted runs [lo, mid) and [mid, hi), using `buf` as scratch
+/// space for the shorter of the two.
+template <typename T>
+void merge(T* lo, T* mid, T* hi, T* buf, auto& less) {
+  // Nothing to do if the runs are already in order.
+  if (!less(*mid, mid[-1])) { return; }
+
+  if (mid - lo <= hi - mid) {
+    // Move the left run out of the way and merge forwards. `out` never
+    // catches up with `b` until `a` is exhausted.
+    T* a = buf;
+    T* a_end = buf + (mid - lo);
+    relo(buf, lo, mid - lo);
+
+    T* b = mid;
+    T* out = lo;
+    while (a != a_end && b != hi) {
+      if (less(*b, *a)) {
+        relo(out++, b++);
+      } else {
+        relo(out++, a++);
+      }
+    }
+    relo(out, a, a_end - a);
+  } else {
+    // Move the right run out of the way and merge backwards.
+    T* b = buf + (hi - mid);
+    relo(buf, mid, hi - mid);
+
+    T* a = mid;
+    T* out = hi;
+    while (a != lo && b != buf) {
+      if (less(b[-1], a[-1])) {
+        relo(--out, --a);
+      } else {
+        relo(--out, --b);
+      }
+    }
+    relo(a, buf, b - buf);
+  }
+}
+
+/// Sorts `data` with a bottom-up merge sort, using `alloc` to allocate a
+/// scratch buffer for half of the input. Stable.
+template <typename T>
+constexpr void merge_sort(T* data, size_t len, auto&& less, auto& alloc) {
+  if (std::is_constant_evaluated()) {
+    insertion_sort(data, data + len, less);
+    return;
+  }
+  if (len <= MergeRun) {
+    insertion_sort(data, data + len, less);
+    return;
+  }
+
+  for (size_t i = 0; i < len; i += MergeRun) {
+    insertion_sort(data + i, data + best::min(i + MergeRun, len), less);
+  }
+
+  auto layout = best::layout::array<T>(len / 2);
+  T* buf = static_cast<T*>(alloc.alloc(layout).raw());
+  for (size_t width = MergeRun; width < len; width *= 2) {
+    for (size_t lo = 0; lo + width < len; lo += 2 * width) {
+      merge(data + lo, data + lo + width,
+            data + best::min(lo + 2 * width, len), buf, less);
+    }
+  }
+  alloc.dealloc(buf, layout);
+}
+
+/// Sorts `data` with an LSD radix sort on `key`, one byte at a time, using
+/// `alloc` to allocate a scratch buffer the size of the input. Stable.
+template <typename T>
+void radix_sort(T* data, size_t len, auto&& key, auto& alloc) {
+  using U = decltype(radix_bits(key(*data)));
+  constexpr size_t Bytes = sizeof(U);
+  auto digit = [&](const T& value, size_t byte) -> size_t {
+    return (radix_bits(key(value)) >> (byte * 8)) & 0xff;
+  };
+
+  // Build the histograms for every pass up front, so that the data only needs
+  // to be scanned once.
+  size_t counts[Bytes][256] = {};
+  for (size_t i = 0; i < len; ++i) {
+    U bits = radix_bits(key(data[i]));
+    for (size_t b = 0; b < Bytes; ++b) {
+      ++counts[b][(bits >> (b * 8)) & 0xff];
+    }
+  }
+
+  auto layout = best::layout::array<T>(len);
+  T* buf = static_cast<T*>(alloc.alloc(layout).raw());
+  T* src = data;
+  T* dst = buf;
+  for (size_t b = 0; b < Bytes; ++b) {
+    // If every key has the same digit here, this pass would not move
+    // anything. This is very common for small keys in wide integers.
+    if (counts[b][digit(*src, b)] == len) { continue; }
+
+    size_t offsets[256];
+    size_t total = 0;
+    for (size_t d = 0; d < 256; ++d) {
+      offsets[d] = total;
+      total += counts[b][d];
+    }
+    for (size_t i = 0; i < len; ++i) {
+      relo(dst + offsets[digit(src[i], b)]++, src + i);
+    }
+    std::swap(src, dst);
+  }
+
+  if (src != data) { relo(data, src, len); }
+  alloc.dealloc(buf, layout);
+}
+
+/// Whether `K` is a string whose code units, compared as unsigned integers,
+/// order the same way as its runes do.
+///
+/// This is `best::is_string` plus `encoding_about::is_lexicographic`, spelled
+/// out by hand because best/text depends on this library.
+template <typename K>
+concept lexicographic_string =
+  best::contiguous<K> && std::is_integral_v<best::data_type<K>> &&
+  requires(best::ftadle& tag, const K& value) {
+    requires best::as_auto<decltype(BestEncoding(tag, value))>::About
+      .is_lexicographic;
+  };
+
+/// Returns the code unit at `depth` in `str`, plus one, or zero if `str` is
+/// exactly `depth` codes long.
+template <typename K>
+constexpr size_t code_at(const K& str, size_t depth) {
+  using C = std::make_unsigned_t<best::un_qual<best::data_type<K>>>;
+  if (depth >= best::size(str)) { return 0; }
+  return size_t(C(best::data(str)[depth])) + 1;
+}
+
+/// Compares two strings as spans of unsigned code units, ignoring the first
+/// `depth` codes, which the caller knows to be equal.
+template <typename K>
+constexpr bool less_from(const K& a, const K& b, size_t depth) {
+  using C = std::make_unsigned_t<best::un_qual<best::data_type<K>>>;
+  size_t a_len = best::size(a), b_len = best::size(b);
+  auto* a_data = best::data(a);
+  auto* b_data = best::data(b);
+  for (size_t i = depth; i < a_len && i < b_len; ++i) {
+    C x = a_data[i], y = b_data[i];
+    if (x != y) { return x < y; }
+  }
+  return a_len < b_len;
+}
+
+/// Returns the length of the longest common prefix of every key in `data`,
+/// ignoring the first `depth` code units, which are known to be equal.
+template <typename T>
+constexpr size_t common_prefix(T* data, size_t len, auto& key, size_t depth) {
+  const auto& first = key(data[0]);
+  size_t prefix = best::size(first) - depth;
+  for (size_t i = 1; i < len && prefix > 0; ++i) {
+    const auto& next = key(data[i]);
+    size_t j = 0;
+    size_t max = best::min(prefix, best::size(next) - depth);
+    while (j < max && best::data(first)[depth + j] ==
+                        best::data(next)[depth + j]) {
+      ++j;
+    }
+    prefix = j;
+  }
+  return prefix;
+}
+
+/// Sorts `data` by the string `key` with multikey quicksort (Bentley and
+/// Sedgewick's three-way radix quicksort). Every element of `data` is assumed
+/// to share its first `depth` code units.
+///
+/// `bad_allowed` is the number of badly unbalanced partitions we tolerate
+/// before switching to pdqsort, as in `pdqsort_loop()`.
+template <typename T>
+constexpr void multikey_sort(T* data, size_t len, auto& key, size_t depth,
+                             size_t bad_allowed) {
+  auto code = [&](const T& x) { return code_at(key(x), depth); };
+  auto less = [&](const T& a, const T& b) {
+    return less_from(key(a), key(b), depth);
+  };
+  while (len > InsertionThreshold) {
+    // Skip over any prefix that every key shares. Without this, a long common
+    // prefix would cost a full partitioning pass per code unit.
+    depth += common_prefix(data, len, key, depth);
+
+    size_t a = code(data[0]), b = code(data[len / 2]), c = code(data[len - 1]);
+    size_t pivot = best::max(best::min(a, b), best::min(best::max(a, b), c));
+
+    // Three-way partition on the code at `depth`.
+    size_t lt = 0, i = 0, gt = len;
+    while (i < gt) {
+      size_t x = code(data[i]);
+      if (x < pivot) {
+        swap_at(data + lt++, data + i++);
+      } else if (x > pivot) {
+        swap_at(data + i, data + --gt);
+      } else {
+        ++i;
+      }
+    }
+
+    // The middle part shares one more code unit, unless the keys all ended
+    // here, in which case they are equal and already sorted.
+    struct part {
+      T* data;
+      size_t len, depth;
+    };
+    part parts[] = {
+      {data, lt, depth},
+      {data + lt, pivot == 0 ? 0 : gt - lt, depth + 1},
+      {data + gt, len - gt, depth},
+    };
+
+    // Loop on the largest part and recurse into the others, which are each at
+    // most half of the input. This bounds the recursion depth at log2(len).
+    size_t big = 0;
+    for (size_t k = 1; k < 3; ++k) {
+      if (parts[k].len > parts[big].len) { big = k; }
+    }
+
+    // Keeping most of the input on one side without consuming a code unit
+    // means the pivots are being chosen badly. Too many of these and we fall
+    // back to pdqsort, which will itself fall back to heapsort if needed.
+    if (big != 1 && parts[big].len > len - len / 8 && --bad_allowed == 0) {
+      pdqsort<false>(data, len, less);
+      return;
+    }
+
+    for (size_t k = 0; k < 3; ++k) {
+      if (k != big) {
+        multikey_sort(parts[k].data, parts[k].len, key, parts[k].depth,
+                      bad_allowed);
+      }
+    }
+    data = parts[big].data;
+    len = parts[big].len;
+    depth = parts[big].depth;
+  }
+
+  insertion_sort(data, data + len, less);
+}
+
+/// Returns whether `sort_by_key()` will use radix sort for this input.
+template <typename T, typename K>
+constexpr bool use_radix(size_t len) {
+  return radix_key<K> && best::size_of<T> <= RadixMaxElem &&
+         len >= RadixThreshold * sizeof(K) && !std::is_constant_evaluated();
+}
+
+/// Sorts `data` by the given key function, picking the best algorithm for the
+/// key type.
+template <typename T>
+constexpr void sort_by_key(T* data, size_t len, auto&& key, bool stable,
+                           auto&& alloc) {
+  if (len < 2) { return; }
+
+  using K = best::as_auto<decltype(key(*data))>;
+  if constexpr (radix_key<K>) {
+    if (use_radix<T, K>(len)) {
+      radix_sort(data, len, key, alloc);
+      return;
+    }
+  } else if constexpr (lexicographic_string<K>) {
+    if (stable) {
+      // Merge sort still rescans prefixes, but comparing code units directly
+      // is much cheaper than the rune-by-rune comparison `operator<` may
+      // perform between different string types.
+      merge_sort(
+        data, len,
+        [&](const T& a, const T& b) { return less_from(key(a), key(b), 0); },
+        alloc);
+    } else {
+      multikey_sort(data, len, key, 0, log2(len));
+    }
+    return;
+  }
+
+  // Floats are compared by their radix bits, so that the result is ordered by
+  // `totalOrder` no matter which side of the radix threshold the input falls.
+  auto less = [&](const T& a, const T& b) {
+    if constexpr (std::is_floating_point_v<K>) {
+      return radix_bits(key(a)) < radix_bits(key(b));
+    } else {
+      return key(a) < key(b);
+    }
+  };
+  if (stable) {
+    merge_sort(data, len, less, alloc);
+  } else {
+    pdqsort<radix_key<K>>(data, len, less);
+  }
+}
+
+/// Sorts `data` by the given comparison, which returns whether one element is
+/// less than another.
+template <typename T>
+constexpr void sort_by_less(T* data, size_t len, auto&& less, bool stable,
+                            auto&& alloc) {
+  if (stable) {
+    merge_sort(data, len, less, alloc);
+  } else {
+    pdqsort<false>(data, len, less);
+  }
+}
+}  // namespace best::sort_internal
+
+#endif  // BEST_MEMORY_INTERNAL_SORT_H_
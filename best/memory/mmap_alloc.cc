@@ -0,0 +1,195 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/memory/mmap_alloc.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+
+#include "best/base/hint.h"
+#include "best/log/internal/crash.h"
+#include "best/math/int.h"
+#include "best/memory/allocator.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#define BEST_MMAP_ALLOC_ 1
+#else
+#define BEST_MMAP_ALLOC_ 0
+#endif
+
+namespace best {
+namespace {
+constexpr size_t PageSize = 4096;
+
+// Returns whether `layout` should be mapped rather than malloc'd.
+bool use_mmap(best::layout layout) {
+  return BEST_MMAP_ALLOC_ && layout.size() >= mmap_alloc::Threshold &&
+         layout.align() <= PageSize;
+}
+
+// Returns the length of the mapping that backs an allocation of `size` bytes.
+size_t map_size(size_t size) {
+  return (size + mmap_alloc::HugePageSize - 1) &
+         ~(mmap_alloc::HugePageSize - 1);
+}
+
+// malloc() may report more usable space than was asked for. That slack must
+// never push a malloc'd block to Threshold or above, since callers pass the
+// reported size back in later layouts, and we would then mistake the block for
+// a mapping.
+best::allocation clamp_slack(best::allocation a, best::layout layout) {
+  if (layout.size() < mmap_alloc::Threshold) {
+    size_t max = (mmap_alloc::Threshold - 1) & ~(layout.align() - 1);
+    a.size = best::min(a.size, max);
+  }
+  return a;
+}
+
+void check_addr(best::ptr<void> p) {
+  if (p == nullptr) {
+    best::crash_internal::crash("attempted to de/reallocate a null pointer");
+  }
+}
+
+#if BEST_MMAP_ALLOC_
+// Set once MAP_HUGETLB fails, so that we don't keep making a syscall that is
+// doomed to fail on systems without reserved huge pages.
+std::atomic<bool> no_hugetlb = false;
+
+void* map(size_t len) {
+  constexpr int Prot = PROT_READ | PROT_WRITE;
+  constexpr int Flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+  if (!no_hugetlb.load(std::memory_order_relaxed)) {
+    void* p = ::mmap(nullptr, len, Prot, Flags | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) { return p; }
+    no_hugetlb.store(true, std::memory_order_relaxed);
+  }
+
+  void* p = ::mmap(nullptr, len, Prot, Flags, -1, 0);
+  if (best::unlikely(p == MAP_FAILED)) {
+    best::crash_internal::crash("mmap() failed on %zu bytes: %s", len,
+                                std::strerror(errno));
+  }
+
+  // This is only a hint, so we don't care if it fails.
+  ::madvise(p, len, MADV_HUGEPAGE);
+  return p;
+}
+
+void unmap(void* p, size_t len) {
+  if (best::unlikely(::munmap(p, len) != 0)) {
+    best::crash_internal::crash("munmap() failed on %p, %zu bytes: %s", p, len,
+                                std::strerror(errno));
+  }
+}
+
+// Resizes a mapping. Returns null on failure.
+void* remap(void* p, size_t old_len, size_t new_len, bool may_move) {
+  void* q = ::mremap(p, old_len, new_len, may_move ? MREMAP_MAYMOVE : 0);
+  return q == MAP_FAILED ? nullptr : q;
+}
+#else
+void* map(size_t) { best::crash_internal::crash("mmap() is not supported"); }
+void unmap(void*, size_t) {
+  best::crash_internal::crash("munmap() is not supported");
+}
+void* remap(void*, size_t, size_t, bool) { return nullptr; }
+#endif
+}  // namespace
+
+best::ptr<void> mmap_alloc::alloc(best::layout layout) {
+  if (!use_mmap(layout)) { return best::malloc::alloc(layout); }
+  return map(map_size(layout.size()));
+}
+
+best::ptr<void> mmap_alloc::zalloc(best::layout layout) {
+  if (!use_mmap(layout)) { return best::malloc::zalloc(layout); }
+  // Fresh anonymous mappings are always zeroed.
+  return map(map_size(layout.size()));
+}
+
+best::ptr<void> mmap_alloc::realloc(best::ptr<void> ptr, best::layout old,
+                                    best::layout layout) {
+  return realloc_at_least(ptr, old, layout).ptr;
+}
+
+void mmap_alloc::dealloc(best::ptr<void> ptr, best::layout layout) {
+  check_addr(ptr);
+  if (!use_mmap(layout)) { return best::malloc::dealloc(ptr, layout); }
+  unmap(ptr.raw(), map_size(layout.size()));
+}
+
+best::allocation mmap_alloc::alloc_at_least(best::layout layout) {
+  if (!use_mmap(layout)) {
+    return clamp_slack(best::malloc::alloc_at_least(layout), layout);
+  }
+  size_t len = map_size(layout.size());
+  return {map(len), len};
+}
+
+best::allocation mmap_alloc::realloc_at_least(best::ptr<void> ptr,
+                                              best::layout old,
+                                              best::layout layout) {
+  check_addr(ptr);
+  bool old_mapped = use_mmap(old);
+  bool new_mapped = use_mmap(layout);
+
+  if (!old_mapped && !new_mapped) {
+    return clamp_slack(best::malloc::realloc_at_least(ptr, old, layout),
+                       layout);
+  }
+
+  if (old_mapped && new_mapped) {
+    size_t old_len = map_size(old.size());
+    size_t new_len = map_size(layout.size());
+    if (old_len == new_len) { return {ptr, new_len}; }
+    if (void* p = remap(ptr.raw(), old_len, new_len, true)) {
+      return {p, new_len};
+    }
+  }
+
+  // Moving between malloc and a mapping (or a failed mremap()) requires a
+  // copy.
+  auto fresh = alloc_at_least(layout);
+  std::memcpy(fresh.ptr.raw(), ptr.raw(), best::min(old.size(), layout.size()));
+  dealloc(ptr, old);
+  return fresh;
+}
+
+bool mmap_alloc::grow_in_place(best::ptr<void> ptr, best::layout old,
+                               best::layout layout) {
+  check_addr(ptr);
+  bool old_mapped = use_mmap(old);
+  bool new_mapped = use_mmap(layout);
+
+  if (!old_mapped && !new_mapped) {
+    return best::malloc::grow_in_place(ptr, old, layout);
+  }
+  if (old_mapped != new_mapped) { return false; }
+
+  size_t old_len = map_size(old.size());
+  size_t new_len = map_size(layout.size());
+  return old_len == new_len ||
+         remap(ptr.raw(), old_len, new_len, false) != nullptr;
+}
+}  // namespace best
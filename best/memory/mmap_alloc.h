@@ -0,0 +1,80 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_MEMORY_MMAP_ALLOC_H_
+#define BEST_MEMORY_MMAP_ALLOC_H_
+
+#include <cstddef>
+
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+#include "best/memory/ptr.h"
+
+//! Page-mapping allocation.
+//!
+//! `best::mmap_alloc` is an allocator for very large buffers, which maps them
+//! directly from the kernel, preferring huge pages.
+
+namespace best {
+/// # `best::mmap_alloc`
+///
+/// An allocator that serves large layouts with anonymous memory mappings.
+///
+/// Layouts of at least `Threshold` bytes are rounded up to a multiple of
+/// `HugePageSize` and mapped with `MAP_HUGETLB`. If the system has no huge
+/// pages reserved, they are mapped normally and then marked with
+/// `madvise(MADV_HUGEPAGE)`, so that transparent huge pages can back them
+/// instead. Resizing uses `mremap()`, which moves pages rather than copying
+/// them.
+///
+/// Smaller layouts, layouts aligned to more than a page, and every layout on
+/// platforms other than Linux are forwarded to `best::malloc`.
+///
+/// Unlike `best::malloc`, this allocator does not fill fresh memory with junk
+/// in debug mode, since doing so would fault in every page of the mapping.
+///
+/// See `best::allocator` for information on what the functions on this type do.
+struct mmap_alloc final {
+  /// # `mmap_alloc::Threshold`
+  ///
+  /// The smallest layout that is served with a mapping.
+  static constexpr size_t Threshold = 1024 * 1024;
+
+  /// # `mmap_alloc::HugePageSize`
+  ///
+  /// The size that mappings are rounded up to.
+  static constexpr size_t HugePageSize = 2 * 1024 * 1024;
+
+  static best::ptr<void> alloc(layout layout);
+  static best::ptr<void> zalloc(layout layout);
+  static best::ptr<void> realloc(best::ptr<void> ptr, layout old,
+                                 layout layout);
+  static void dealloc(best::ptr<void> ptr, layout layout);
+
+  static best::allocation alloc_at_least(layout layout);
+  static best::allocation realloc_at_least(best::ptr<void> ptr, layout old,
+                                           layout layout);
+  static bool grow_in_place(best::ptr<void> ptr, layout old, layout layout);
+
+  constexpr bool operator==(const mmap_alloc&) const = default;
+};
+static_assert(best::allocator<best::mmap_alloc>);
+}  // namespace best
+
+#endif  // BEST_MEMORY_MMAP_ALLOC_H_
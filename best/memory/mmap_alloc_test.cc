@@ -0,0 +1,82 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/memory/mmap_alloc.h"
+
+#include <cstdint>
+
+#include "best/container/vec.h"
+#include "best/test/test.h"
+
+namespace best::mmap_alloc_test {
+best::test Small = [](auto& t) {
+  auto p = best::mmap_alloc::alloc(best::layout::of<int>());
+  *p.cast(best::types<int>) = 42;
+  t.expect_eq(*p.cast(best::types<int>), 42);
+  best::mmap_alloc::dealloc(p, best::layout::of<int>());
+};
+
+best::test Large = [](auto& t) {
+  constexpr size_t N = best::mmap_alloc::Threshold * 3;
+  auto p = best::mmap_alloc::zalloc(best::layout::array<char>(N));
+  auto bytes = p.cast(best::types<char>).raw();
+  t.expect_eq(bytes[0], 0);
+  t.expect_eq(bytes[N - 1], 0);
+  bytes[0] = 'a';
+  bytes[N - 1] = 'z';
+
+  p = best::mmap_alloc::realloc(p, best::layout::array<char>(N),
+                                best::layout::array<char>(N * 4));
+  bytes = p.cast(best::types<char>).raw();
+  t.expect_eq(bytes[0], 'a');
+  t.expect_eq(bytes[N - 1], 'z');
+
+  // Shrinking below the threshold should move the data back to the heap.
+  p = best::mmap_alloc::realloc(p, best::layout::array<char>(N * 4),
+                                best::layout::array<char>(16));
+  bytes = p.cast(best::types<char>).raw();
+  t.expect_eq(bytes[0], 'a');
+  best::mmap_alloc::dealloc(p, best::layout::array<char>(16));
+};
+
+best::test Boundary = [](auto& t) {
+  // malloc's slack must not be reported past the threshold, or freeing with
+  // the reported size would try to unmap a malloc'd pointer.
+  constexpr size_t N = best::mmap_alloc::Threshold - 8;
+  auto [p, size] =
+    best::mmap_alloc::alloc_at_least(best::layout::array<char>(N));
+  t.expect_ge(size, N);
+  t.expect_lt(size, best::mmap_alloc::Threshold);
+
+  auto [q, size2] = best::mmap_alloc::realloc_at_least(
+    p, best::layout::array<char>(size), best::layout::array<char>(N - 8));
+  t.expect_ge(size2, N - 8);
+  t.expect_lt(size2, best::mmap_alloc::Threshold);
+  best::mmap_alloc::dealloc(q, best::layout::array<char>(size2));
+};
+
+best::test Vec = [](auto& t) {
+  best::vec<uint64_t, 0, best::mmap_alloc> table;
+  for (uint64_t i = 0; i < 1024 * 1024; ++i) { table.push(i * i); }
+
+  t.expect_eq(table.size(), 1024 * 1024);
+  t.expect_eq(table[1000], 1000 * 1000);
+  t.expect_eq(table.capacity() % (best::mmap_alloc::HugePageSize / 8), 0);
+};
+}  // namespace best::mmap_alloc_test
@@ -0,0 +1,267 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/memory/pool_alloc.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+
+#include "best/base/hint.h"
+#include "best/base/port.h"
+#include "best/log/internal/crash.h"
+#include "best/math/int.h"
+
+namespace best {
+namespace {
+// The size classes served by the pool. All classes after the first are
+// multiples of 16, so that every object in a slab is 16-aligned.
+constexpr size_t Classes[] = {
+  8,   16,  32,  48,  64,  80,  96,  112, 128, 160,  192,
+  224, 256, 320, 384, 448, 512, 640, 768, 896, 1024,
+};
+constexpr size_t NumClasses = sizeof(Classes) / sizeof(Classes[0]);
+static_assert(Classes[NumClasses - 1] == pool_alloc::MaxSize);
+
+// The size of a slab that fresh objects are carved out of.
+constexpr size_t SlabSize = 64 * 1024;
+
+// Maps a size, in 16-byte units rounded up, to its size class.
+constexpr auto ClassTable = [] {
+  std::array<uint8_t, pool_alloc::MaxSize / 16 + 1> table{};
+  size_t cls = 1;
+  for (size_t i = 0; i < table.size(); ++i) {
+    while (Classes[cls] < i * 16) { ++cls; }
+    table[i] = cls;
+  }
+  return table;
+}();
+
+// Returns the size class for `layout`, or `NumClasses` if it should go to
+// `best::malloc` instead.
+size_t class_of(best::layout layout) {
+  size_t size = best::max(layout.size(), layout.align());
+  if (best::unlikely(size > pool_alloc::MaxSize ||
+                     layout.align() > pool_alloc::MaxAlign)) {
+    return NumClasses;
+  }
+  if (size <= 8) { return 0; }
+  return ClassTable[(size + 15) / 16];
+}
+
+// The number of objects moved between a thread and the depot at once. Smaller
+// objects move in larger batches, so that a batch is roughly constant in
+// bytes.
+size_t batch_size(size_t cls) {
+  constexpr size_t Min = 8, Max = 128;
+  return best::min(best::max(8192 / Classes[cls], Min), Max);
+}
+
+// A free object. Free objects form intrusive singly-linked lists.
+struct node final {
+  node* next;
+};
+
+// The global store of free objects for some size class.
+struct depot final {
+  std::mutex mu;
+  node* free = nullptr;
+  char* slab = nullptr;
+  char* slab_end = nullptr;
+};
+
+depot& depot_for(size_t cls) {
+  // Deliberately leaked, so that threads that exit during static destruction
+  // can still return their caches.
+  static depot* depots = new depot[NumClasses];
+  return depots[cls];
+}
+
+// Takes up to `batch_size(cls)` objects out of the depot, carving new ones out
+// of a slab if the depot is running low.
+node* refill(size_t cls, size_t& count) {
+  depot& d = depot_for(cls);
+  size_t want = batch_size(cls);
+  size_t size = Classes[cls];
+
+  std::lock_guard lock(d.mu);
+  node* head = nullptr;
+  count = 0;
+  while (count < want && d.free != nullptr) {
+    node* n = d.free;
+    d.free = n->next;
+    n->next = head;
+    head = n;
+    ++count;
+  }
+
+  while (count < want) {
+    if (d.slab == d.slab_end) {
+      d.slab = static_cast<char*>(
+        best::malloc::alloc(best::layout(unsafe("SlabSize is a multiple of 16"),
+                                         SlabSize, pool_alloc::MaxAlign))
+          .raw());
+      d.slab_end = d.slab + (SlabSize / size) * size;
+    }
+
+    auto* n = reinterpret_cast<node*>(d.slab);
+    d.slab += size;
+    n->next = head;
+    head = n;
+    ++count;
+  }
+
+  return head;
+}
+
+// Returns the list `head..tail` to the depot.
+void flush(size_t cls, node* head, node* tail) {
+  depot& d = depot_for(cls);
+  std::lock_guard lock(d.mu);
+  tail->next = d.free;
+  d.free = head;
+}
+
+// A thread's private cache of free objects.
+struct cache final {
+  struct list final {
+    node* head = nullptr;
+    size_t len = 0;
+  };
+  list lists[NumClasses];
+
+  ~cache() {
+    for (size_t cls = 0; cls < NumClasses; ++cls) {
+      node* head = lists[cls].head;
+      if (head == nullptr) { continue; }
+
+      node* tail = head;
+      while (tail->next != nullptr) { tail = tail->next; }
+      flush(cls, head, tail);
+    }
+  }
+};
+thread_local cache tls;
+
+void check_addr(best::ptr<void> p) {
+  if (p == nullptr) {
+    best::crash_internal::crash("attempted to de/reallocate a null pointer");
+  }
+}
+}  // namespace
+
+best::ptr<void> pool_alloc::alloc(best::layout layout) {
+  size_t cls = class_of(layout);
+  if (cls == NumClasses) { return best::malloc::alloc(layout); }
+
+  auto& list = tls.lists[cls];
+  if (best::unlikely(list.head == nullptr)) {
+    list.head = refill(cls, list.len);
+  }
+
+  node* n = list.head;
+  list.head = n->next;
+  --list.len;
+
+  if (best::is_debug()) { std::memset(n, 0xcd, layout.size()); }
+  return n;
+}
+
+best::ptr<void> pool_alloc::zalloc(best::layout layout) {
+  size_t cls = class_of(layout);
+  if (cls == NumClasses) { return best::malloc::zalloc(layout); }
+
+  auto p = alloc(layout);
+  std::memset(p.raw(), 0, layout.size());
+  return p;
+}
+
+best::ptr<void> pool_alloc::realloc(best::ptr<void> ptr, best::layout old,
+                                    best::layout layout) {
+  check_addr(ptr);
+  size_t old_cls = class_of(old);
+  size_t new_cls = class_of(layout);
+  if (old_cls == NumClasses && new_cls == NumClasses) {
+    return best::malloc::realloc(ptr, old, layout);
+  }
+  if (old_cls == new_cls) { return ptr; }
+
+  auto p = alloc(layout);
+  std::memcpy(p.raw(), ptr.raw(), best::min(old.size(), layout.size()));
+  dealloc(ptr, old);
+  return p;
+}
+
+void pool_alloc::dealloc(best::ptr<void> ptr, best::layout layout) {
+  check_addr(ptr);
+  size_t cls = class_of(layout);
+  if (cls == NumClasses) { return best::malloc::dealloc(ptr, layout); }
+
+  if (best::is_debug()) { std::memset(ptr.raw(), 0xcd, layout.size()); }
+
+  auto& list = tls.lists[cls];
+  auto* n = static_cast<node*>(ptr.raw());
+  n->next = list.head;
+  list.head = n;
+  ++list.len;
+
+  size_t batch = batch_size(cls);
+  if (best::unlikely(list.len > 2 * batch)) {
+    // Hand a batch back to the depot, so that a thread that only frees does
+    // not hoard memory that other threads are allocating.
+    node* head = list.head;
+    node* tail = head;
+    for (size_t i = 1; i < batch; ++i) { tail = tail->next; }
+    list.head = tail->next;
+    list.len -= batch;
+    flush(cls, head, tail);
+  }
+}
+
+best::allocation pool_alloc::alloc_at_least(best::layout layout) {
+  size_t cls = class_of(layout);
+  if (cls == NumClasses) { return best::malloc::alloc_at_least(layout); }
+  return {alloc(layout), Classes[cls]};
+}
+
+best::allocation pool_alloc::realloc_at_least(best::ptr<void> ptr,
+                                              best::layout old,
+                                              best::layout layout) {
+  size_t old_cls = class_of(old);
+  size_t new_cls = class_of(layout);
+  if (old_cls == NumClasses && new_cls == NumClasses) {
+    return best::malloc::realloc_at_least(ptr, old, layout);
+  }
+  auto p = realloc(ptr, old, layout);
+  return {p, new_cls == NumClasses ? layout.size() : Classes[new_cls]};
+}
+
+bool pool_alloc::grow_in_place(best::ptr<void> ptr, best::layout old,
+                               best::layout layout) {
+  check_addr(ptr);
+  size_t cls = class_of(old);
+  if (cls == NumClasses) {
+    return class_of(layout) == NumClasses &&
+           best::malloc::grow_in_place(ptr, old, layout);
+  }
+  return class_of(layout) == cls;
+}
+}  // namespace best
@@ -0,0 +1,80 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_MEMORY_POOL_ALLOC_H_
+#define BEST_MEMORY_POOL_ALLOC_H_
+
+#include <cstddef>
+
+#include "best/memory/allocator.h"
+#include "best/memory/layout.h"
+#include "best/memory/ptr.h"
+
+//! Pooled allocation.
+//!
+//! `best::pool_alloc` is an allocator optimized for workloads that allocate
+//! and free many small objects of the same size, such as the nodes of a
+//! linked data structure.
+
+namespace best {
+/// # `best::pool_alloc`
+///
+/// A thread-caching, size-class pool allocator.
+///
+/// Small allocations are rounded up to one of a fixed set of size classes.
+/// Each thread keeps a free list per size class, so allocating and freeing is
+/// usually a pointer pop or push with no synchronization. When a thread's list
+/// runs dry, it refills a whole batch at once from a global depot; when it
+/// grows too long, it returns a batch to the depot.
+///
+/// Memory for small objects is carved out of large slabs that are never
+/// returned to the system; freed objects are only ever recycled. Allocations
+/// larger than `MaxSize` or more aligned than `MaxAlign` are forwarded to
+/// `best::malloc`.
+///
+/// Memory allocated on one thread may be freed on another.
+///
+/// `alloc_at_least()` reports the full size of the size class, and
+/// `grow_in_place()` succeeds whenever the new layout falls in the same class.
+///
+/// See `best::allocator` for information on what the functions on this type do.
+struct pool_alloc final {
+  /// # `pool_alloc::MaxSize`, `pool_alloc::MaxAlign`
+  ///
+  /// The largest layout that is served out of a pool.
+  static constexpr size_t MaxSize = 1024;
+  static constexpr size_t MaxAlign = 16;
+
+  static best::ptr<void> alloc(layout layout);
+  static best::ptr<void> zalloc(layout layout);
+  static best::ptr<void> realloc(best::ptr<void> ptr, layout old,
+                                 layout layout);
+  static void dealloc(best::ptr<void> ptr, layout layout);
+
+  static best::allocation alloc_at_least(layout layout);
+  static best::allocation realloc_at_least(best::ptr<void> ptr, layout old,
+                                           layout layout);
+  static bool grow_in_place(best::ptr<void> ptr, layout old, layout layout);
+
+  constexpr bool operator==(const pool_alloc&) const = default;
+};
+static_assert(best::allocator<best::pool_alloc>);
+}  // namespace best
+
+#endif  // BEST_MEMORY_POOL_ALLOC_H_
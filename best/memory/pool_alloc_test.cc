@@ -0,0 +1,112 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/memory/pool_alloc.h"
+
+#include <thread>
+
+#include "best/container/box.h"
+#include "best/container/vec.h"
+#include "best/test/test.h"
+#include "best/text/strbuf.h"
+
+namespace best::pool_alloc_test {
+best::test Recycle = [](auto& t) {
+  auto p0 = best::pool_alloc::alloc(best::layout::of<int>());
+  best::pool_alloc::dealloc(p0, best::layout::of<int>());
+  auto p1 = best::pool_alloc::alloc(best::layout::of<int>());
+  t.expect_eq(p0.to_addr(), p1.to_addr());
+  best::pool_alloc::dealloc(p1, best::layout::of<int>());
+
+  auto p2 = best::pool_alloc::alloc(best::layout::array<char>(40));
+  t.expect_eq(p2.to_addr() % 16, 0);
+  best::pool_alloc::dealloc(p2, best::layout::array<char>(40));
+
+  auto big = best::pool_alloc::zalloc(best::layout::array<char>(4096));
+  t.expect_eq(big.cast(best::types<char>).raw()[4095], 0);
+  best::pool_alloc::dealloc(big, best::layout::array<char>(4096));
+};
+
+best::test Containers = [](auto& t) {
+  best::box<int, best::pool_alloc> x(best::in_place, 42);
+  t.expect_eq(*x, 42);
+
+  best::vec<int, 0, best::pool_alloc> ints;
+  for (int i = 0; i < 1000; ++i) { ints.push(i); }
+  t.expect_eq(ints.size(), 1000);
+  t.expect_eq(ints[999], 999);
+
+  best::textbuf<best::utf8, best::pool_alloc> buf;
+  buf.push("hello, ");
+  buf.push("world!");
+  t.expect_eq(buf, "hello, world!");
+};
+
+best::test Slack = [](auto& t) {
+  auto a = best::pool_alloc::alloc_at_least(best::layout::array<char>(20));
+  t.expect_eq(a.size, 32);
+  t.expect(best::pool_alloc::grow_in_place(a.ptr, best::layout::array<char>(20),
+                                           best::layout::array<char>(32)));
+  t.expect(!best::pool_alloc::grow_in_place(
+    a.ptr, best::layout::array<char>(32), best::layout::array<char>(33)));
+  best::pool_alloc::dealloc(a.ptr, best::layout::array<char>(32));
+
+  // Large blocks defer to malloc, which does not shrink in place.
+  auto big = best::pool_alloc::alloc(best::layout::array<char>(1 << 20));
+  t.expect(!best::pool_alloc::grow_in_place(
+    big, best::layout::array<char>(1 << 20), best::layout::array<char>(4096)));
+  best::pool_alloc::dealloc(big, best::layout::array<char>(1 << 20));
+
+  // 32 * 9 = 288 bytes, which is rounded up to the 320-byte class; the vector
+  // should make use of the slack.
+  struct Nine {
+    char data[9];
+  };
+  best::vec<Nine, 0, best::pool_alloc> v;
+  v.reserve(32);
+  t.expect_eq(v.capacity(), 35);
+};
+
+best::test Threads = [](auto& t) {
+  constexpr int NumThreads = 4;
+  constexpr int Rounds = 10000;
+
+  std::thread threads[NumThreads];
+  for (auto& th : threads) {
+    th = std::thread([] {
+      best::vec<best::ptr<void>> live;
+      for (int i = 0; i < Rounds; ++i) {
+        live.push(best::pool_alloc::alloc(best::layout::of<int64_t>()));
+        if (i % 3 == 0) {
+          best::pool_alloc::dealloc(*live.pop(), best::layout::of<int64_t>());
+        }
+      }
+      for (auto p : live) {
+        best::pool_alloc::dealloc(p, best::layout::of<int64_t>());
+      }
+    });
+  }
+  for (auto& th : threads) { th.join(); }
+
+  // Memory freed by the other threads should now be available here.
+  auto p = best::pool_alloc::alloc(best::layout::of<int64_t>());
+  t.expect_ne(p.to_addr(), 0);
+  best::pool_alloc::dealloc(p, best::layout::of<int64_t>());
+};
+}  // namespace best::pool_alloc_test
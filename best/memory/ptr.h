@@ -344,6 +344,23 @@ class ptr final {
     };
   }
 
+  /// # `ptr::BestNiches`, `ptr::ptr(niche)`
+  ///
+  /// Pointers have niches: the addresses produced by `best::niche_addr()`,
+  /// except for null, since `best::ptr` is nullable.
+  ///
+  /// This does not apply to fat pointers whose metadata cannot be defaulted.
+  static constexpr size_t BestNiches =
+    best::constructible<metadata> ? best::AddrNiches - 1 : 0;
+
+  explicit ptr(niche nh) requires (BestNiches > 0)
+    : ptr(best::ptr<pointee>::from_addr(niche_addr({nh.index + 1})),
+          metadata{}) {}
+  bool operator==(niche nh) const requires (BestNiches > 0)
+  {
+    return to_addr() == niche_addr({nh.index + 1});
+  }
+
   /// # `ptr::to_pointee()`
   ///
   /// Converts this pointer to a thin `best::ptr` pointing to its pointee type.
@@ -388,8 +405,9 @@ class ptr final {
 
   /// # `ptr::is_niche()`
   ///
-  /// Whether this value is a niche representation.
-  constexpr bool is_niche() const requires thin;
+  /// Whether this value is a niche representation. For types with several
+  /// niches, this checks for the one selected by `nh`.
+  constexpr bool is_niche(niche nh = {}) const requires thin;
 
   /// # `ptr::operator*`, `ptr::operator->`, `ptr::deref()`, `ptr::get()`.
   ///
@@ -530,7 +548,7 @@ class ptr final {
   BEST_INLINE_SYNTHETIC constexpr void assign(best::args<Args...> args) const
     requires constructible<Args...>;
 
-  BEST_INLINE_SYNTHETIC constexpr void construct(niche) const
+  BEST_INLINE_SYNTHETIC constexpr void construct(niche nh) const
     requires thin && best::has_niche<T>;
 
   /// # `ptr::meta_for()`
@@ -787,13 +805,14 @@ ptr(T*) -> ptr<T>;
 
 namespace best {
 template <typename T>
-constexpr bool ptr<T>::is_niche() const requires thin
+constexpr bool ptr<T>::is_niche(niche nh) const requires thin
 {
   if constexpr (best::has_niche<T>) {
     if constexpr (best::is_ref<T>) {
-      return *raw() == nullptr;
+      if (nh.index == 0) { return *raw() == nullptr; }
+      return reinterpret_cast<uintptr_t>(*raw()) == best::niche_addr(nh);
     } else {
-      return **this == niche{};
+      return **this == nh;
     }
   }
   return false;
@@ -920,14 +939,16 @@ BEST_INLINE_SYNTHETIC constexpr void ptr<T>::construct(
   args.row.apply([&](auto&&... args) { construct(BEST_FWD(args)...); });
 }
 template <typename T>
-BEST_INLINE_SYNTHETIC constexpr void ptr<T>::construct(niche) const
+BEST_INLINE_SYNTHETIC constexpr void ptr<T>::construct(niche nh) const
   requires thin && best::has_niche<T>
 {
   check();
   if constexpr (best::is_object<T>) {
-    new (raw()) T(niche{});
+    new (raw()) T(nh);
   } else if constexpr (best::is_ref<T>) {
-    *const_cast<best::un_qual<pointee>*>(raw()) = nullptr;
+    using P = best::un_qual<pointee>;
+    *const_cast<P*>(raw()) =
+      nh.index == 0 ? nullptr : reinterpret_cast<P>(best::niche_addr(nh));
   }
 }
 
@@ -132,6 +132,23 @@ static_assert(conv<int, int[]>);
 static_assert(conv<const int, const int[]>);
 static_assert(!conv<const int, int[]>);
 
+static_assert(best::niche_count<best::ptr<int>> == best::AddrNiches - 1);
+static_assert(best::niche_count<best::ptr<int[]>> == best::AddrNiches - 1);
+static_assert(best::niche_count<int&> == best::AddrNiches);
+
+best::test Niches = [](auto& t) {
+  int x = 5;
+  best::ptr<int> x0(best::niche{0});
+  best::ptr<int> x1(best::niche{7});
+  t.expect(x0 == best::niche{0});
+  t.expect(x0 != best::niche{1});
+  t.expect(x1 == best::niche{7});
+  t.expect(x0 != nullptr);
+  t.expect(best::ptr<int>(nullptr) != best::niche{0});
+  t.expect(best::ptr<int>(&x) != best::niche{0});
+  t.expect(best::ptr<int>::dangling() != best::niche{0});
+};
+
 best::test Span = [](auto& t) {
   int xs[] = {1, 2, 3, 4, 5};
   best::ptr<int[5]> x0 = &xs;
@@ -33,6 +33,7 @@
 #include "best/log/location.h"
 #include "best/math/int.h"
 #include "best/math/overflow.h"
+#include "best/memory/allocator.h"
 #include "best/memory/internal/bytes.h"
 #include "best/meta/init.h"
 #include "best/meta/tlist.h"
@@ -578,10 +579,18 @@ class span final {
   /// function, which must return a partial ordering for any pair of elements of
   /// this type.
   ///
-  /// Because this is implemented using the <algorithm> header, which would
-  /// pull in a completely unacceptable amount of stuff, the implementations of
-  /// these functions live in `//best/memory/span_sort.h`, which must be
-  /// included separately.
+  /// Comparison sorts use pattern-defeating quicksort, which is O(n log n) in
+  /// the worst case and linear on sorted or reverse-sorted input. If the key
+  /// (the element itself, or the result of the unary function) is a primitive
+  /// integer or float, large spans are sorted with a radix sort instead.
+  /// Float keys are always ordered by IEEE 754 `totalOrder`, so -0.0 sorts
+  /// before +0.0 and NaNs sort at either end, depending on their sign.
+  /// If the key is a string in a lexicographic encoding, such as UTF-8, it is
+  /// sorted by code units with multikey quicksort, which does not rescan
+  /// common prefixes.
+  ///
+  /// The implementations of these functions live in
+  /// `//best/memory/span_sort.h`, which must be included separately.
   constexpr void sort() const requires best::comparable<T> && (!is_const);
   constexpr void sort(best::callable<void(const T&)> auto&&) const
     requires (!is_const);
@@ -594,6 +603,11 @@ class span final {
   /// Identical to `sort()`, but uses a stable sort which guarantees that equal
   /// items are not reordered past each other. This usually means the algorithm
   /// is slower.
+  ///
+  /// Stable sorting needs scratch space: half the size of the span for a merge
+  /// sort, or all of it for a radix sort. Each overload optionally takes the
+  /// allocator to obtain it from, which defaults to `best::malloc`. During
+  /// constant evaluation, no scratch space is used, and the sort is quadratic.
   constexpr void stable_sort() const requires best::comparable<T> && (!is_const)
   ;
   constexpr void stable_sort(best::callable<void(const T&)> auto&&) const
@@ -601,6 +615,14 @@ class span final {
   constexpr void stable_sort(
     best::callable<best::partial_ord(const T&, const T&)> auto&&) const
     requires (!is_const);
+  constexpr void stable_sort(best::allocator auto alloc) const
+    requires best::comparable<T> && (!is_const);
+  constexpr void stable_sort(best::callable<void(const T&)> auto&&,
+                             best::allocator auto alloc) const
+    requires (!is_const);
+  constexpr void stable_sort(
+    best::callable<best::partial_ord(const T&, const T&)> auto&&,
+    best::allocator auto alloc) const requires (!is_const);
 
   /// # `span::bisect()`
   ///
@@ -20,8 +20,9 @@
 #ifndef BEST_MEMORY_SPAN_SORT_H_
 #define BEST_MEMORY_SPAN_SORT_H_
 
-#include <algorithm>
-
+#include "best/func/call.h"
+#include "best/memory/allocator.h"
+#include "best/memory/internal/sort.h"
 #include "best/memory/span.h"
 
 //! Implementations for best::span::sort and friends.
@@ -33,47 +34,77 @@ template <best::is_object T, best::option<best::dependent<size_t, T>> n>
 constexpr void span<T, n>::sort() const
   requires best::comparable<T> && (!is_const)
 {
-  std::sort(data().raw(), data().raw() + size());
+  best::sort_internal::sort_by_key(
+    data().raw(), size(), [](const T& x) -> const T& { return x; },
+    /*stable=*/false, best::malloc{});
 }
 template <best::is_object T, best::option<best::dependent<size_t, T>> n>
 constexpr void span<T, n>::sort(
   best::callable<void(const T&)> auto&& get_key) const requires (!is_const)
 {
-  std::sort(data().raw(), data().raw() + size(), [&](auto& a, auto& b) {
-    return best::call(BEST_FWD(get_key), a) < best::call(BEST_FWD(get_key), b);
-  });
+  best::sort_internal::sort_by_key(
+    data().raw(), size(),
+    [&](const T& x) -> decltype(auto) { return best::call(get_key, x); },
+    /*stable=*/false, best::malloc{});
 }
 template <best::is_object T, best::option<best::dependent<size_t, T>> n>
 constexpr void span<T, n>::sort(
   best::callable<best::partial_ord(const T&, const T&)> auto&& get_key) const
   requires (!is_const)
 {
-  std::sort(data().raw(), data().raw() + size(), [&](auto& a, auto& b) {
-    return best::call(BEST_FWD(get_key), a, b) < 0;
-  });
+  best::sort_internal::sort_by_less(
+    data().raw(), size(),
+    [&](const T& a, const T& b) { return best::call(get_key, a, b) < 0; },
+    /*stable=*/false, best::malloc{});
 }
+
 template <best::is_object T, best::option<best::dependent<size_t, T>> n>
 constexpr void span<T, n>::stable_sort() const
   requires best::comparable<T> && (!is_const)
 {
-  std::stable_sort(data().raw(), data().raw() + size());
+  stable_sort(best::malloc{});
 }
 template <best::is_object T, best::option<best::dependent<size_t, T>> n>
 constexpr void span<T, n>::stable_sort(
   best::callable<void(const T&)> auto&& get_key) const requires (!is_const)
 {
-  std::stable_sort(data().raw(), data().raw() + size(), [&](auto& a, auto& b) {
-    return best::call(BEST_FWD(get_key), a) < best::call(BEST_FWD(get_key), b);
-  });
+  stable_sort(BEST_FWD(get_key), best::malloc{});
 }
 template <best::is_object T, best::option<best::dependent<size_t, T>> n>
 constexpr void span<T, n>::stable_sort(
   best::callable<best::partial_ord(const T&, const T&)> auto&& get_key) const
   requires (!is_const)
 {
-  std::stable_sort(data().raw(), data().raw() + size(), [&](auto& a, auto& b) {
-    return best::call(BEST_FWD(get_key), a, b) < 0;
-  });
+  stable_sort(BEST_FWD(get_key), best::malloc{});
+}
+
+template <best::is_object T, best::option<best::dependent<size_t, T>> n>
+constexpr void span<T, n>::stable_sort(best::allocator auto alloc) const
+  requires best::comparable<T> && (!is_const)
+{
+  best::sort_internal::sort_by_key(
+    data().raw(), size(), [](const T& x) -> const T& { return x; },
+    /*stable=*/true, alloc);
+}
+template <best::is_object T, best::option<best::dependent<size_t, T>> n>
+constexpr void span<T, n>::stable_sort(
+  best::callable<void(const T&)> auto&& get_key,
+  best::allocator auto alloc) const requires (!is_const)
+{
+  best::sort_internal::sort_by_key(
+    data().raw(), size(),
+    [&](const T& x) -> decltype(auto) { return best::call(get_key, x); },
+    /*stable=*/true, alloc);
+}
+template <best::is_object T, best::option<best::dependent<size_t, T>> n>
+constexpr void span<T, n>::stable_sort(
+  best::callable<best::partial_ord(const T&, const T&)> auto&& get_key,
+  best::allocator auto alloc) const requires (!is_const)
+{
+  best::sort_internal::sort_by_less(
+    data().raw(), size(),
+    [&](const T& a, const T& b) { return best::call(get_key, a, b) < 0; },
+    /*stable=*/true, alloc);
 }
 
 /// # best::mark_sort_header_used()
@@ -19,9 +19,14 @@
 
 #include "best/memory/span.h"
 
+#include <cmath>
+
 #include "best/container/vec.h"
+#include "best/memory/counting_alloc.h"
 #include "best/memory/span_sort.h"
 #include "best/test/test.h"
+#include "best/text/format.h"
+#include "best/text/strbuf.h"
 
 namespace best::span_test {
 static_assert(best::is_span<best::span<int>>);
@@ -362,6 +367,167 @@ best::test Sort = [](auto& t) {
   t.expect_eq(ints, best::span{5, 4, 3, 2, 1});
 };
 
+// A cheap deterministic generator for sort inputs.
+uint64_t xorshift(uint64_t& state) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+best::test SortPatterns = [](auto& t) {
+  uint64_t rng = 0x5eed;
+  for (size_t len : {0, 1, 7, 30, 200, 1000, 5000}) {
+    for (int pattern = 0; pattern < 5; ++pattern) {
+      best::vec<int64_t> v;
+      int64_t sum = 0;
+      for (size_t i = 0; i < len; ++i) {
+        int64_t x = 0;
+        switch (pattern) {
+          case 0: x = xorshift(rng); break;
+          case 1: x = i; break;
+          case 2: x = -int64_t(i); break;
+          case 3: x = xorshift(rng) % 4; break;
+          case 4: x = i < len / 2 ? i : len - i; break;
+        }
+        v.push(x);
+        sum += x;
+      }
+
+      auto w = v;
+      v->sort();
+      w->sort([](int64_t x, int64_t y) { return x <=> y; });
+      t.expect_eq(v, w, "len: {}, pattern: {}", len, pattern);
+      for (size_t i = 1; i < len; ++i) {
+        if (!t.expect_le(v[i - 1], v[i], "len: {}, pattern: {}", len,
+                         pattern)) {
+          break;
+        }
+      }
+      for (int64_t x : v) { sum -= x; }
+      t.expect_eq(sum, 0);
+    }
+  }
+};
+
+best::test SortFloats = [](auto& t) {
+  uint64_t rng = 0xf10a7;
+  best::vec<double> v = {0.0, -0.0, 1.5, -1.5, 1e300, -1e300};
+  while (v.size() < 3000) { v.push(int64_t(xorshift(rng) % 2000) - 1000); }
+
+  v->sort();
+  for (size_t i = 1; i < v.size(); ++i) { t.expect_le(v[i - 1], v[i]); }
+  t.expect_eq(v[0], -1e300);
+  t.expect_eq(v[v.size() - 1], 1e300);
+
+  // Inputs too small to radix sort must still put -0.0 before +0.0.
+  for (bool stable : {false, true}) {
+    best::vec<double> z = {0.0, -0.0, 1.0, 0.0, -0.0};
+    if (stable) {
+      z->stable_sort();
+    } else {
+      z->sort();
+    }
+    t.expect(std::signbit(z[0]) && std::signbit(z[1]), "{}", stable);
+    t.expect(!std::signbit(z[2]) && !std::signbit(z[3]), "{}", stable);
+  }
+};
+
+best::test StableSort = [](auto& t) {
+  struct entry {
+    uint32_t k;
+    size_t idx;
+  };
+
+  uint64_t rng = 0x57ab1e;
+  for (size_t len : {10, 100, 5000}) {
+    best::vec<entry> v;
+    for (size_t i = 0; i < len; ++i) {
+      v.push(entry{uint32_t(xorshift(rng) % 10), i});
+    }
+
+    auto check = [&] {
+      for (size_t i = 1; i < len; ++i) {
+        auto [k0, i0] = v[i - 1];
+        auto [k1, i1] = v[i];
+        if (!t.expect(k0 < k1 || (k0 == k1 && i0 < i1), "len: {}", len)) {
+          return;
+        }
+      }
+    };
+
+    best::alloc_stats stats;
+    v->stable_sort(&entry::k, best::counting_alloc<>(stats));
+    check();
+    t.expect_eq(stats.snapshot().live_bytes, 0);
+
+    v->sort([](const entry& e) { return e.idx; });
+    v->stable_sort([](const entry& a, const entry& b) { return a.k <=> b.k; },
+                   best::counting_alloc<>(stats));
+    check();
+    t.expect_eq(stats.snapshot().live_bytes, 0);
+  }
+
+  best::vec<best::strbuf> strs = {"b", "a", "c", "a"};
+  strs->stable_sort([](const best::strbuf& s) { return s.size(); });
+  t.expect_eq(strs, best::span<const best::str>{"b", "a", "c", "a"});
+  strs->stable_sort();
+  t.expect_eq(strs, best::span<const best::str>{"a", "a", "b", "c"});
+};
+
+best::test SortStrings = [](auto& t) {
+  best::vec<best::strbuf> strs;
+  for (int i = 0; i < 200; ++i) {
+    strs.push(best::format("some/long/prefix/{}", (i * 37) % 200));
+  }
+  strs.push("é");
+  strs.push("z");
+  strs.push("");
+  strs.push("some/long/prefix");
+
+  strs->sort();
+  for (size_t i = 1; i < strs.size(); ++i) {
+    t.expect_le(strs[i - 1], strs[i]);
+  }
+  t.expect_eq(strs[0], "");
+  t.expect_eq(strs[1], "some/long/prefix");
+  t.expect_eq(strs[strs.size() - 1], "é");
+
+  struct entry {
+    best::str k;
+    int v;
+  };
+  best::vec<entry> entries;
+  for (int i = 0; i < 100; ++i) { entries.push(entry{i % 2 ? "b" : "a", i}); }
+  entries->stable_sort(&entry::k);
+  for (size_t i = 1; i < entries.size(); ++i) {
+    t.expect_lt(entries[i - 1].v + (entries[i - 1].k == "a" ? 0 : 1000),
+                entries[i].v + (entries[i].k == "a" ? 0 : 1000));
+  }
+
+  // UTF-16 is not lexicographic, so this needs to compare runes.
+  best::vec<best::strbuf16> strs16 = {u"b", u"\U00010000", u"\uffff", u"a"};
+  strs16->sort();
+  t.expect_eq(strs16, best::span<const best::str16>{u"a", u"b", u"\uffff",
+                                                    u"\U00010000"});
+};
+
+constexpr bool ConstexprSort = [] {
+  int ints[] = {5, 3, 9, 1, 4, 4, 0, 8, 7, 2, 6, 11, 10, 12, 15, 13,
+                14, 19, 18, 17, 16, 22, 21, 20, 25, 23, 24, 26, 27, 30, 29};
+  size_t len = best::span(ints).size();
+  best::span(ints).sort();
+  for (size_t i = 1; i < len; ++i) {
+    if (ints[i - 1] > ints[i]) { return false; }
+  }
+  best::span(ints).stable_sort([](int x) { return -x; });
+  for (size_t i = 1; i < len; ++i) {
+    if (ints[i - 1] < ints[i]) { return false; }
+  }
+  return true;
+}();
+static_assert(ConstexprSort);
+
 best::test Bisect = [](auto& t) {
   int ints[] = {1, 2, 3, 4, 100, 200};
   t.expect_eq(best::span(ints).bisect(3), best::ok(2));
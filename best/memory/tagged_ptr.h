@@ -0,0 +1,174 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#ifndef BEST_MEMORY_TAGGED_PTR_H_
+#define BEST_MEMORY_TAGGED_PTR_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "best/base/hint.h"
+#include "best/log/internal/crash.h"
+#include "best/math/bit.h"
+#include "best/memory/layout.h"
+#include "best/memory/ptr.h"
+
+//! Tagged pointers.
+//!
+//! `best::tagged_ptr<T, bits>` packs a pointer and a small integer tag into a
+//! single word, by storing the tag in the low bits of the pointer that are
+//! always zero due to alignment.
+//!
+//! Because it is a single `uintptr_t`, a `tagged_ptr` can be stored in a
+//! `std::atomic` and updated with a single compare-and-swap, which is the usual
+//! way to attach a version counter or a mark bit to a pointer in lock-free
+//! code. It is also useful for interpreters that want to distinguish between
+//! several kinds of heap object without a separate tag word.
+//!
+//! ```
+//! best::tagged_ptr<Node, 2> p(node, 3);
+//! p.tag();  // 3
+//! p->next;  // Same as node->next.
+//! ```
+
+namespace best {
+/// # `best::tagged_ptr<T, bits>`
+///
+/// A thin pointer to a `T` with a `bits`-bit tag stored in its low bits.
+///
+/// `bits` defaults to all of the bits made available by `T`'s alignment, and
+/// may not exceed it. Constructing a `tagged_ptr` from a misaligned pointer or
+/// from a tag that does not fit in `bits` bits will crash.
+///
+/// A default-constructed `tagged_ptr` is null, with a zero tag. Note that a
+/// null pointer may still carry a nonzero tag.
+template <best::is_thin T,
+          size_t bits = best::trailing_zeros(best::align_of<T>)>
+class tagged_ptr final {
+ public:
+  /// # `tagged_ptr::type`, `tagged_ptr::ptr`
+  ///
+  /// The pointed-to type, and the corresponding untagged pointer type.
+  using type = T;
+  using ptr = best::ptr<T>;
+  using pointee = ptr::pointee;
+
+  /// # `tagged_ptr::Bits`, `tagged_ptr::Mask`
+  ///
+  /// The number of tag bits, and a mask for extracting them.
+  static constexpr size_t Bits = bits;
+  static constexpr uintptr_t Mask = (uintptr_t{1} << bits) - 1;
+
+  static_assert((size_t{1} << bits) <= best::align_of<pointee>,
+                "too many tag bits for the alignment of T");
+
+  /// # `tagged_ptr::tagged_ptr()`
+  ///
+  /// Constructs a null pointer with a zero tag.
+  constexpr tagged_ptr() = default;
+  constexpr tagged_ptr(std::nullptr_t) {}
+
+  /// # `tagged_ptr::tagged_ptr(ptr, tag)`
+  ///
+  /// Constructs a tagged pointer from a pointer and a tag.
+  tagged_ptr(ptr p, size_t tag = 0);
+
+  /// # `tagged_ptr::tagged_ptr(tagged_ptr)`
+  ///
+  /// Trivially copyable.
+  constexpr tagged_ptr(const tagged_ptr&) = default;
+  constexpr tagged_ptr& operator=(const tagged_ptr&) = default;
+  constexpr tagged_ptr(tagged_ptr&&) = default;
+  constexpr tagged_ptr& operator=(tagged_ptr&&) = default;
+
+  /// # `tagged_ptr::to_bits()`, `tagged_ptr::from_bits()`
+  ///
+  /// Converts to and from the packed representation. `from_bits()` accepts any
+  /// value produced by `to_bits()`.
+  constexpr uintptr_t to_bits() const { return bits_; }
+  static constexpr tagged_ptr from_bits(uintptr_t bits) {
+    tagged_ptr p;
+    p.bits_ = bits;
+    return p;
+  }
+
+  /// # `tagged_ptr::as_ptr()`, `tagged_ptr::tag()`
+  ///
+  /// Extracts the pointer and the tag.
+  ptr as_ptr() const { return ptr::from_addr(bits_ & ~Mask); }
+  constexpr size_t tag() const { return bits_ & Mask; }
+
+  /// # `tagged_ptr::with_ptr()`, `tagged_ptr::with_tag()`
+  ///
+  /// Returns a copy of this pointer with the pointer or the tag replaced.
+  tagged_ptr with_ptr(ptr p) const { return {p, tag()}; }
+  tagged_ptr with_tag(size_t tag) const { return {as_ptr(), tag}; }
+
+  /// # `tagged_ptr::operator*`, `tagged_ptr::operator->`
+  ///
+  /// Dereferences the pointer, ignoring the tag.
+  decltype(auto) operator*() const { return *as_ptr(); }
+  auto operator->() const { return as_ptr().operator->(); }
+
+  /// # `tagged_ptr::operator==`
+  ///
+  /// Two tagged pointers are equal if both their pointers and their tags are.
+  /// Comparing to `nullptr` ignores the tag.
+  constexpr bool operator==(const tagged_ptr&) const = default;
+  constexpr bool operator==(std::nullptr_t) const {
+    return (bits_ & ~Mask) == 0;
+  }
+
+  friend void BestFmt(auto& fmt, const tagged_ptr& p) {
+    fmt.format("{}#{}", p.as_ptr(), p.tag());
+  }
+  constexpr friend void BestFmtQuery(auto& query, tagged_ptr*) {
+    query.requires_debug = false;
+  }
+
+ private:
+  uintptr_t bits_ = 0;
+};
+
+template <typename T>
+tagged_ptr(T*) -> tagged_ptr<T>;
+template <typename T>
+tagged_ptr(T*, size_t) -> tagged_ptr<T>;
+}  // namespace best
+
+/* ////////////////////////////////////////////////////////////////////////// *\
+ * ////////////////// !!! IMPLEMENTATION DETAILS BELOW !!! ////////////////// *
+\* ////////////////////////////////////////////////////////////////////////// */
+
+namespace best {
+template <best::is_thin T, size_t bits>
+tagged_ptr<T, bits>::tagged_ptr(ptr p, size_t tag) : bits_(p.to_addr()) {
+  if (best::unlikely((bits_ & Mask) != 0)) {
+    best::crash_internal::crash("misaligned pointer in tagged_ptr: %p",
+                                (const void*)p.raw());
+  }
+  if (best::unlikely(tag > Mask)) {
+    best::crash_internal::crash("tag does not fit in %zu bits: %zu", Bits,
+                                tag);
+  }
+  bits_ |= tag;
+}
+}  // namespace best
+
+#endif  // BEST_MEMORY_TAGGED_PTR_H_
@@ -0,0 +1,77 @@
+/* //-*- C++ -*-///////////////////////////////////////////////////////////// *\
+
+  Copyright 2024
+  Miguel Young de la Sota and the Best Contributors 🧶🐈‍⬛
+
+  Licensed under the Apache License, Version 2.0 (the "License"); you may not
+  use this file except in compliance with the License. You may obtain a copy
+  of the License at
+
+                https://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+  License for the specific language governing permissions and limitations
+  under the License.
+
+\* ////////////////////////////////////////////////////////////////////////// */
+
+#include "best/memory/tagged_ptr.h"
+
+#include <atomic>
+
+#include "best/test/test.h"
+
+namespace best::tagged_ptr_test {
+static_assert(sizeof(best::tagged_ptr<int>) == sizeof(int*));
+static_assert(best::tagged_ptr<int>::Bits == 2);
+static_assert(best::tagged_ptr<uint64_t>::Bits == 3);
+static_assert(best::tagged_ptr<char>::Bits == 0);
+static_assert(std::is_trivially_copyable_v<best::tagged_ptr<int>>);
+
+best::test Basic = [](auto& t) {
+  int x = 42;
+  best::tagged_ptr<int> x0;
+  t.expect_eq(x0, nullptr);
+  t.expect_eq(x0.tag(), 0);
+
+  best::tagged_ptr<int> x1(&x, 3);
+  t.expect_eq(x1.as_ptr(), &x);
+  t.expect_eq(x1.tag(), 3);
+  t.expect_eq(*x1, 42);
+  t.expect_ne(x1, nullptr);
+
+  auto x2 = x1.with_tag(1);
+  t.expect_eq(x2.as_ptr(), &x);
+  t.expect_eq(x2.tag(), 1);
+  t.expect_ne(x1, x2);
+  t.expect_eq(x1, x2.with_tag(3));
+
+  auto x3 = x2.with_ptr(nullptr);
+  t.expect_eq(x3, nullptr);
+  t.expect_eq(x3.tag(), 1);
+};
+
+best::test Bits = [](auto& t) {
+  uint64_t x = 42;
+  best::tagged_ptr<uint64_t, 2> x0(&x, 2);
+  auto x1 = best::tagged_ptr<uint64_t, 2>::from_bits(x0.to_bits());
+  t.expect_eq(x0, x1);
+  t.expect_eq(x0.to_bits(), reinterpret_cast<uintptr_t>(&x) | 2);
+};
+
+best::test Atomic = [](auto& t) {
+  int x = 1, y = 2;
+  std::atomic<best::tagged_ptr<int>> p(best::tagged_ptr<int>(&x, 0));
+
+  auto old = p.load();
+  t.expect(p.compare_exchange_strong(old, old.with_tag(old.tag() + 1)));
+  t.expect_eq(p.load().tag(), 1);
+
+  old = p.load();
+  t.expect(p.compare_exchange_strong(old, {&y, old.tag() + 1}));
+  t.expect_eq(*p.load(), 2);
+  t.expect_eq(p.load().tag(), 2);
+};
+}  // namespace best::tagged_ptr_test
@@ -190,6 +190,27 @@ concept destructible =
                                    ? std::is_trivially_destructible_v<T>
                                    : std::is_destructible_v<T>)));
 
+/// # `best::zeroable`
+///
+/// Whether memory consisting entirely of zero bytes is a valid, initialized
+/// `T`. This allows arrays of `T` to be created by zeroing memory, such as with
+/// `best::allocator::zalloc()`.
+///
+/// This is approximated as "trivially default-constructible and trivially
+/// destructible object type", which holds for every scalar other than a
+/// pointer to member on the platforms we support. Pointers to members, and
+/// arrays of them, are excluded, since their null value is not zero under the
+/// Itanium ABI.
+///
+/// Pointers to members nested inside a class cannot be detected, so such a
+/// class is still considered zeroable, even though zeroing it does not produce
+/// null pointers to members.
+template <typename T>
+concept zeroable =
+  std::is_object_v<T> &&
+  !std::is_member_pointer_v<std::remove_all_extents_t<T>> &&
+  best::constructible<T, trivially> && best::destructible<T, trivially>;
+
 /// A callback that constructs a `T`.
 ///
 /// Currently only available for object types.
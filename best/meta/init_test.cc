@@ -319,6 +319,12 @@ static_assert(best::constructible<NonTrivialPod, best::args<NonTrivialPod>>);
 static_assert(
   best::constructible<NonTrivialPod, best::args<const NonTrivialPod>>);
 
+static_assert(best::zeroable<int>);
+static_assert(best::zeroable<int*[4]>);
+static_assert(!best::zeroable<int TrivialCopy::*>);
+static_assert(!best::zeroable<int TrivialCopy::*[4][2]>);
+static_assert(!best::zeroable<NonTrivialPod>);
+static_assert(!best::zeroable<int&>);
 }  // namespace best::init_test
 
 int main() {}
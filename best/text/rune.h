@@ -327,9 +327,13 @@ class rune final {
     query.uses_method = [](rune r) { return r == 'q'; };
   }
 
-  // best::rune has a niche representation.
-  constexpr explicit rune(niche) : value_(-1) {}
-  constexpr bool operator==(niche) const { return value_ == -1; }
+  // best::rune has many niche representations, since no value past the end of
+  // Unicode is a valid rune. We use the very top of the range.
+  static constexpr size_t BestNiches = 256;
+  constexpr explicit rune(niche nh) : value_(~uint32_t(nh.index)) {}
+  constexpr bool operator==(niche nh) const {
+    return value_ == ~uint32_t(nh.index);
+  }
 
  private:
   BEST_INLINE_ALWAYS constexpr bool in(uint32_t a, uint32_t b) const {